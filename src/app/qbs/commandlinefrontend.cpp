@@ -40,6 +40,7 @@
 
 #include "application.h"
 #include "consoleprogressobserver.h"
+#include "filewatcher.h"
 #include "status.h"
 #include "parser/commandlineoption.h"
 #include "../shared/logging/consolelogger.h"
@@ -71,6 +72,10 @@ CommandLineFrontend::CommandLineFrontend(const CommandLineParser &parser, Settin
     , m_observer(nullptr)
     , m_cancelStatus(CancelStatusNone)
     , m_cancelTimer(new QTimer(this))
+    , m_fileWatcher(nullptr)
+    , m_watchTimer(nullptr)
+    , m_resolveAfterChanges(false)
+    , m_watchCycleFailed(false)
 {
 }
 
@@ -93,8 +98,10 @@ void CommandLineFrontend::checkCancelStatus()
     case CancelStatusRequested:
         m_cancelStatus = CancelStatusCanceling;
         m_cancelTimer->stop();
-        if (m_resolveJobs.empty() && m_buildJobs.empty())
-            std::exit(EXIT_FAILURE);
+        if (m_resolveJobs.empty() && m_buildJobs.empty()) {
+            // Interrupting an idle watch loop is the regular way to end it.
+            std::exit(m_parser.watch() ? EXIT_SUCCESS : EXIT_FAILURE);
+        }
         for (AbstractJob * const job : qAsConst(m_resolveJobs))
             job->cancel();
         for (AbstractJob * const job : qAsConst(m_buildJobs))
@@ -147,6 +154,7 @@ void CommandLineFrontend::start()
         params.setForceProbeExecution(m_parser.forceProbesExecution());
         params.setWaitLockBuildGraph(m_parser.waitLockBuildGraph());
         params.setLogElapsedTime(m_parser.logTime());
+        params.setTraceFilePath(m_parser.traceFilePath());
         params.setSettingsDirectory(m_settings->baseDirectory());
         params.setOverrideBuildGraphData(m_parser.command() == ResolveCommandType);
         params.setPropertyCheckingMode(ErrorHandlingMode::Strict);
@@ -180,6 +188,8 @@ void CommandLineFrontend::start()
                     ConsoleLogger::instance().logSink(), this);
             connectJob(job);
             m_resolveJobs.push_back(job);
+            m_resolveJobIndexes.insert(job, m_setupParameters.size());
+            m_setupParameters.push_back(params);
         }
 
         /*
@@ -220,10 +230,26 @@ void CommandLineFrontend::handleJobFinished(bool success, AbstractJob *job)
 {
     try {
         job->deleteLater();
+        if (m_resolveJobIndexes.contains(job)) {
+            const int index = m_resolveJobIndexes.take(job);
+            if (success)
+                m_resolvedProjects.insert(index, qobject_cast<SetupProjectJob *>(job)->project());
+            else
+                m_resolvedProjects.remove(index);
+        }
         if (!success) {
             qbsError() << job->error().toString();
             m_resolveJobs.removeOne(job);
             m_buildJobs.removeOne(job);
+
+            // In watch mode, a failure just ends the current cycle, unless the user
+            // interrupted us.
+            if (m_parser.watch() && m_cancelStatus == CancelStatusNone) {
+                m_watchCycleFailed = true;
+                if (m_resolveJobs.empty() && m_buildJobs.empty())
+                    watchForChanges();
+                return;
+            }
             if (m_resolveJobs.empty() && m_buildJobs.empty()) {
                 qApp->exit(EXIT_FAILURE);
                 return;
@@ -234,8 +260,12 @@ void CommandLineFrontend::handleJobFinished(bool success, AbstractJob *job)
             m_projects.push_back(setupJob->project());
             if (m_observer && resolvingMultipleProjects())
                 m_observer->incrementProgressValue();
-            if (m_resolveJobs.empty())
-                handleProjectsResolved();
+            if (m_resolveJobs.empty()) {
+                if (m_watchCycleFailed)
+                    watchForChanges();
+                else
+                    handleProjectsResolved();
+            }
         } else if (qobject_cast<InstallJob *>(job)) {
             if (m_parser.command() == RunCommandType)
                 qApp->exit(runTarget());
@@ -254,7 +284,10 @@ void CommandLineFrontend::handleJobFinished(bool success, AbstractJob *job)
                     // fall through
                 case BuildCommandType:
                 case CleanCommandType:
-                    qApp->quit();
+                    if (m_parser.watch() && m_cancelStatus == CancelStatusNone)
+                        watchForChanges();
+                    else
+                        qApp->quit();
                     break;
                 default:
                     Q_ASSERT_X(false, Q_FUNC_INFO, "Missing case in switch statement");
@@ -307,20 +340,49 @@ void CommandLineFrontend::handleTaskProgress(int value, AbstractJob *job)
     }
 }
 
+static QString commandLine(const ProcessResult &result)
+{
+    return shellQuote(QDir::toNativeSeparators(result.executableFilePath()), result.arguments());
+}
+
 void CommandLineFrontend::handleProcessResultReport(const qbs::ProcessResult &result)
 {
+    const QString command = commandLine(result);
+    if (m_commandsWithPrintedOutput.remove(command)) {
+        // The output was printed while the command was running.
+        if (!result.success())
+            qbsError() << command;
+        return;
+    }
+
     bool hasOutput = !result.stdOut().empty() || !result.stdErr().empty();
     if (!hasOutput && result.success())
         return;
 
     LogWriter w = result.success() ? qbsInfo() : qbsError();
-    w << shellQuote(QDir::toNativeSeparators(result.executableFilePath()), result.arguments())
+    w << command
       << (hasOutput ? QString::fromLatin1("\n") : QString())
       << (result.stdOut().empty() ? QString() : result.stdOut().join(QLatin1Char('\n')));
     if (!result.stdErr().empty())
         w << result.stdErr().join(QLatin1Char('\n')) << MessageTag(QStringLiteral("stdErr"));
 }
 
+void CommandLineFrontend::handleProcessOutputReport(const ProcessResult &partialResult)
+{
+    const QString command = commandLine(partialResult);
+    LogWriter w = qbsInfo();
+    if (!m_commandsWithPrintedOutput.contains(command)) {
+        m_commandsWithPrintedOutput.insert(command);
+        w << command << QLatin1String("\n");
+    }
+    if (!partialResult.stdOut().empty())
+        w << partialResult.stdOut().join(QLatin1Char('\n'));
+    if (!partialResult.stdErr().empty()) {
+        w << partialResult.stdErr().join(QLatin1Char('\n'))
+          << MessageTag(QStringLiteral("stdErr"));
+    }
+}
+
 bool CommandLineFrontend::resolvingMultipleProjects() const
 {
     return isResolving() && m_resolveJobs.size() + m_projects.size() > 1;
@@ -406,6 +468,7 @@ void CommandLineFrontend::handleProjectsResolved()
         break;
     case HelpCommandType:
     case VersionCommandType:
+    case SessionCommandType:
         Q_ASSERT_X(false, Q_FUNC_INFO, "Impossible.");
     }
 }
@@ -454,9 +517,151 @@ BuildOptions CommandLineFrontend::buildOptions(const Project &project) const
         QBS_CHECK(!profileName.isEmpty());
         options.setMaxJobCount(Preferences(m_settings, profileName).jobs());
     }
+    if (!m_changedFilesForBuild.empty())
+        options.setChangedFiles(m_changedFilesForBuild);
     return options;
 }
 
+// Watches the directories of all source files, build system files and files that the
+// scanners found outside of the products, such as headers in include paths, as well as the
+// directories that wildcards were expanded in. Changes to known source files and file
+// dependencies are passed to the next build as changed files, so it does not need to look at
+// the timestamps of all the other source files. Changes to build system files and files
+// appearing in or disappearing from wildcard directories make us set up the projects again.
+// Everything else cannot affect the build and is ignored.
+void CommandLineFrontend::watchForChanges()
+{
+    m_watchCycleFailed = false;
+    if (!m_fileWatcher) {
+        m_fileWatcher = new FileWatcher(this);
+        connect(m_fileWatcher, &FileWatcher::filesChanged,
+                this, &CommandLineFrontend::handleFilesChanged);
+        connect(m_fileWatcher, &FileWatcher::eventsLost, this, [this] {
+            m_resolveAfterChanges = true;
+            if (!isResolving() && !isBuilding())
+                m_watchTimer->start();
+        });
+        m_watchTimer = new QTimer(this);
+        m_watchTimer->setSingleShot(true);
+        m_watchTimer->setInterval(200); // Let editors and version control tools finish writing.
+        connect(m_watchTimer, &QTimer::timeout, this, &CommandLineFrontend::rebuildAfterChanges);
+    }
+
+    QStringList filesToWatch;
+    QStringList dirsToWatch;
+    m_watchedSourceFiles.clear();
+    m_watchedBuildSystemFiles.clear();
+    m_watchedFileDependencies.clear();
+    m_watchedWildcardDirectories.clear();
+    for (const SetupProjectParameters &params : qAsConst(m_setupParameters))
+        m_watchedBuildSystemFiles.insert(params.projectFilePath());
+    for (const Project &project : qAsConst(m_projects)) {
+        for (const QString &filePath : project.buildSystemFiles())
+            m_watchedBuildSystemFiles.insert(filePath);
+        for (const QString &filePath : project.fileDependencies())
+            m_watchedFileDependencies.insert(filePath);
+        for (const QString &dirPath : project.wildcardDirectories())
+            m_watchedWildcardDirectories.insert(dirPath);
+        const auto products = project.projectData().allProducts();
+        for (const ProductData &product : products) {
+            const auto groups = product.groups();
+            for (const GroupData &group : groups) {
+                const auto filePaths = group.allFilePaths();
+                for (const QString &filePath : filePaths)
+                    m_watchedSourceFiles.insert(filePath);
+            }
+        }
+    }
+    for (const QString &filePath : qAsConst(m_watchedBuildSystemFiles))
+        filesToWatch << filePath;
+    for (const QString &filePath : qAsConst(m_watchedSourceFiles))
+        filesToWatch << filePath;
+    for (const QString &filePath : qAsConst(m_watchedFileDependencies))
+        filesToWatch << filePath;
+    for (const QString &dirPath : qAsConst(m_watchedWildcardDirectories))
+        dirsToWatch << dirPath;
+    m_fileWatcher->watch(filesToWatch, dirsToWatch);
+
+    qbsInfo() << Tr::tr("Watching for changes. Press Ctrl-C to stop.");
+    if (!m_changedFiles.empty() || m_resolveAfterChanges)
+        m_watchTimer->start();
+}
+
+void CommandLineFrontend::handleFilesChanged(const QStringList &modifiedFiles,
+                                             const QStringList &addedOrRemovedFiles)
+{
+    for (const QString &filePath : modifiedFiles) {
+        if (m_watchedBuildSystemFiles.contains(filePath))
+            m_resolveAfterChanges = true;
+        else if (m_watchedSourceFiles.contains(filePath)
+                 || m_watchedFileDependencies.contains(filePath))
+            m_changedFiles << filePath;
+    }
+    for (const QString &filePath : addedOrRemovedFiles) {
+        if (m_watchedBuildSystemFiles.contains(filePath)) {
+            m_resolveAfterChanges = true; // Replaced rather than modified in place.
+        } else if (m_watchedSourceFiles.contains(filePath)) {
+            // A replaced source file is just a changed one, a removed one needs
+            // the project to be set up again.
+            if (QFileInfo(filePath).isFile())
+                m_changedFiles << filePath;
+            else
+                m_resolveAfterChanges = true;
+        } else if (m_watchedFileDependencies.contains(filePath)) {
+            m_changedFiles << filePath; // The build checks all file dependencies anyway.
+        } else {
+            const QString fileName = QFileInfo(filePath).fileName();
+            if (fileName.startsWith(QLatin1Char('.')) || fileName.endsWith(QLatin1Char('~')))
+                continue; // Temporary and backup files of editors.
+
+            // Outside of Linux, we only get told which directory has changed.
+            if (m_watchedWildcardDirectories.contains(filePath)
+                    || m_watchedWildcardDirectories.contains(QFileInfo(filePath).path())) {
+                m_resolveAfterChanges = true;
+            }
+        }
+    }
+
+    // Changes that come in while we are busy are handled once we are done.
+    if ((!m_changedFiles.empty() || m_resolveAfterChanges) && !isResolving() && !isBuilding())
+        m_watchTimer->start();
+}
+
+void CommandLineFrontend::rebuildAfterChanges()
+{
+    try {
+        m_changedFiles.removeDuplicates();
+        if (m_resolveAfterChanges) {
+            m_resolveAfterChanges = false;
+            m_changedFiles.clear(); // After setting up the project, we check all timestamps.
+            resolveAgain();
+        } else if (!m_changedFiles.empty()) {
+            m_changedFilesForBuild = m_changedFiles;
+            m_changedFiles.clear();
+            build();
+            m_changedFilesForBuild.clear();
+        }
+    } catch (const ErrorInfo &error) {
+        m_changedFilesForBuild.clear();
+        qbsError() << error.toString();
+        watchForChanges();
+    }
+}
+
+// Passing the existing projects lets the setup jobs take over their build data,
+// so the build graphs do not get loaded from disk again.
+void CommandLineFrontend::resolveAgain()
+{
+    m_projects.clear();
+    for (int i = 0; i < m_setupParameters.size(); ++i) {
+        SetupProjectJob * const job = m_resolvedProjects.value(i).setupProject(
+                    m_setupParameters.at(i), ConsoleLogger::instance().logSink(), this);
+        connectJob(job);
+        m_resolveJobs.push_back(job);
+        m_resolveJobIndexes.insert(job, i);
+    }
+}
+
 QString CommandLineFrontend::buildDirectory(const QString &profileName) const
 {
     QString buildDir = m_parser.projectBuildDirectory();
@@ -599,6 +804,8 @@ void CommandLineFrontend::connectBuildJob(AbstractJob *job)
             this, &CommandLineFrontend::handleCommandDescriptionReport);
     connect(bjob, &BuildJob::reportProcessResult,
             this, &CommandLineFrontend::handleProcessResultReport);
+    connect(bjob, &BuildJob::reportProcessOutput,
+            this, &CommandLineFrontend::handleProcessOutputReport);
 }
 
 void CommandLineFrontend::connectJob(AbstractJob *job)
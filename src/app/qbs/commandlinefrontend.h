@@ -42,10 +42,12 @@
 #include "parser/commandlineparser.h"
 #include <api/project.h>
 #include <api/projectdata.h>
+#include <tools/setupprojectparameters.h>
 
 #include <QtCore/qhash.h>
 #include <QtCore/qlist.h>
 #include <QtCore/qobject.h>
+#include <QtCore/qset.h>
 
 #include <memory>
 
@@ -57,6 +59,7 @@ namespace qbs {
 class AbstractJob;
 class ConsoleProgressObserver;
 class ErrorInfo;
+class FileWatcher;
 class ProcessResult;
 class ProjectGenerator;
 class Settings;
@@ -79,6 +82,7 @@ private:
     void handleTotalEffortChanged(int totalEffort);
     void handleTaskProgress(int value, qbs::AbstractJob *job);
     void handleProcessResultReport(const qbs::ProcessResult &result);
+    void handleProcessOutputReport(const qbs::ProcessResult &partialResult);
     void checkCancelStatus();
 
     typedef QHash<Project, QList<ProductData> > ProductMap;
@@ -103,6 +107,11 @@ private:
     ProductData getTheOneRunnableProduct();
     void install();
     BuildOptions buildOptions(const Project &project) const;
+    void watchForChanges();
+    void handleFilesChanged(const QStringList &modifiedFiles,
+                            const QStringList &addedOrRemovedFiles);
+    void rebuildAfterChanges();
+    void resolveAgain();
     QString buildDirectory(const QString &profileName) const;
 
     const CommandLineParser &m_parser;
@@ -122,7 +131,23 @@ private:
     int m_totalBuildEffort;
     int m_currentBuildEffort;
     QHash<AbstractJob *, int> m_buildEfforts;
+    QSet<QString> m_commandsWithPrintedOutput;
     std::shared_ptr<ProjectGenerator> m_generator;
+
+    // For --watch.
+    QList<SetupProjectParameters> m_setupParameters;
+    QHash<AbstractJob *, int> m_resolveJobIndexes;
+    QHash<int, Project> m_resolvedProjects;
+    FileWatcher *m_fileWatcher;
+    QTimer *m_watchTimer;
+    QSet<QString> m_watchedSourceFiles;
+    QSet<QString> m_watchedBuildSystemFiles;
+    QSet<QString> m_watchedFileDependencies;
+    QSet<QString> m_watchedWildcardDirectories;
+    QStringList m_changedFiles;
+    QStringList m_changedFilesForBuild;
+    bool m_resolveAfterChanges;
+    bool m_watchCycleFailed;
 };
 
 } // namespace qbs
@@ -0,0 +1,197 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "filewatcher.h"
+
+#include "../shared/logging/consolelogger.h"
+
+#include <logging/translator.h>
+#include <tools/error.h>
+#include <tools/set.h>
+
+#include <QtCore/qfile.h>
+#include <QtCore/qfileinfo.h>
+
+#ifdef Q_OS_LINUX
+#include <QtCore/qsocketnotifier.h>
+
+#include <sys/inotify.h>
+
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+#else
+#include <QtCore/qfilesystemwatcher.h>
+#endif
+
+namespace qbs {
+using namespace Internal;
+
+static Set<QString> directories(const QStringList &filePaths, const QStringList &dirPaths)
+{
+    Set<QString> allDirPaths;
+    for (const QString &filePath : filePaths)
+        allDirPaths.insert(QFileInfo(filePath).absolutePath());
+    for (const QString &dirPath : dirPaths)
+        allDirPaths.insert(dirPath);
+    return allDirPaths;
+}
+
+#ifdef Q_OS_LINUX
+
+FileWatcher::FileWatcher(QObject *parent)
+    : QObject(parent), m_inotifyFd(inotify_init1(IN_NONBLOCK | IN_CLOEXEC)), m_notifier(nullptr)
+{
+    if (m_inotifyFd == -1) {
+        throw ErrorInfo(Tr::tr("Cannot watch for file changes: %1")
+                        .arg(QString::fromLocal8Bit(std::strerror(errno))));
+    }
+    m_notifier = new QSocketNotifier(m_inotifyFd, QSocketNotifier::Read, this);
+    connect(m_notifier, &QSocketNotifier::activated, this, &FileWatcher::readEvents);
+}
+
+FileWatcher::~FileWatcher()
+{
+    ::close(m_inotifyFd);
+}
+
+void FileWatcher::watch(const QStringList &filePaths, const QStringList &dirPaths)
+{
+    // Editors often save by writing a new file and renaming it over the old one,
+    // so watching the files themselves would lose track of them.
+    static const uint32_t mask = IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM
+            | IN_MOVED_TO | IN_ONLYDIR;
+    QHash<int, QString> newDirectories;
+    for (const QString &dirPath : directories(filePaths, dirPaths)) {
+        const int wd = inotify_add_watch(m_inotifyFd, QFile::encodeName(dirPath).constData(),
+                                         mask);
+        if (wd == -1) {
+            qbsWarning() << Tr::tr("Cannot watch directory '%1': %2")
+                            .arg(dirPath, QString::fromLocal8Bit(std::strerror(errno)));
+            continue;
+        }
+        newDirectories.insert(wd, dirPath);
+    }
+    for (auto it = m_directories.cbegin(); it != m_directories.cend(); ++it) {
+        if (!newDirectories.contains(it.key()))
+            inotify_rm_watch(m_inotifyFd, it.key());
+    }
+    m_directories = newDirectories;
+}
+
+void FileWatcher::readEvents()
+{
+    QStringList modifiedFiles;
+    QStringList addedOrRemovedFiles;
+    bool eventsWereLost = false;
+    alignas(inotify_event) char buffer[16 * 1024];
+    while (true) {
+        const ssize_t length = ::read(m_inotifyFd, buffer, sizeof buffer);
+        if (length <= 0)
+            break;
+        for (const char *p = buffer; p < buffer + length; ) {
+            const auto event = reinterpret_cast<const inotify_event *>(p);
+            p += sizeof(inotify_event) + event->len;
+            if (event->mask & IN_Q_OVERFLOW) {
+                eventsWereLost = true;
+                continue;
+            }
+            const QString dirPath = m_directories.value(event->wd);
+            if (dirPath.isEmpty())
+                continue;
+            if (event->mask & IN_IGNORED) { // The directory itself is gone.
+                m_directories.remove(event->wd);
+                addedOrRemovedFiles << dirPath;
+                continue;
+            }
+            // Sub-directories are reported as added or removed, as they matter for wildcards.
+            if (event->len == 0)
+                continue;
+            const QString filePath = dirPath + QLatin1Char('/')
+                    + QFile::decodeName(QByteArray(event->name));
+            if (event->mask & IN_CLOSE_WRITE)
+                modifiedFiles << filePath;
+            else
+                addedOrRemovedFiles << filePath;
+        }
+    }
+    if (eventsWereLost)
+        emit eventsLost();
+    else if (!modifiedFiles.empty() || !addedOrRemovedFiles.empty())
+        emit filesChanged(modifiedFiles, addedOrRemovedFiles);
+}
+
+#else // Q_OS_LINUX
+
+FileWatcher::FileWatcher(QObject *parent)
+    : QObject(parent), m_watcher(new QFileSystemWatcher(this))
+{
+    connect(m_watcher, &QFileSystemWatcher::fileChanged, this, [this](const QString &filePath) {
+        if (QFileInfo(filePath).exists()) {
+            // Replaced files drop out of the watch list.
+            m_watcher->addPath(filePath);
+            emit filesChanged(QStringList(filePath), QStringList());
+        } else {
+            emit filesChanged(QStringList(), QStringList(filePath));
+        }
+    });
+    connect(m_watcher, &QFileSystemWatcher::directoryChanged, this, [this](const QString &path) {
+        emit filesChanged(QStringList(), QStringList(path));
+    });
+}
+
+FileWatcher::~FileWatcher()
+{
+}
+
+void FileWatcher::watch(const QStringList &filePaths, const QStringList &dirPaths)
+{
+    const QStringList oldPaths = m_watcher->files() + m_watcher->directories();
+    if (!oldPaths.empty())
+        m_watcher->removePaths(oldPaths);
+    QStringList newPaths = filePaths;
+    for (const QString &dirPath : directories(filePaths, dirPaths))
+        newPaths << dirPath;
+    newPaths.removeDuplicates();
+    m_watcher->addPaths(newPaths);
+}
+
+#endif // Q_OS_LINUX
+
+} // namespace qbs
@@ -0,0 +1,90 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QBS_FILEWATCHER_H
+#define QBS_FILEWATCHER_H
+
+#include <QtCore/qhash.h>
+#include <QtCore/qobject.h>
+#include <QtCore/qstringlist.h>
+
+QT_BEGIN_NAMESPACE
+class QFileSystemWatcher;
+class QSocketNotifier;
+QT_END_NAMESPACE
+
+namespace qbs {
+
+// Reports changes to files in the directories of the watched files and in the additionally
+// watched directories.
+// On Linux, inotify watches are put on the directories, so that the names of the affected
+// files are known without having to look at the file system. Elsewhere, a QFileSystemWatcher
+// watches the files themselves; additions and removals are then only reported by
+// directory path.
+class FileWatcher : public QObject
+{
+    Q_OBJECT
+public:
+    explicit FileWatcher(QObject *parent = nullptr);
+    ~FileWatcher();
+
+    // Replaces the set of watched files and directories.
+    void watch(const QStringList &filePaths, const QStringList &dirPaths);
+
+signals:
+    void filesChanged(const QStringList &modifiedFiles, const QStringList &addedOrRemovedFiles);
+
+    // Changes got lost, so the receiver needs to assume that anything has changed.
+    void eventsLost();
+
+private:
+#ifdef Q_OS_LINUX
+    void readEvents();
+
+    const int m_inotifyFd;
+    QSocketNotifier *m_notifier;
+    QHash<int, QString> m_directories;
+#else
+    QFileSystemWatcher * const m_watcher;
+#endif
+};
+
+} // namespace qbs
+
+#endif // QBS_FILEWATCHER_H
@@ -40,6 +40,7 @@
 #include "application.h"
 #include "commandlinefrontend.h"
 #include "qbstool.h"
+#include "session.h"
 #include "parser/commandlineparser.h"
 #include "../shared/logging/consolelogger.h"
 
@@ -84,6 +85,12 @@ int main(int argc, char *argv[])
         }
 
         Settings settings(parser.settingsDir());
+        if (parser.command() == SessionCommandType) {
+            Session session(&settings);
+            QTimer::singleShot(0, &session, &Session::start);
+            return app.exec();
+        }
+
         ConsoleLogger::instance().setSettings(&settings);
         CommandLineFrontend clFrontend(parser, &settings);
         app.setCommandLineFrontend(&clFrontend);
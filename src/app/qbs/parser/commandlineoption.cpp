@@ -44,6 +44,8 @@
 #include <tools/installoptions.h>
 #include <tools/qttools.h>
 
+#include <QtCore/qdir.h>
+
 namespace qbs {
 using namespace Internal;
 
@@ -239,6 +241,115 @@ void JobsOption::doParse(const QString &representation, QStringList &input)
                     .arg(representation, jobCountString, description(command())));
 }
 
+QString JobLimitsOption::description(CommandType command) const
+{
+    Q_UNUSED(command);
+    return Tr::tr("%1 <pool1>:<n1>[,<pool2>:<n2>...]\n"
+            "\tRun at most <n> commands of the given job pool concurrently.\n"
+            "\tCommands are assigned to a pool via their \"jobPool\" property.\n"
+            "\t<n> must be an integer greater than zero.\n")
+            .arg(longRepresentation());
+}
+
+QString JobLimitsOption::longRepresentation() const
+{
+    return QLatin1String("--job-limits");
+}
+
+void JobLimitsOption::doParse(const QString &representation, QStringList &input)
+{
+    const QString jobLimitsString = getArgument(representation, input);
+    const QStringList jobLimitStrings = jobLimitsString.split(QLatin1Char(','));
+    for (const QString &jobLimitString : jobLimitStrings) {
+        const int sepIndex = jobLimitString.lastIndexOf(QLatin1Char(':'));
+        const QString pool = jobLimitString.left(sepIndex);
+        bool stringOk = false;
+        const int limit = sepIndex > 0 ? jobLimitString.mid(sepIndex + 1).toInt(&stringOk) : 0;
+        if (!stringOk || limit <= 0) {
+            throw ErrorInfo(Tr::tr("Invalid use of option '%1': Illegal job limit '%2'.\n"
+                                   "Usage: %3")
+                        .arg(representation, jobLimitString, description(command())));
+        }
+        m_jobLimits.insert(pool, limit);
+    }
+}
+
+QString MaxLoadOption::description(CommandType command) const
+{
+    Q_UNUSED(command);
+    return Tr::tr("%1 <load>\n"
+            "\tDo not start new jobs while the system load average is above <load>.\n"
+            "\t<load> must be a number greater than zero.\n")
+            .arg(longRepresentation());
+}
+
+QString MaxLoadOption::longRepresentation() const
+{
+    return QLatin1String("--max-load");
+}
+
+void MaxLoadOption::doParse(const QString &representation, QStringList &input)
+{
+    const QString maxLoadString = getArgument(representation, input);
+    bool stringOk;
+    m_maxLoad = maxLoadString.toDouble(&stringOk);
+    if (!stringOk || m_maxLoad <= 0)
+        throw ErrorInfo(Tr::tr("Invalid use of option '%1': Illegal load '%2'.\n"
+                               "Usage: %3")
+                    .arg(representation, maxLoadString, description(command())));
+}
+
+QString MinFreeMemoryOption::description(CommandType command) const
+{
+    Q_UNUSED(command);
+    return Tr::tr("%1 <n>\n"
+            "\tDo not start new jobs while less than <n> MiB of memory are available.\n"
+            "\t<n> must be an integer greater than zero.\n")
+            .arg(longRepresentation());
+}
+
+QString MinFreeMemoryOption::longRepresentation() const
+{
+    return QLatin1String("--min-free-memory");
+}
+
+void MinFreeMemoryOption::doParse(const QString &representation, QStringList &input)
+{
+    const QString minFreeMemoryString = getArgument(representation, input);
+    bool stringOk;
+    m_minFreeMemory = minFreeMemoryString.toInt(&stringOk);
+    if (!stringOk || m_minFreeMemory <= 0)
+        throw ErrorInfo(Tr::tr("Invalid use of option '%1': Illegal memory size '%2'.\n"
+                               "Usage: %3")
+                    .arg(representation, minFreeMemoryString, description(command())));
+}
+
+QString ProcessLaunchersOption::description(CommandType command) const
+{
+    Q_UNUSED(command);
+    return Tr::tr("%1 <n>\n"
+            "\tRun build commands via <n> process launchers. <n> must be an integer\n"
+            "\tgreater than zero.\n"
+            "\tThe default is one launcher per 32 concurrent build jobs.\n")
+            .arg(longRepresentation());
+}
+
+QString ProcessLaunchersOption::longRepresentation() const
+{
+    return QLatin1String("--process-launchers");
+}
+
+void ProcessLaunchersOption::doParse(const QString &representation, QStringList &input)
+{
+    const QString launcherCountString = getArgument(representation, input);
+    bool stringOk;
+    m_launcherCount = launcherCountString.toInt(&stringOk);
+    if (!stringOk || m_launcherCount <= 0)
+        throw ErrorInfo(Tr::tr("Invalid use of option '%1': Illegal launcher count '%2'.\n"
+                               "Usage: %3")
+                    .arg(representation, launcherCountString, description(command())));
+}
+
 QString KeepGoingOption::description(CommandType command) const
 {
     Q_UNUSED(command);
@@ -449,6 +560,73 @@ QString ForceOutputCheckOption::longRepresentation() const
     return QLatin1String("--check-outputs");
 }
 
+QString DetectUnchangedOutputsOption::description(CommandType command) const
+{
+    Q_UNUSED(command);
+    return Tr::tr("%1\n\tDetect re-generated artifacts with unchanged contents.\n"
+                  "\tArtifacts depending on them are then not rebuilt. This requires\n"
+                  "\thashing the contents of all generated artifacts.\n")
+            .arg(longRepresentation());
+}
+
+QString DetectUnchangedOutputsOption::longRepresentation() const
+{
+    return QLatin1String("--detect-unchanged-outputs");
+}
+
+QString JobServerOption::description(CommandType command) const
+{
+    Q_UNUSED(command);
+    return Tr::tr("%1\n\tAct as a GNU make jobserver for the commands that are run.\n"
+                  "\tInstances of make (4.4 or later) started by commands then share\n"
+                  "\tthe job slots with qbs.\n")
+            .arg(longRepresentation());
+}
+
+QString JobServerOption::longRepresentation() const
+{
+    return QLatin1String("--jobserver");
+}
+
+QString WatchOption::description(CommandType command) const
+{
+    Q_UNUSED(command);
+    return Tr::tr("%1\n\tAfter building, keep running and build again whenever source files\n"
+                  "\tor project files change.\n")
+            .arg(longRepresentation());
+}
+
+QString WatchOption::longRepresentation() const
+{
+    return QLatin1String("--watch");
+}
+
+QString ActionCacheOption::description(CommandType command) const
+{
+    Q_UNUSED(command);
+    return Tr::tr("%1 <directory>\n"
+                  "\tCache the outputs of commands in the given directory.\n"
+                  "\tCommands that were already run with the same command line and\n"
+                  "\tinput files, possibly in a different build directory, are not run\n"
+                  "\tagain. Instead, their outputs are copied from the cache.\n")
+            .arg(longRepresentation());
+}
+
+QString ActionCacheOption::longRepresentation() const
+{
+    return QLatin1String("--action-cache");
+}
+
+void ActionCacheOption::doParse(const QString &representation, QStringList &input)
+{
+    if (input.empty()) {
+        throw ErrorInfo(Tr::tr("Invalid use of option '%1: Argument expected.\n"
+                           "Usage: %2").arg(representation, description(command())));
+    }
+    m_cacheDirectory = QDir::current().absoluteFilePath(
+                QDir::fromNativeSeparators(input.takeFirst()));
+}
+
 QString BuildNonDefaultOption::description(CommandType command) const
 {
     Q_UNUSED(command);
@@ -545,6 +723,31 @@ QString LogTimeOption::longRepresentation() const
     return logTimeRepresentation();
 }
 
+QString TraceFileOption::description(CommandType command) const
+{
+    Q_UNUSED(command);
+    return Tr::tr("%1 <file>\n"
+                  "\tWrite a timeline of the operation to the given file.\n"
+                  "\tThe file is in the Chrome trace event format and can be viewed\n"
+                  "\twith chrome://tracing or Perfetto.\n")
+            .arg(longRepresentation());
+}
+
+QString TraceFileOption::longRepresentation() const
+{
+    return QLatin1String("--trace-file");
+}
+
+void TraceFileOption::doParse(const QString &representation, QStringList &input)
+{
+    if (input.empty()) {
+        throw ErrorInfo(Tr::tr("Invalid use of option '%1: Argument expected.\n"
+                           "Usage: %2").arg(representation, description(command())));
+    }
+    m_traceFilePath = QDir::current().absoluteFilePath(
+                QDir::fromNativeSeparators(input.takeFirst()));
+}
+
 
 SettingsDirOption::SettingsDirOption()
 {
@@ -43,6 +43,7 @@
 
 #include <tools/commandechomode.h>
 
+#include <QtCore/qhash.h>
 #include <QtCore/qstringlist.h>
 
 namespace qbs {
@@ -55,6 +56,10 @@ public:
         BuildDirectoryOptionType,
         LogLevelOptionType, VerboseOptionType, QuietOptionType,
         JobsOptionType,
+        ProcessLaunchersOptionType,
+        JobLimitsOptionType,
+        MaxLoadOptionType,
+        MinFreeMemoryOptionType,
         KeepGoingOptionType,
         DryRunOptionType,
         ForceProbesOptionType,
@@ -65,13 +70,18 @@ public:
         InstallRootOptionType, RemoveFirstOptionType, NoBuildOptionType,
         ForceTimestampCheckOptionType,
         ForceOutputCheckOptionType,
+        DetectUnchangedOutputsOptionType,
+        ActionCacheOptionType,
+        JobServerOptionType,
         BuildNonDefaultOptionType,
         LogTimeOptionType,
+        TraceFileOptionType,
         CommandEchoModeOptionType,
         SettingsDirOptionType,
         GeneratorOptionType,
         WaitLockOptionType,
         RunEnvConfigOptionType,
+        WatchOptionType,
     };
 
     virtual ~CommandLineOption();
@@ -184,6 +194,65 @@ private:
     int m_jobCount;
 };
 
+class ProcessLaunchersOption : public CommandLineOption
+{
+public:
+    ProcessLaunchersOption() : m_launcherCount(0) {}
+    int launcherCount() const { return m_launcherCount; }
+
+private:
+    QString description(CommandType command) const override;
+    QString shortRepresentation() const override { return QString(); }
+    QString longRepresentation() const override;
+    void doParse(const QString &representation, QStringList &input) override;
+
+    int m_launcherCount;
+};
+
+class JobLimitsOption : public CommandLineOption
+{
+public:
+    QHash<QString, int> jobLimits() const { return m_jobLimits; }
+
+private:
+    QString description(CommandType command) const override;
+    QString shortRepresentation() const override { return QString(); }
+    QString longRepresentation() const override;
+    void doParse(const QString &representation, QStringList &input) override;
+
+    QHash<QString, int> m_jobLimits;
+};
+
+class MaxLoadOption : public CommandLineOption
+{
+public:
+    MaxLoadOption() : m_maxLoad(0) {}
+    double maxLoad() const { return m_maxLoad; }
+
+private:
+    QString description(CommandType command) const override;
+    QString shortRepresentation() const override { return QString(); }
+    QString longRepresentation() const override;
+    void doParse(const QString &representation, QStringList &input) override;
+
+    double m_maxLoad;
+};
+
+class MinFreeMemoryOption : public CommandLineOption
+{
+public:
+    MinFreeMemoryOption() : m_minFreeMemory(0) {}
+    int minFreeMemory() const { return m_minFreeMemory; }
+
+private:
+    QString description(CommandType command) const override;
+    QString shortRepresentation() const override { return QString(); }
+    QString longRepresentation() const override;
+    void doParse(const QString &representation, QStringList &input) override;
+
+    int m_minFreeMemory;
+};
+
 class OnOffOption : public CommandLineOption
 {
 public:
@@ -248,6 +317,42 @@ class ForceOutputCheckOption : public OnOffOption
     QString longRepresentation() const override;
 };
 
+class DetectUnchangedOutputsOption : public OnOffOption
+{
+    QString description(CommandType command) const override;
+    QString shortRepresentation() const override { return QString(); }
+    QString longRepresentation() const override;
+};
+
+class JobServerOption : public OnOffOption
+{
+    QString description(CommandType command) const override;
+    QString shortRepresentation() const override { return QString(); }
+    QString longRepresentation() const override;
+};
+
+class WatchOption : public OnOffOption
+{
+    QString description(CommandType command) const override;
+    QString shortRepresentation() const override { return QString(); }
+    QString longRepresentation() const override;
+};
+
+class ActionCacheOption : public CommandLineOption
+{
+public:
+    QString cacheDirectory() const { return m_cacheDirectory; }
+
+    QString description(CommandType command) const override;
+    QString shortRepresentation() const override { return QString(); }
+    QString longRepresentation() const override;
+
+private:
+    void doParse(const QString &representation, QStringList &input) override;
+
+    QString m_cacheDirectory;
+};
+
 class BuildNonDefaultOption : public OnOffOption
 {
     QString description(CommandType command) const override;
@@ -347,6 +452,21 @@ public:
     QString longRepresentation() const override;
 };
 
+class TraceFileOption : public CommandLineOption
+{
+public:
+    QString traceFilePath() const { return m_traceFilePath; }
+
+    QString description(CommandType command) const override;
+    QString shortRepresentation() const override { return QString(); }
+    QString longRepresentation() const override;
+
+private:
+    void doParse(const QString &representation, QStringList &input) override;
+
+    QString m_traceFilePath;
+};
+
 class CommandEchoModeOption : public CommandLineOption
 {
 public:
@@ -68,6 +68,18 @@ CommandLineOption *CommandLineOptionPool::getOption(CommandLineOption::Type type
         case CommandLineOption::JobsOptionType:
             option = new JobsOption;
             break;
+        case CommandLineOption::ProcessLaunchersOptionType:
+            option = new ProcessLaunchersOption;
+            break;
+        case CommandLineOption::JobLimitsOptionType:
+            option = new JobLimitsOption;
+            break;
+        case CommandLineOption::MaxLoadOptionType:
+            option = new MaxLoadOption;
+            break;
+        case CommandLineOption::MinFreeMemoryOptionType:
+            option = new MinFreeMemoryOption;
+            break;
         case CommandLineOption::KeepGoingOptionType:
             option = new KeepGoingOption;
             break;
@@ -104,12 +116,24 @@ CommandLineOption *CommandLineOptionPool::getOption(CommandLineOption::Type type
         case CommandLineOption::ForceOutputCheckOptionType:
             option = new ForceOutputCheckOption;
             break;
+        case CommandLineOption::DetectUnchangedOutputsOptionType:
+            option = new DetectUnchangedOutputsOption;
+            break;
+        case CommandLineOption::JobServerOptionType:
+            option = new JobServerOption;
+            break;
+        case CommandLineOption::ActionCacheOptionType:
+            option = new ActionCacheOption;
+            break;
         case CommandLineOption::BuildNonDefaultOptionType:
             option = new BuildNonDefaultOption;
             break;
         case CommandLineOption::LogTimeOptionType:
             option = new LogTimeOption;
             break;
+        case CommandLineOption::TraceFileOptionType:
+            option = new TraceFileOption;
+            break;
         case CommandLineOption::CommandEchoModeOptionType:
             option = new CommandEchoModeOption;
             break;
@@ -125,6 +149,9 @@ CommandLineOption *CommandLineOptionPool::getOption(CommandLineOption::Type type
         case CommandLineOption::RunEnvConfigOptionType:
             option = new RunEnvConfigOption;
             break;
+        case CommandLineOption::WatchOptionType:
+            option = new WatchOption;
+            break;
         default:
             qFatal("Unknown option type %d", type);
         }
@@ -177,6 +204,28 @@ ChangedFilesOption *CommandLineOptionPool::changedFilesOption() const
     return static_cast<ChangedFilesOption *>(getOption(CommandLineOption::ChangedFilesOptionType));
 }
 
+ProcessLaunchersOption *CommandLineOptionPool::processLaunchersOption() const
+{
+    return static_cast<ProcessLaunchersOption *>(
+                getOption(CommandLineOption::ProcessLaunchersOptionType));
+}
+
+JobLimitsOption *CommandLineOptionPool::jobLimitsOption() const
+{
+    return static_cast<JobLimitsOption *>(getOption(CommandLineOption::JobLimitsOptionType));
+}
+
+MaxLoadOption *CommandLineOptionPool::maxLoadOption() const
+{
+    return static_cast<MaxLoadOption *>(getOption(CommandLineOption::MaxLoadOptionType));
+}
+
+MinFreeMemoryOption *CommandLineOptionPool::minFreeMemoryOption() const
+{
+    return static_cast<MinFreeMemoryOption *>(
+                getOption(CommandLineOption::MinFreeMemoryOptionType));
+}
+
 KeepGoingOption *CommandLineOptionPool::keepGoingOption() const
 {
     return static_cast<KeepGoingOption *>(getOption(CommandLineOption::KeepGoingOptionType));
@@ -224,6 +273,22 @@ ForceOutputCheckOption *CommandLineOptionPool::forceOutputCheckOption() const
                 getOption(CommandLineOption::ForceOutputCheckOptionType));
 }
 
+DetectUnchangedOutputsOption *CommandLineOptionPool::detectUnchangedOutputsOption() const
+{
+    return static_cast<DetectUnchangedOutputsOption *>(
+                getOption(CommandLineOption::DetectUnchangedOutputsOptionType));
+}
+
+JobServerOption *CommandLineOptionPool::jobServerOption() const
+{
+    return static_cast<JobServerOption *>(getOption(CommandLineOption::JobServerOptionType));
+}
+
+ActionCacheOption *CommandLineOptionPool::actionCacheOption() const
+{
+    return static_cast<ActionCacheOption *>(getOption(CommandLineOption::ActionCacheOptionType));
+}
+
 BuildNonDefaultOption *CommandLineOptionPool::buildNonDefaultOption() const
 {
     return static_cast<BuildNonDefaultOption *>(
@@ -235,6 +300,11 @@ LogTimeOption *CommandLineOptionPool::logTimeOption() const
     return static_cast<LogTimeOption *>(getOption(CommandLineOption::LogTimeOptionType));
 }
 
+TraceFileOption *CommandLineOptionPool::traceFileOption() const
+{
+    return static_cast<TraceFileOption *>(getOption(CommandLineOption::TraceFileOptionType));
+}
+
 CommandEchoModeOption *CommandLineOptionPool::commandEchoModeOption() const
 {
     return static_cast<CommandEchoModeOption *>(
@@ -261,4 +331,9 @@ RunEnvConfigOption *CommandLineOptionPool::runEnvConfigOption() const
     return static_cast<RunEnvConfigOption *>(getOption(CommandLineOption::RunEnvConfigOptionType));
 }
 
+WatchOption *CommandLineOptionPool::watchOption() const
+{
+    return static_cast<WatchOption *>(getOption(CommandLineOption::WatchOptionType));
+}
+
 } // namespace qbs
@@ -62,6 +62,10 @@ public:
     ChangedFilesOption *changedFilesOption() const;
     KeepGoingOption *keepGoingOption() const;
     JobsOption *jobsOption() const;
+    ProcessLaunchersOption *processLaunchersOption() const;
+    JobLimitsOption *jobLimitsOption() const;
+    MaxLoadOption *maxLoadOption() const;
+    MinFreeMemoryOption *minFreeMemoryOption() const;
     ProductsOption *productsOption() const;
     NoInstallOption *noInstallOption() const;
     InstallRootOption *installRootOption() const;
@@ -69,13 +73,18 @@ public:
     NoBuildOption *noBuildOption() const;
     ForceTimeStampCheckOption *forceTimestampCheckOption() const;
     ForceOutputCheckOption *forceOutputCheckOption() const;
+    DetectUnchangedOutputsOption *detectUnchangedOutputsOption() const;
+    JobServerOption *jobServerOption() const;
+    ActionCacheOption *actionCacheOption() const;
     BuildNonDefaultOption *buildNonDefaultOption() const;
     LogTimeOption *logTimeOption() const;
+    TraceFileOption *traceFileOption() const;
     CommandEchoModeOption *commandEchoModeOption() const;
     SettingsDirOption *settingsDirOption() const;
     GeneratorOption *generatorOption() const;
     WaitLockOption *waitLockOption() const;
     RunEnvConfigOption *runEnvConfigOption() const;
+    WatchOption *watchOption() const;
 
 private:
     mutable QHash<CommandLineOption::Type, CommandLineOption *> m_options;
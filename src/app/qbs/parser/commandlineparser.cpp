@@ -231,11 +231,21 @@ bool CommandLineParser::waitLockBuildGraph() const
     return d->optionPool.waitLockOption()->enabled();
 }
 
+bool CommandLineParser::watch() const
+{
+    return d->command->type() == BuildCommandType && d->optionPool.watchOption()->enabled();
+}
+
 bool CommandLineParser::logTime() const
 {
     return d->logTime;
 }
 
+QString CommandLineParser::traceFilePath() const
+{
+    return d->optionPool.traceFileOption()->traceFilePath();
+}
+
 bool CommandLineParser::withNonDefaultProducts() const
 {
     return d->withNonDefaultProducts();
@@ -346,8 +356,10 @@ void CommandLineParser::CommandLineParserPrivate::doParse()
     }
     command->parse(commandLine);
 
-    if (command->type() == HelpCommandType || command->type() == VersionCommandType)
+    if (command->type() == HelpCommandType || command->type() == VersionCommandType
+            || command->type() == SessionCommandType) {
         return;
+    }
 
     setupBuildDirectory();
     setupBuildConfigurations();
@@ -381,6 +393,7 @@ QList<Command *> CommandLineParser::CommandLineParserPrivate::allCommands() cons
             << commandPool.getCommand(InstallCommandType)
             << commandPool.getCommand(DumpNodesTreeCommandType)
             << commandPool.getCommand(ListProductsCommandType)
+            << commandPool.getCommand(SessionCommandType)
             << commandPool.getCommand(VersionCommandType)
             << commandPool.getCommand(HelpCommandType);
 }
@@ -456,9 +469,18 @@ void CommandLineParser::CommandLineParserPrivate::setupBuildOptions()
     buildOptions.setKeepGoing(optionPool.keepGoingOption()->enabled());
     buildOptions.setForceTimestampCheck(optionPool.forceTimestampCheckOption()->enabled());
     buildOptions.setForceOutputCheck(optionPool.forceOutputCheckOption()->enabled());
+    buildOptions.setDetectUnchangedOutputs(
+                optionPool.detectUnchangedOutputsOption()->enabled());
+    buildOptions.setActionCacheDirectory(optionPool.actionCacheOption()->cacheDirectory());
     const JobsOption * jobsOption = optionPool.jobsOption();
     buildOptions.setMaxJobCount(jobsOption->jobCount());
+    buildOptions.setJobLimits(optionPool.jobLimitsOption()->jobLimits());
+    buildOptions.setMaxLoad(optionPool.maxLoadOption()->maxLoad());
+    buildOptions.setMinFreeMemory(optionPool.minFreeMemoryOption()->minFreeMemory());
+    buildOptions.setProvideJobServer(optionPool.jobServerOption()->enabled());
+    buildOptions.setProcessLauncherCount(optionPool.processLaunchersOption()->launcherCount());
     buildOptions.setLogElapsedTime(logTime);
+    buildOptions.setTraceFilePath(optionPool.traceFileOption()->traceFilePath());
     buildOptions.setEchoMode(echoMode());
     buildOptions.setInstall(!optionPool.noInstallOption()->enabled());
     buildOptions.setRemoveExistingInstallation(optionPool.removeFirstoption()->enabled());
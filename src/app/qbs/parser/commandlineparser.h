@@ -76,7 +76,9 @@ public:
     bool dryRun() const;
     bool forceProbesExecution() const;
     bool waitLockBuildGraph() const;
+    bool watch() const;
     bool logTime() const;
+    QString traceFilePath() const;
     bool withNonDefaultProducts() const;
     bool buildBeforeInstalling() const;
     QStringList runArgs() const;
@@ -212,7 +212,8 @@ static QList<CommandLineOption::Type> resolveOptions()
             << CommandLineOption::ShowProgressOptionType
             << CommandLineOption::DryRunOptionType
             << CommandLineOption::ForceProbesOptionType
-            << CommandLineOption::LogTimeOptionType;
+            << CommandLineOption::LogTimeOptionType
+            << CommandLineOption::TraceFileOptionType;
 }
 
 QList<CommandLineOption::Type> ResolveCommand::supportedOptions() const
@@ -282,8 +283,15 @@ static QList<CommandLineOption::Type> buildOptions()
             << CommandLineOption::ChangedFilesOptionType
             << CommandLineOption::ForceTimestampCheckOptionType
             << CommandLineOption::ForceOutputCheckOptionType
+            << CommandLineOption::DetectUnchangedOutputsOptionType
+            << CommandLineOption::ActionCacheOptionType
+            << CommandLineOption::JobServerOptionType
             << CommandLineOption::BuildNonDefaultOptionType
             << CommandLineOption::JobsOptionType
+            << CommandLineOption::ProcessLaunchersOptionType
+            << CommandLineOption::JobLimitsOptionType
+            << CommandLineOption::MaxLoadOptionType
+            << CommandLineOption::MinFreeMemoryOptionType
             << CommandLineOption::CommandEchoModeOptionType
             << CommandLineOption::NoInstallOptionType
             << CommandLineOption::RemoveFirstOptionType
@@ -292,7 +300,7 @@ static QList<CommandLineOption::Type> buildOptions()
 
 QList<CommandLineOption::Type> BuildCommand::supportedOptions() const
 {
-    return buildOptions();
+    return buildOptions() << CommandLineOption::WatchOptionType;
 }
 
 QString CleanCommand::shortDescription() const
@@ -541,6 +549,38 @@ QList<CommandLineOption::Type> ListProductsCommand::supportedOptions() const
             << CommandLineOption::BuildDirectoryOptionType;
 }
 
+QString SessionCommand::shortDescription() const
+{
+    return Tr::tr("Keep projects in memory and build them on request (for use by IDEs).");
+}
+
+QString SessionCommand::longDescription() const
+{
+    QString description = Tr::tr("qbs %1 [options]\n").arg(representation());
+    description += Tr::tr("Reads requests from stdin and writes replies to stdout, one JSON "
+                          "object per line.\nThe project stays loaded between requests, "
+                          "so that repeated builds do not need to restore the build graph.\n");
+    return description += supportedOptionsDescription();
+}
+
+QString SessionCommand::representation() const
+{
+    return QLatin1String("session");
+}
+
+QList<CommandLineOption::Type> SessionCommand::supportedOptions() const
+{
+    return QList<CommandLineOption::Type>();
+}
+
+void SessionCommand::parseNext(QStringList &input)
+{
+    QBS_CHECK(!input.empty());
+    if (!input.front().startsWith(QLatin1Char('-')))
+        throwError(Tr::tr("This command takes no arguments."));
+    parseOption(input);
+}
+
 QString HelpCommand::shortDescription() const
 {
     return Tr::tr("Show general or command-specific help.");
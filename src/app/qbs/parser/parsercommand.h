@@ -230,6 +230,20 @@ private:
     QList<CommandLineOption::Type> supportedOptions() const override;
 };
 
+class SessionCommand : public Command
+{
+public:
+    SessionCommand(CommandLineOptionPool &optionPool) : Command(optionPool) {}
+
+private:
+    CommandType type() const override { return SessionCommandType; }
+    QString shortDescription() const override;
+    QString longDescription() const override;
+    QString representation() const override;
+    QList<CommandLineOption::Type> supportedOptions() const override;
+    void parseNext(QStringList &input) override;
+};
+
 class HelpCommand : public Command
 {
 public:
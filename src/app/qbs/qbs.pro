@@ -9,7 +9,9 @@ SOURCES += main.cpp \
     status.cpp \
     consoleprogressobserver.cpp \
     commandlinefrontend.cpp \
-    qbstool.cpp
+    filewatcher.cpp \
+    qbstool.cpp \
+    session.cpp
 
 HEADERS += \
     ctrlchandler.h \
@@ -17,7 +19,9 @@ HEADERS += \
     status.h \
     consoleprogressobserver.h \
     commandlinefrontend.h \
-    qbstool.h
+    filewatcher.h \
+    qbstool.h \
+    session.h
 
 include(../../library_dirname.pri)
 isEmpty(QBS_RELATIVE_LIBEXEC_PATH) {
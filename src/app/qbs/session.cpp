@@ -0,0 +1,510 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "session.h"
+
+#include <qbs.h>
+#include <logging/translator.h>
+
+#include <QtCore/qcoreapplication.h>
+#include <QtCore/qdir.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qjsonarray.h>
+#include <QtCore/qjsondocument.h>
+#include <QtCore/qprocess.h>
+
+#include <cstdio>
+#include <mutex>
+#include <thread>
+
+namespace qbs {
+using namespace Internal;
+
+static int protocolVersion() { return 1; }
+
+// There is no portable way to get notified about data arriving on stdin, so we read it
+// in a blocking manner on a detached thread. That thread may outlive the session object,
+// hence the guarded pointer.
+static std::mutex inputReceiverMutex;
+static Session *inputReceiver = nullptr;
+
+static void forwardInput(const char *method, const QByteArray &line = QByteArray())
+{
+    std::lock_guard<std::mutex> lock(inputReceiverMutex);
+    if (!inputReceiver)
+        return;
+    if (line.isNull())
+        QMetaObject::invokeMethod(inputReceiver, method, Qt::QueuedConnection);
+    else
+        QMetaObject::invokeMethod(inputReceiver, method, Qt::QueuedConnection,
+                                  Q_ARG(QByteArray, line));
+}
+
+static void readInput()
+{
+    QFile input;
+    if (input.open(stdin, QIODevice::ReadOnly)) {
+        while (true) {
+            const QByteArray line = input.readLine();
+            if (line.isEmpty())
+                break;
+            forwardInput("handleInputLine", line);
+        }
+    }
+    forwardInput("handleInputClosed");
+}
+
+static QString typeKey() { return QStringLiteral("type"); }
+
+static QJsonObject packet(const QString &type)
+{
+    QJsonObject packet;
+    packet.insert(typeKey(), type);
+    return packet;
+}
+
+static QJsonObject locationToJson(const CodeLocation &location)
+{
+    QJsonObject locationObject;
+    locationObject.insert(QStringLiteral("file-path"), location.filePath());
+    locationObject.insert(QStringLiteral("line"), location.line());
+    locationObject.insert(QStringLiteral("column"), location.column());
+    return locationObject;
+}
+
+static QJsonObject errorToJson(const ErrorInfo &error)
+{
+    QJsonArray items;
+    const QList<ErrorItem> errorItems = error.items();
+    for (const ErrorItem &item : errorItems) {
+        QJsonObject itemObject;
+        itemObject.insert(QStringLiteral("description"), item.description());
+        if (item.codeLocation().isValid())
+            itemObject.insert(QStringLiteral("location"), locationToJson(item.codeLocation()));
+        items.append(itemObject);
+    }
+    QJsonObject errorObject;
+    errorObject.insert(QStringLiteral("items"), items);
+    return errorObject;
+}
+
+static QJsonObject productToJson(const ProductData &product)
+{
+    QJsonObject productObject;
+    productObject.insert(QStringLiteral("name"), product.name());
+    productObject.insert(QStringLiteral("full-display-name"), product.fullDisplayName());
+    productObject.insert(QStringLiteral("target-name"), product.targetName());
+    productObject.insert(QStringLiteral("type"), QJsonArray::fromStringList(product.type()));
+    productObject.insert(QStringLiteral("version"), product.version());
+    productObject.insert(QStringLiteral("profile"), product.profile());
+    productObject.insert(QStringLiteral("build-directory"), product.buildDirectory());
+    productObject.insert(QStringLiteral("location"), locationToJson(product.location()));
+    productObject.insert(QStringLiteral("is-enabled"), product.isEnabled());
+    productObject.insert(QStringLiteral("is-runnable"), product.isRunnable());
+    productObject.insert(QStringLiteral("target-executable"), product.targetExecutable());
+    QStringList filePaths;
+    const QList<GroupData> groups = product.groups();
+    for (const GroupData &group : groups)
+        filePaths << group.allFilePaths();
+    filePaths.removeDuplicates();
+    productObject.insert(QStringLiteral("files"), QJsonArray::fromStringList(filePaths));
+    return productObject;
+}
+
+static QJsonObject projectToJson(const ProjectData &project)
+{
+    QJsonObject projectObject;
+    projectObject.insert(QStringLiteral("name"), project.name());
+    projectObject.insert(QStringLiteral("location"), locationToJson(project.location()));
+    projectObject.insert(QStringLiteral("build-directory"), project.buildDirectory());
+    projectObject.insert(QStringLiteral("is-enabled"), project.isEnabled());
+    QJsonArray products;
+    const QList<ProductData> productList = project.products();
+    for (const ProductData &product : productList)
+        products.append(productToJson(product));
+    projectObject.insert(QStringLiteral("products"), products);
+    QJsonArray subProjects;
+    const QList<ProjectData> subProjectList = project.subProjects();
+    for (const ProjectData &subProject : subProjectList)
+        subProjects.append(projectToJson(subProject));
+    projectObject.insert(QStringLiteral("sub-projects"), subProjects);
+    return projectObject;
+}
+
+static QStringList stringListFromRequest(const QJsonObject &request, const QString &key)
+{
+    QStringList list;
+    const QJsonArray array = request.value(key).toArray();
+    for (const QJsonValue &value : array)
+        list << value.toString();
+    return list;
+}
+
+static QString absolutePath(const QString &path)
+{
+    return path.isEmpty() ? path : QDir::cleanPath(QDir::current().absoluteFilePath(path));
+}
+
+Session::Session(Settings *settings, QObject *parent)
+    : QObject(parent)
+    , m_settings(settings)
+    , m_currentJob(nullptr)
+{
+}
+
+Session::~Session()
+{
+    std::lock_guard<std::mutex> lock(inputReceiverMutex);
+    inputReceiver = nullptr;
+}
+
+void Session::start()
+{
+    {
+        std::lock_guard<std::mutex> lock(inputReceiverMutex);
+        inputReceiver = this;
+    }
+    std::thread(readInput).detach();
+    QJsonObject hello = packet(QStringLiteral("hello"));
+    hello.insert(QStringLiteral("api-version"), protocolVersion());
+    sendPacket(hello);
+}
+
+void Session::handleInputLine(const QByteArray &line)
+{
+    if (line.trimmed().isEmpty())
+        return;
+    QJsonParseError parseError;
+    const QJsonDocument document = QJsonDocument::fromJson(line, &parseError);
+    if (parseError.error != QJsonParseError::NoError) {
+        enqueueRequest({QJsonObject(), ErrorInfo(Tr::tr("Failed to parse request: %1")
+                                                 .arg(parseError.errorString()))});
+    } else if (!document.isObject()) {
+        enqueueRequest({QJsonObject(), ErrorInfo(Tr::tr("Request is not a JSON object."))});
+    } else {
+        handleRequest(document.object());
+    }
+}
+
+void Session::handleInputClosed()
+{
+    handleRequest(packet(QStringLiteral("quit")));
+}
+
+void Session::handleRequest(const QJsonObject &request)
+{
+    if (request.value(typeKey()).toString() == QLatin1String("cancel-job")) {
+        cancelCurrentJob();
+        return;
+    }
+    enqueueRequest({request, ErrorInfo()});
+}
+
+void Session::enqueueRequest(const PendingRequest &request)
+{
+    m_pendingRequests << request;
+    processPendingRequests();
+}
+
+void Session::processPendingRequests()
+{
+    while (!m_currentJob && !m_pendingRequests.empty()) {
+        const PendingRequest request = m_pendingRequests.takeFirst();
+        if (request.parseError.hasError()) {
+            sendProtocolError(request.parseError);
+            continue;
+        }
+        try {
+            executeRequest(request.request);
+        } catch (const ErrorInfo &error) {
+            sendProtocolError(error);
+        }
+    }
+}
+
+void Session::executeRequest(const QJsonObject &request)
+{
+    const QString type = request.value(typeKey()).toString();
+    if (type == QLatin1String("resolve-project"))
+        resolveProject(request);
+    else if (type == QLatin1String("build-project"))
+        buildProject(request);
+    else if (type == QLatin1String("clean-project"))
+        cleanProject(request);
+    else if (type == QLatin1String("get-project-data"))
+        sendProjectData();
+    else if (type == QLatin1String("quit"))
+        quit();
+    else
+        throw ErrorInfo(Tr::tr("Unknown request type '%1'.").arg(type));
+}
+
+// A request without a project file path re-resolves the current project with the
+// parameters of the previous request.
+void Session::resolveProject(const QJsonObject &request)
+{
+    const QString projectFilePath
+            = absolutePath(request.value(QStringLiteral("project-file-path")).toString());
+    if (!projectFilePath.isEmpty()) {
+        const QString buildRoot
+                = absolutePath(request.value(QStringLiteral("build-root")).toString());
+        if (buildRoot.isEmpty())
+            throw ErrorInfo(Tr::tr("No build root given."));
+        const QString configurationName
+                = request.value(QStringLiteral("configuration-name")).toString(
+                    QStringLiteral("default"));
+        const QString profileName = request.value(QStringLiteral("top-level-profile")).toString();
+        const Preferences prefs(m_settings);
+        const QString appDir = QDir::cleanPath(QCoreApplication::applicationDirPath());
+        SetupProjectParameters params;
+        params.setProjectFilePath(projectFilePath);
+        params.setBuildRoot(buildRoot);
+        params.setConfigurationName(configurationName);
+        params.setTopLevelProfile(profileName);
+        params.setOverriddenValues(
+                    request.value(QStringLiteral("overridden-values")).toObject().toVariantMap());
+        params.setSettingsDirectory(m_settings->baseDirectory());
+        params.setSearchPaths(prefs.searchPaths(appDir
+                                                + QLatin1String("/" QBS_RELATIVE_SEARCH_PATH)));
+        params.setPluginPaths(prefs.pluginPaths(appDir
+                                                + QLatin1String("/" QBS_RELATIVE_PLUGINS_PATH)));
+        params.setLibexecPath(QDir::cleanPath(appDir
+                                              + QLatin1String("/" QBS_RELATIVE_LIBEXEC_PATH)));
+        params.setPropertyCheckingMode(ErrorHandlingMode::Strict);
+        m_setupParameters = params;
+    } else if (m_setupParameters.projectFilePath().isEmpty()) {
+        throw ErrorInfo(Tr::tr("No project file path given."));
+    }
+    m_setupParameters.setEnvironment(QProcessEnvironment::systemEnvironment());
+    m_setupParameters.setForceProbeExecution(
+                request.value(QStringLiteral("force-probe-execution")).toBool());
+    m_setupParameters.setDryRun(request.value(QStringLiteral("dry-run")).toBool());
+    m_setupParameters.setLogElapsedTime(
+                request.value(QStringLiteral("log-time")).toBool());
+
+    // Passing the existing project lets the job take over its build data instead of
+    // loading the build graph from disk again.
+    SetupProjectJob * const job = m_project.setupProject(m_setupParameters, this, this);
+    connectJob(job);
+}
+
+void Session::buildProject(const QJsonObject &request)
+{
+    if (!m_project.isValid())
+        throw ErrorInfo(Tr::tr("No project has been resolved."));
+    const QList<ProductData> products = productsFromRequest(request);
+    const Preferences prefs(m_settings, m_project.profile());
+    BuildOptions options;
+    const int maxJobCount = request.value(QStringLiteral("max-job-count")).toInt();
+    options.setMaxJobCount(maxJobCount > 0 ? maxJobCount : prefs.jobs());
+    const QJsonObject jobLimitsObject = request.value(QStringLiteral("job-limits")).toObject();
+    QHash<QString, int> jobLimits;
+    for (auto it = jobLimitsObject.constBegin(); it != jobLimitsObject.constEnd(); ++it)
+        jobLimits.insert(it.key(), it.value().toInt());
+    options.setJobLimits(jobLimits);
+    options.setMaxLoad(request.value(QStringLiteral("max-load")).toDouble());
+    options.setMinFreeMemory(request.value(QStringLiteral("min-free-memory")).toInt());
+    options.setKeepGoing(request.value(QStringLiteral("keep-going")).toBool());
+    options.setDryRun(request.value(QStringLiteral("dry-run")).toBool());
+    options.setChangedFiles(stringListFromRequest(request, QStringLiteral("changed-files")));
+    options.setForceTimestampCheck(
+                request.value(QStringLiteral("check-timestamps")).toBool());
+    options.setForceOutputCheck(request.value(QStringLiteral("check-outputs")).toBool());
+    options.setLogElapsedTime(request.value(QStringLiteral("log-time")).toBool());
+    options.setInstall(request.value(QStringLiteral("install")).toBool(true));
+    const QString echoModeString = request.value(QStringLiteral("command-echo-mode")).toString();
+    const CommandEchoMode echoMode = echoModeString.isEmpty()
+            ? prefs.defaultEchoMode() : commandEchoModeFromName(echoModeString);
+    if (echoMode == CommandEchoModeInvalid)
+        throw ErrorInfo(Tr::tr("Invalid command echo mode '%1'.").arg(echoModeString));
+    options.setEchoMode(echoMode);
+
+    BuildJob * const job = products.empty()
+            ? m_project.buildAllProducts(options, Project::ProductSelectionDefaultOnly, this)
+            : m_project.buildSomeProducts(products, options, this);
+    connect(job, &BuildJob::reportCommandDescription,
+            this, [this](const QString &highlight, const QString &message) {
+        QJsonObject description = packet(QStringLiteral("command-description"));
+        description.insert(QStringLiteral("highlight"), highlight);
+        description.insert(QStringLiteral("message"), message);
+        sendPacket(description);
+    });
+    connect(job, &BuildJob::reportProcessResult, this, &Session::handleProcessResult);
+    connectJob(job);
+}
+
+void Session::cleanProject(const QJsonObject &request)
+{
+    if (!m_project.isValid())
+        throw ErrorInfo(Tr::tr("No project has been resolved."));
+    const QList<ProductData> products = productsFromRequest(request);
+    CleanOptions options;
+    options.setKeepGoing(request.value(QStringLiteral("keep-going")).toBool());
+    options.setDryRun(request.value(QStringLiteral("dry-run")).toBool());
+    options.setLogElapsedTime(request.value(QStringLiteral("log-time")).toBool());
+    CleanJob * const job = products.empty() ? m_project.cleanAllProducts(options, this)
+                                            : m_project.cleanSomeProducts(products, options, this);
+    connectJob(job);
+}
+
+void Session::sendProjectData()
+{
+    if (!m_project.isValid())
+        throw ErrorInfo(Tr::tr("No project has been resolved."));
+    QJsonObject reply = packet(QStringLiteral("project-data"));
+    reply.insert(QStringLiteral("project-data"), projectToJson(m_project.projectData()));
+    sendPacket(reply);
+}
+
+void Session::cancelCurrentJob()
+{
+    if (m_currentJob)
+        m_currentJob->cancel();
+}
+
+void Session::quit()
+{
+    m_pendingRequests.clear();
+    qApp->quit();
+}
+
+void Session::connectJob(AbstractJob *job)
+{
+    m_currentJob = job;
+    connect(job, &AbstractJob::taskStarted,
+            this, [this](const QString &description, int maxProgress) {
+        QJsonObject taskStarted = packet(QStringLiteral("task-started"));
+        taskStarted.insert(QStringLiteral("description"), description);
+        taskStarted.insert(QStringLiteral("max-progress"), maxProgress);
+        sendPacket(taskStarted);
+    });
+    connect(job, &AbstractJob::taskProgress, this, [this](int progress) {
+        QJsonObject taskProgress = packet(QStringLiteral("task-progress"));
+        taskProgress.insert(QStringLiteral("progress"), progress);
+        sendPacket(taskProgress);
+    });
+    connect(job, &AbstractJob::finished, this, &Session::handleJobFinished);
+}
+
+void Session::handleJobFinished(bool success, AbstractJob *job)
+{
+    job->deleteLater();
+    m_currentJob = nullptr;
+    QJsonObject reply;
+    if (const auto setupJob = qobject_cast<SetupProjectJob *>(job)) {
+        reply = packet(QStringLiteral("project-resolved"));
+        m_project = success ? setupJob->project() : Project();
+    } else if (qobject_cast<BuildJob *>(job)) {
+        reply = packet(QStringLiteral("project-built"));
+    } else {
+        reply = packet(QStringLiteral("project-cleaned"));
+    }
+    if (!success)
+        reply.insert(QStringLiteral("error"), errorToJson(job->error()));
+    sendPacket(reply);
+    processPendingRequests();
+}
+
+void Session::handleProcessResult(const ProcessResult &result)
+{
+    QJsonObject reply = packet(QStringLiteral("process-result"));
+    reply.insert(QStringLiteral("executable-file-path"), result.executableFilePath());
+    reply.insert(QStringLiteral("arguments"), QJsonArray::fromStringList(result.arguments()));
+    reply.insert(QStringLiteral("working-directory"), result.workingDirectory());
+    reply.insert(QStringLiteral("success"), result.success());
+    reply.insert(QStringLiteral("exit-code"), result.exitCode());
+    reply.insert(QStringLiteral("stdout"), QJsonArray::fromStringList(result.stdOut()));
+    reply.insert(QStringLiteral("stderr"), QJsonArray::fromStringList(result.stdErr()));
+    sendPacket(reply);
+}
+
+QList<ProductData> Session::productsFromRequest(const QJsonObject &request) const
+{
+    QList<ProductData> products;
+    const QStringList productNames = stringListFromRequest(request, QStringLiteral("products"));
+    if (productNames.empty())
+        return products;
+    const QList<ProductData> allProducts = m_project.projectData().allProducts();
+    for (const QString &productName : productNames) {
+        bool found = false;
+        for (const ProductData &product : allProducts) {
+            if (product.name() == productName || product.fullDisplayName() == productName) {
+                products << product;
+                found = true;
+            }
+        }
+        if (!found)
+            throw ErrorInfo(Tr::tr("No such product '%1'.").arg(productName));
+    }
+    return products;
+}
+
+void Session::sendProtocolError(const ErrorInfo &error)
+{
+    QJsonObject reply = packet(QStringLiteral("protocol-error"));
+    reply.insert(QStringLiteral("error"), errorToJson(error));
+    sendPacket(reply);
+}
+
+void Session::sendPacket(const QJsonObject &packet)
+{
+    QByteArray data = QJsonDocument(packet).toJson(QJsonDocument::Compact);
+    data += '\n';
+    std::fwrite(data.constData(), 1, data.size(), stdout);
+    std::fflush(stdout);
+}
+
+void Session::doPrintWarning(const ErrorInfo &warning)
+{
+    QJsonObject reply = packet(QStringLiteral("warning"));
+    reply.insert(QStringLiteral("warning"), errorToJson(warning));
+    sendPacket(reply);
+}
+
+void Session::doPrintMessage(LoggerLevel level, const QString &message, const QString &tag)
+{
+    QJsonObject reply = packet(QStringLiteral("log-data"));
+    reply.insert(QStringLiteral("level"), logLevelName(level));
+    reply.insert(QStringLiteral("message"), message);
+    if (!tag.isEmpty())
+        reply.insert(QStringLiteral("tag"), tag);
+    sendPacket(reply);
+}
+
+} // namespace qbs
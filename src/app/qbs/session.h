@@ -0,0 +1,116 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QBS_SESSION_H
+#define QBS_SESSION_H
+
+#include <api/project.h>
+#include <logging/ilogsink.h>
+#include <tools/error.h>
+#include <tools/setupprojectparameters.h>
+
+#include <QtCore/qbytearray.h>
+#include <QtCore/qjsonobject.h>
+#include <QtCore/qobject.h>
+
+namespace qbs {
+class AbstractJob;
+class ProcessResult;
+class Settings;
+
+// Keeps a project in memory and serves requests that arrive on stdin, so that an IDE
+// does not have to pay for restoring the build graph every time it wants to build.
+// Requests and replies are JSON objects, one per line. Every request has a "type" member;
+// see the session command documentation for the list of request and reply types.
+// Requests are handled one after the other; the only one that is acted upon immediately
+// is "cancel-job".
+class Session : public QObject, private ILogSink
+{
+    Q_OBJECT
+public:
+    explicit Session(Settings *settings, QObject *parent = nullptr);
+    ~Session();
+
+    void start();
+
+private:
+    Q_INVOKABLE void handleInputLine(const QByteArray &line);
+    Q_INVOKABLE void handleInputClosed();
+
+    // A request that could not be parsed is queued with its error, so that the
+    // protocol error is reported in order.
+    struct PendingRequest
+    {
+        QJsonObject request;
+        ErrorInfo parseError;
+    };
+
+    void handleRequest(const QJsonObject &request);
+    void enqueueRequest(const PendingRequest &request);
+    void processPendingRequests();
+    void executeRequest(const QJsonObject &request);
+    void resolveProject(const QJsonObject &request);
+    void buildProject(const QJsonObject &request);
+    void cleanProject(const QJsonObject &request);
+    void sendProjectData();
+    void cancelCurrentJob();
+    void quit();
+
+    void connectJob(AbstractJob *job);
+    void handleJobFinished(bool success, AbstractJob *job);
+    void sendProtocolError(const ErrorInfo &error);
+    void handleProcessResult(const ProcessResult &result);
+    QList<ProductData> productsFromRequest(const QJsonObject &request) const;
+
+    void sendPacket(const QJsonObject &packet);
+
+    // ILogSink implementation
+    void doPrintWarning(const ErrorInfo &warning) override;
+    void doPrintMessage(LoggerLevel level, const QString &message, const QString &tag) override;
+
+    Settings * const m_settings;
+    SetupProjectParameters m_setupParameters;
+    Project m_project;
+    QList<PendingRequest> m_pendingRequests;
+    AbstractJob *m_currentJob;
+};
+
+} // namespace qbs
+
+#endif // QBS_SESSION_H
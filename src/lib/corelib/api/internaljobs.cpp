@@ -58,6 +58,7 @@
 #include <tools/progressobserver.h>
 #include <tools/preferences.h>
 #include <tools/qbsassert.h>
+#include <tools/settings.h>
 
 #include <QtCore/qeventloop.h>
 #include <QtCore/qtimer.h>
@@ -154,12 +155,12 @@ void InternalJob::shareObserverWith(InternalJob *otherJob)
     m_observer = otherJob->m_observer;
 }
 
-void InternalJob::storeBuildGraph(const TopLevelProjectPtr &project)
+void InternalJob::storeBuildGraph(const TopLevelProjectPtr &project, bool inBackground)
 {
     try {
         doSanityChecks(project, logger());
         TimedActivityLogger storeTimer(m_logger, Tr::tr("Storing build graph"), timed());
-        project->store(logger());
+        project->store(logger(), inBackground, timed());
     } catch (const ErrorInfo &error) {
         logger().printWarning(error);
     }
@@ -277,6 +278,10 @@ void InternalSetupProjectJob::start()
         if (deleteLocker)
             delete bgLocker;
     }
+    if (TraceRecorder * const traceRecorder
+            = TraceRecorder::instance(m_parameters.traceFilePath())) {
+        traceRecorder->writeFile(logger());
+    }
     emit finished(this);
 }
 
@@ -308,6 +313,9 @@ void InternalSetupProjectJob::execute()
     }
     }
 
+    Settings settings(m_parameters.settingsDirectory());
+    m_newProject->compressBuildGraph
+            = Preferences(&settings, m_newProject->profile()).compressBuildGraph();
     if (!m_parameters.dryRun())
         storeBuildGraph(m_newProject);
 
@@ -327,6 +335,8 @@ void InternalSetupProjectJob::resolveProjectFromScratch(ScriptEngine *engine)
 void InternalSetupProjectJob::resolveBuildDataFromScratch(const RulesEvaluationContextPtr &evalContext)
 {
     TimedActivityLogger resolveLogger(logger(), QLatin1String("Resolving build project"), timed());
+    TraceSpan resolveSpan(TraceRecorder::instance(m_parameters.traceFilePath()),
+                          QLatin1String("resolve"), QLatin1String("resolve build data"));
     BuildDataResolver(logger()).resolveBuildData(m_newProject, evalContext);
 }
 
@@ -339,7 +349,7 @@ BuildGraphLoadResult InternalSetupProjectJob::restoreProject(const RulesEvaluati
 }
 
 BuildGraphTouchingJob::BuildGraphTouchingJob(const Logger &logger, QObject *parent)
-    : InternalJob(logger, parent), m_dryRun(false)
+    : InternalJob(logger, parent), m_dryRun(false), m_storeInBackground(false)
 {
 }
 
@@ -358,11 +368,11 @@ void BuildGraphTouchingJob::setup(const TopLevelProjectPtr &project,
 void BuildGraphTouchingJob::storeBuildGraph()
 {
     if (!m_dryRun && !error().isInternalError())
-        InternalJob::storeBuildGraph(m_project);
+        InternalJob::storeBuildGraph(m_project, m_storeInBackground);
 }
 
 InternalBuildJob::InternalBuildJob(const Logger &logger, QObject *parent)
-    : BuildGraphTouchingJob(logger, parent), m_executor(nullptr)
+    : BuildGraphTouchingJob(logger, parent), m_executor(nullptr), m_traceRecorder(nullptr)
 {
 }
 
@@ -371,6 +381,8 @@ void InternalBuildJob::build(const TopLevelProjectPtr &project,
 {
     setup(project, products, buildOptions.dryRun());
     setTimed(buildOptions.logElapsedTime());
+    setStoreBuildGraphInBackground(buildOptions.storeBuildGraphInBackground());
+    m_traceRecorder = TraceRecorder::instance(buildOptions.traceFilePath());
 
     m_executor = new Executor(logger());
     m_executor->setProject(project);
@@ -384,6 +396,8 @@ void InternalBuildJob::build(const TopLevelProjectPtr &project,
             this, &BuildGraphTouchingJob::reportCommandDescription);
     connect(m_executor, &Executor::reportProcessResult,
             this, &BuildGraphTouchingJob::reportProcessResult);
+    connect(m_executor, &Executor::reportProcessOutput,
+            this, &BuildGraphTouchingJob::reportProcessOutput);
 
     connect(executorThread, &QThread::started, m_executor, &Executor::build);
     connect(m_executor, &Executor::finished, this, &InternalBuildJob::handleFinished);
@@ -397,6 +411,8 @@ void InternalBuildJob::handleFinished()
     setError(m_executor->error());
     project()->buildData->evaluationContext.reset();
     storeBuildGraph();
+    if (m_traceRecorder)
+        m_traceRecorder->writeFile(logger());
     m_executor->deleteLater();
 }
 
@@ -62,6 +62,7 @@ class BuildGraphLocker;
 class Executor;
 class JobObserver;
 class ScriptEngine;
+class TraceRecorder;
 
 class InternalJob : public QObject
 {
@@ -84,7 +85,7 @@ protected:
 
     JobObserver *observer() const { return m_observer; }
     void setTimed(bool timed) { m_timed = timed; }
-    void storeBuildGraph(const TopLevelProjectPtr &project);
+    void storeBuildGraph(const TopLevelProjectPtr &project, bool inBackground = false);
 
 signals:
     void finished(Internal::InternalJob *job);
@@ -157,6 +158,7 @@ public:
 signals:
     void reportCommandDescription(const QString &highlight, const QString &message);
     void reportProcessResult(const qbs::ProcessResult &result);
+    void reportProcessOutput(const qbs::ProcessResult &partialResult);
 
 protected:
     BuildGraphTouchingJob(const Logger &logger, QObject *parent = nullptr);
@@ -165,11 +167,13 @@ protected:
     void setup(const TopLevelProjectPtr &project, const QList<ResolvedProductPtr> &products,
                bool dryRun);
     void storeBuildGraph();
+    void setStoreBuildGraphInBackground(bool inBackground) { m_storeInBackground = inBackground; }
 
 private:
     TopLevelProjectPtr m_project;
     QList<ResolvedProductPtr> m_products;
     bool m_dryRun;
+    bool m_storeInBackground;
 };
 
 
@@ -187,6 +191,7 @@ private:
     void emitFinished();
 
     Executor *m_executor;
+    TraceRecorder *m_traceRecorder;
 };
 
 
@@ -47,6 +47,8 @@
 #include <QtCore/qloggingcategory.h>
 #include <QtCore/qtimer.h>
 
+#include <algorithm>
+
 namespace qbs {
 using namespace Internal;
 
@@ -303,6 +305,17 @@ void SetupProjectJob::finish()
  * The \a result parameter contains all details on the process that was run by Qbs.
  */
 
+/*!
+ * \fn void BuildJob::reportProcessOutput(const qbs::ProcessResult &partialResult)
+ * \brief Signals that an external command that is still running has written output.
+ * The stdOut() or stdErr() of \a partialResult contain the lines written since the last time
+ * this signal was emitted for the command. Its exit code and success state are not meaningful.
+ * The output is also part of the result passed to reportProcessResult() later, unless it
+ * exceeded the amount of output retained per command.
+ * Output that is redirected to a file or passed through a filter function is not reported
+ * this way.
+ */
+
 BuildJob::BuildJob(const Logger &logger, QObject *parent)
     : AbstractJob(new InternalBuildJob(logger), parent)
 {
@@ -313,6 +326,20 @@ BuildJob::BuildJob(const Logger &logger, QObject *parent)
             this, &BuildJob::reportCommandDescription);
     connect(job, &BuildGraphTouchingJob::reportProcessResult,
             this, &BuildJob::reportProcessResult);
+    connect(job, &BuildGraphTouchingJob::reportProcessOutput,
+            this, &BuildJob::reportProcessOutput);
+}
+
+// A single launcher becomes a bottleneck at high job counts, as all process starts and
+// completions are funneled through it.
+static int processLauncherCount(const BuildOptions &options)
+{
+    if (options.processLauncherCount() > 0)
+        return options.processLauncherCount();
+    const int jobCount = options.maxJobCount() > 0 ? options.maxJobCount()
+                                                   : BuildOptions::defaultMaxJobCount();
+    const int jobsPerLauncher = 32;
+    return std::max(1, (jobCount + jobsPerLauncher - 1) / jobsPerLauncher);
 }
 
 void BuildJob::build(const TopLevelProjectPtr &project, const QList<ResolvedProductPtr> &products,
@@ -320,7 +347,7 @@ void BuildJob::build(const TopLevelProjectPtr &project, const QList<ResolvedProd
 {
     if (!lockProject(project))
         return;
-    LauncherInterface::startLauncher();
+    LauncherInterface::startLauncher(processLauncherCount(options));
     qobject_cast<InternalBuildJob *>(internalJob())->build(project, products, options);
 }
 
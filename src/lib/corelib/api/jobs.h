@@ -131,6 +131,7 @@ class QBS_EXPORT BuildJob : public AbstractJob
 signals:
     void reportCommandDescription(const QString &highlight, const QString &message);
     void reportProcessResult(const qbs::ProcessResult &result);
+    void reportProcessOutput(const qbs::ProcessResult &partialResult);
 
 private:
     BuildJob(const Internal::Logger &logger, QObject *parent);
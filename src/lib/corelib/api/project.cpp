@@ -53,6 +53,7 @@
 #include <buildgraph/buildgraph.h>
 #include <buildgraph/buildgraphloader.h>
 #include <buildgraph/emptydirectoriesremover.h>
+#include <buildgraph/filedependency.h>
 #include <buildgraph/nodetreedumper.h>
 #include <buildgraph/productbuilddata.h>
 #include <buildgraph/productinstaller.h>
@@ -1114,6 +1115,41 @@ std::set<QString> Project::buildSystemFiles() const
     return d->internalProject->buildSystemFiles.toStdSet();
 }
 
+/*!
+ * \brief Returns the files that the dependency scanners found in the last build
+ *        and that are not part of any product, such as headers from include paths.
+ */
+std::set<QString> Project::fileDependencies() const
+{
+    QBS_ASSERT(isValid(), return std::set<QString>());
+    std::set<QString> filePaths;
+    if (const ProjectBuildData * const buildData = d->internalProject->buildData.get()) {
+        for (const FileDependency * const fileDependency : buildData->fileDependencies)
+            filePaths.insert(fileDependency->filePath());
+    }
+    return filePaths;
+}
+
+/*!
+ * \brief Returns the directories that were looked at when expanding the wildcards in the
+ *        products' groups. Files appearing in or disappearing from these directories
+ *        require the project to be set up again.
+ */
+std::set<QString> Project::wildcardDirectories() const
+{
+    QBS_ASSERT(isValid(), return std::set<QString>());
+    std::set<QString> dirPaths;
+    for (const ResolvedProductConstPtr &product : d->internalProject->allProducts()) {
+        for (const GroupConstPtr &group : product->groups) {
+            if (!group->wildcards)
+                continue;
+            for (const auto &dirAndTimestamp : group->wildcards->dirTimeStamps)
+                dirPaths.insert(dirAndTimestamp.first);
+        }
+    }
+    return dirPaths;
+}
+
 RuleCommandList Project::ruleCommands(const ProductData &product,
         const QString &inputFilePath, const QString &outputFileTag, ErrorInfo *error) const
 {
@@ -0,0 +1,240 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "actioncache.h"
+
+#include "artifact.h"
+#include "filedependency.h"
+#include "nodeset.h"
+#include "rulecommands.h"
+#include "transformer.h"
+
+#include <language/language.h>
+#include <logging/categories.h>
+#include <logging/translator.h>
+#include <tools/executablefinder.h>
+#include <tools/fileinfo.h>
+#include <tools/set.h>
+
+#include <QtCore/qcryptographichash.h>
+#include <QtCore/qdir.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qtemporarydir.h>
+
+#include <algorithm>
+
+namespace qbs {
+namespace Internal {
+
+// Bump this when the key computation or the storage layout changes.
+static const char actionCacheVersion[] = "qbs-action-cache-1";
+
+ActionCache::ActionCache(const QString &cacheDirectory, const Logger &logger)
+    : m_cacheDir(QDir::cleanPath(cacheDirectory)), m_logger(logger)
+{
+}
+
+static void addToHash(QCryptographicHash &hash, const QString &str)
+{
+    hash.addData(str.toUtf8());
+    hash.addData("", 1);
+}
+
+QByteArray ActionCache::computeKey(const Transformer *transformer)
+{
+    if (transformer->commands.empty())
+        return QByteArray();
+    const ResolvedProductPtr product = transformer->product();
+    const QString buildDir = product->topLevelProject()->buildDirectory;
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(actionCacheVersion);
+    for (int i = 0; i < transformer->commands.size(); ++i) {
+        const AbstractCommandPtr &command = transformer->commands.commandAt(i);
+
+        // JavaScript commands can have arbitrary side effects that we cannot capture.
+        if (command->type() != AbstractCommand::ProcessCommandType)
+            return QByteArray();
+        const auto cmd = static_cast<const ProcessCommand *>(command.get());
+
+        const QString program = ExecutableFinder(product, product->buildEnvironment)
+                .findExecutable(cmd->program(), cmd->workingDir());
+        addToHash(hash, program);
+        addToHash(hash, FileInfo(program).lastModified().toString());
+        for (const QString &arg : cmd->arguments())
+            addToHash(hash, normalizedString(arg, buildDir));
+        addToHash(hash, normalizedString(cmd->workingDir(), buildDir));
+        QStringList env = cmd->environment().toStringList();
+        env.sort();
+        for (const QString &var : qAsConst(env))
+            addToHash(hash, normalizedString(var, buildDir));
+        for (const QString &key : cmd->relevantEnvVars()) {
+            addToHash(hash, key);
+            addToHash(hash, product->buildEnvironment.value(key));
+        }
+        addToHash(hash, QString::number(cmd->maxExitCode()));
+        addToHash(hash, normalizedString(cmd->stdoutFilePath(), buildDir));
+        addToHash(hash, normalizedString(cmd->stderrFilePath(), buildDir));
+        addToHash(hash, cmd->stdoutFilterFunction());
+        addToHash(hash, cmd->stderrFilterFunction());
+    }
+
+    // The inputs of a transformer are a subset of the children of its outputs. The children
+    // and file dependencies also contain everything found by dependency scanning.
+    Set<QString> inputFilePaths;
+    for (const Artifact * const output : sortedOutputs(transformer)) {
+        addToHash(hash, normalizedString(output->filePath(), buildDir));
+        for (const Artifact * const child : filterByType<Artifact>(output->children))
+            inputFilePaths.insert(child->filePath());
+        for (const FileDependency * const fileDependency : output->fileDependencies)
+            inputFilePaths.insert(fileDependency->filePath());
+    }
+    for (const QString &filePath : inputFilePaths) {
+        const QByteArray contentHash = fileContentHash(filePath);
+        if (contentHash.isEmpty()) {
+            qCDebug(lcExec) << "action cache: cannot hash input file" << filePath;
+            return QByteArray();
+        }
+        addToHash(hash, normalizedString(filePath, buildDir));
+        hash.addData(contentHash);
+    }
+    return hash.result().toHex();
+}
+
+bool ActionCache::restoreOutputs(const QByteArray &key, const Transformer *transformer)
+{
+    const QString entryDir = entryPath(key);
+    if (!FileInfo(entryDir).isDir()) {
+        ++m_missCount;
+        return false;
+    }
+
+    const std::vector<const Artifact *> outputs = sortedOutputs(transformer);
+    for (size_t i = 0; i < outputs.size(); ++i) {
+        const Artifact * const output = outputs.at(i);
+        const QString cachedFilePath = entryDir + QLatin1Char('/') + QString::number(i);
+        if (!FileInfo(cachedFilePath).exists()) {
+            if (!output->alwaysUpdated)
+                continue;
+            ++m_missCount;
+            return false;
+        }
+        QString errorMessage;
+        if (!removeFileRecursion(QFileInfo(output->filePath()), &errorMessage)
+                || !copyFileRecursion(cachedFilePath, output->filePath(), false, false,
+                                      &errorMessage)) {
+            m_logger.qbsWarning() << Tr::tr("Cannot restore '%1' from the action cache: %2")
+                                     .arg(QDir::toNativeSeparators(output->filePath()),
+                                          errorMessage);
+            ++m_missCount;
+            return false;
+        }
+    }
+    qCDebug(lcExec) << "action cache hit for" << key;
+    ++m_hitCount;
+    return true;
+}
+
+void ActionCache::storeOutputs(const QByteArray &key, const Transformer *transformer)
+{
+    const QString entryDir = entryPath(key);
+    if (FileInfo(entryDir).exists())
+        return;
+    const QString parentDir = FileInfo::path(entryDir);
+    if (!QDir::root().mkpath(parentDir)) {
+        m_logger.qbsWarning() << Tr::tr("Cannot create action cache directory '%1'.")
+                                 .arg(QDir::toNativeSeparators(parentDir));
+        return;
+    }
+
+    // Fill a temporary directory first and then move it into place, so that concurrent
+    // builds never see incomplete entries.
+    QTemporaryDir tempDir(parentDir + QLatin1String("/tmp-XXXXXX"));
+    if (!tempDir.isValid())
+        return;
+    const std::vector<const Artifact *> outputs = sortedOutputs(transformer);
+    for (size_t i = 0; i < outputs.size(); ++i) {
+        const Artifact * const output = outputs.at(i);
+        if (!FileInfo(output->filePath()).exists())
+            continue;
+        if (!QFile::copy(output->filePath(), tempDir.path() + QLatin1Char('/')
+                         + QString::number(i))) {
+            qCDebug(lcExec) << "action cache: cannot store" << output->filePath();
+            return;
+        }
+    }
+    if (QDir::root().rename(tempDir.path(), entryDir))
+        tempDir.setAutoRemove(false);
+}
+
+QString ActionCache::entryPath(const QByteArray &key) const
+{
+    const QString keyString = QString::fromLatin1(key);
+    return m_cacheDir + QLatin1Char('/') + keyString.left(2) + QLatin1Char('/') + keyString;
+}
+
+// Different build directories of the same project should be able to share cache entries.
+QString ActionCache::normalizedString(const QString &str, const QString &buildDir) const
+{
+    QString normalized = str;
+    return normalized.replace(buildDir, QLatin1String("<build-dir>"));
+}
+
+QByteArray ActionCache::fileContentHash(const QString &filePath)
+{
+    const FileTime timestamp = FileInfo(filePath).lastModified();
+    auto it = m_fileHashes.find(filePath);
+    if (it != m_fileHashes.end() && it->second.first == timestamp)
+        return it->second.second;
+    const QByteArray contentHash = FileInfo::contentHash(filePath);
+    m_fileHashes[filePath] = std::make_pair(timestamp, contentHash);
+    return contentHash;
+}
+
+std::vector<const Artifact *> ActionCache::sortedOutputs(const Transformer *transformer)
+{
+    std::vector<const Artifact *> outputs(transformer->outputs.cbegin(),
+                                          transformer->outputs.cend());
+    std::sort(outputs.begin(), outputs.end(), [](const Artifact *a1, const Artifact *a2) {
+        return a1->filePath() < a2->filePath();
+    });
+    return outputs;
+}
+
+} // namespace Internal
+} // namespace qbs
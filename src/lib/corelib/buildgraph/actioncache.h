@@ -0,0 +1,93 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QBS_ACTIONCACHE_H
+#define QBS_ACTIONCACHE_H
+
+#include <logging/logger.h>
+#include <tools/filetime.h>
+#include <tools/qttools.h>
+
+#include <QtCore/qbytearray.h>
+#include <QtCore/qstring.h>
+
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace qbs {
+namespace Internal {
+class Artifact;
+class Transformer;
+
+// Stores the outputs of transformers consisting only of process commands in a local directory,
+// keyed on the command lines, the relevant environment and the contents of all input files,
+// including those found by dependency scanning. The directory can be shared between
+// build directories.
+class ActionCache
+{
+public:
+    ActionCache(const QString &cacheDirectory, const Logger &logger);
+
+    // Returns an empty byte array if the transformer's results cannot be cached.
+    QByteArray computeKey(const Transformer *transformer);
+
+    bool restoreOutputs(const QByteArray &key, const Transformer *transformer);
+    void storeOutputs(const QByteArray &key, const Transformer *transformer);
+
+    int hitCount() const { return m_hitCount; }
+    int missCount() const { return m_missCount; }
+
+private:
+    QString entryPath(const QByteArray &key) const;
+    QString normalizedString(const QString &str, const QString &buildDir) const;
+    QByteArray fileContentHash(const QString &filePath);
+    static std::vector<const Artifact *> sortedOutputs(const Transformer *transformer);
+
+    const QString m_cacheDir;
+    Logger m_logger;
+    std::unordered_map<QString, std::pair<FileTime, QByteArray>> m_fileHashes;
+    int m_hitCount = 0;
+    int m_missCount = 0;
+};
+
+} // namespace Internal
+} // namespace qbs
+
+#endif // QBS_ACTIONCACHE_H
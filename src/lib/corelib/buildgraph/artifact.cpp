@@ -140,6 +140,7 @@ void Artifact::load(PersistentPool &pool)
     pool.load(fileDependencies);
     pool.load(properties);
     pool.load(targetOfModule);
+    pool.load(contentHash);
     pool.load(transformer);
     pool.load(m_fileTags);
     artifactType = static_cast<ArtifactType>(pool.load<quint8>());
@@ -157,6 +158,7 @@ void Artifact::store(PersistentPool &pool)
     pool.store(fileDependencies);
     pool.store(properties);
     pool.store(targetOfModule);
+    pool.store(contentHash);
     pool.store(transformer);
     pool.store(m_fileTags);
     pool.store(static_cast<quint8>(artifactType));
@@ -86,6 +86,7 @@ public:
     TransformerPtr transformer;
     PropertyMapPtr properties;
     QString targetOfModule;
+    QByteArray contentHash; // Only set if BuildOptions::detectUnchangedOutputs() is enabled.
 
     enum ArtifactType
     {
@@ -0,0 +1,157 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "backgroundscanner.h"
+
+#include <QtCore/qmetaobject.h>
+#include <QtCore/qthread.h>
+
+#include <algorithm>
+
+namespace qbs {
+namespace Internal {
+
+BackgroundScanner::BackgroundScanner(QObject *parent) : QObject(parent)
+{
+}
+
+BackgroundScanner::~BackgroundScanner()
+{
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        m_quit = true;
+    }
+    m_requestAvailable.notify_all();
+    for (std::thread &thread : m_threads)
+        thread.join();
+}
+
+// Returns false if the file has not been scanned yet. In that case, a scan is requested,
+// unless one is already underway, and resultsAvailable() will be emitted once it is done.
+bool BackgroundScanner::takeResult(ScannerPlugin *plugin, const QString &filePath,
+                                   const QString &dirPath, const QByteArray &fileTags,
+                                   bool scanForFileTags, PluginScanResult *result)
+{
+    const Key key(plugin, filePath);
+    const auto it = m_results.find(key);
+    if (it != m_results.end()) {
+        *result = it.value();
+        m_results.erase(it);
+        return true;
+    }
+    if (!m_pendingKeys.contains(key)) {
+        m_pendingKeys.insert(key);
+        enqueue(Request{plugin, filePath, dirPath, fileTags, scanForFileTags});
+    }
+    return false;
+}
+
+// Forgets all requests and results. Scans that are currently running get discarded
+// when they finish, as the files might have changed in the meantime.
+void BackgroundScanner::reset()
+{
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        ++m_generation;
+        m_requests.clear();
+        m_finishedRequests.clear();
+    }
+    m_pendingKeys.clear();
+    m_results.clear();
+}
+
+void BackgroundScanner::deliverResults()
+{
+    std::vector<std::pair<Key, PluginScanResult>> finishedRequests;
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        finishedRequests.swap(m_finishedRequests);
+    }
+    QList<Key> keys;
+    for (std::pair<Key, PluginScanResult> &finishedRequest : finishedRequests) {
+        m_pendingKeys.remove(finishedRequest.first);
+        m_results.insert(finishedRequest.first, std::move(finishedRequest.second));
+        keys << finishedRequest.first;
+    }
+    if (!keys.empty())
+        emit resultsAvailable(keys);
+}
+
+void BackgroundScanner::enqueue(const Request &request)
+{
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        m_requests.push_back(request);
+        if (m_threads.empty()) {
+            const int threadCount = std::max(1, QThread::idealThreadCount());
+            for (int i = 0; i < threadCount; ++i)
+                m_threads.emplace_back([this] { work(); });
+        }
+    }
+    m_requestAvailable.notify_one();
+}
+
+void BackgroundScanner::work()
+{
+    std::unique_lock<std::mutex> locker(m_mutex);
+    while (true) {
+        m_requestAvailable.wait(locker, [this] { return m_quit || !m_requests.empty(); });
+        if (m_quit)
+            return;
+        const Request request = m_requests.front();
+        m_requests.pop_front();
+        const int generation = m_generation;
+        locker.unlock();
+
+        PluginScanResult result = PluginDependencyScanner::scan(request.plugin,
+                request.filePath, request.dirPath, request.fileTags, request.scanForFileTags);
+
+        locker.lock();
+        if (generation != m_generation)
+            continue;
+        const bool deliveryPending = !m_finishedRequests.empty();
+        m_finishedRequests.emplace_back(Key(request.plugin, request.filePath),
+                                        std::move(result));
+        if (!deliveryPending)
+            QMetaObject::invokeMethod(this, "deliverResults", Qt::QueuedConnection);
+    }
+}
+
+} // namespace Internal
+} // namespace qbs
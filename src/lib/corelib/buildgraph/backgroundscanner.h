@@ -0,0 +1,116 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QBS_BACKGROUNDSCANNER_H
+#define QBS_BACKGROUNDSCANNER_H
+
+#include "depscanner.h"
+
+#include <QtCore/qbytearray.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qobject.h>
+#include <QtCore/qpair.h>
+#include <QtCore/qset.h>
+#include <QtCore/qstring.h>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+class ScannerPlugin;
+
+namespace qbs {
+namespace Internal {
+
+// Runs scanner plugins on worker threads, so that the executor can keep scheduling and
+// harvesting jobs while files are being scanned. Everything except the scanning itself
+// happens in the thread the object lives in: Finished scans are collected via a queued call
+// and announced by the resultsAvailable() signal, after which takeResult() hands them out.
+class BackgroundScanner : public QObject
+{
+    Q_OBJECT
+public:
+    typedef QPair<const ScannerPlugin *, QString> Key;
+
+    BackgroundScanner(QObject *parent = nullptr);
+    ~BackgroundScanner();
+
+    bool takeResult(ScannerPlugin *plugin, const QString &filePath, const QString &dirPath,
+                    const QByteArray &fileTags, bool scanForFileTags, PluginScanResult *result);
+    void reset();
+
+signals:
+    void resultsAvailable(const QList<qbs::Internal::BackgroundScanner::Key> &keys);
+
+private:
+    class Request
+    {
+    public:
+        ScannerPlugin *plugin;
+        QString filePath;
+        QString dirPath;
+        QByteArray fileTags;
+        bool scanForFileTags;
+    };
+
+    Q_INVOKABLE void deliverResults();
+    void enqueue(const Request &request);
+    void work();
+
+    std::mutex m_mutex;
+    std::condition_variable m_requestAvailable;
+    std::deque<Request> m_requests;
+    std::vector<std::pair<Key, PluginScanResult>> m_finishedRequests;
+    std::vector<std::thread> m_threads;
+    int m_generation = 0;
+    bool m_quit = false;
+
+    // Only accessed from the object's thread.
+    QSet<Key> m_pendingKeys;
+    QHash<Key, PluginScanResult> m_results;
+};
+
+} // namespace Internal
+} // namespace qbs
+
+#endif // QBS_BACKGROUNDSCANNER_H
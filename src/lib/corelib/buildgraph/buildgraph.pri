@@ -2,10 +2,12 @@ include(../../../install_prefix.pri)
 
 SOURCES += \
     $$PWD/abstractcommandexecutor.cpp \
+    $$PWD/actioncache.cpp \
     $$PWD/artifact.cpp \
     $$PWD/artifactcleaner.cpp \
     $$PWD/artifactsscriptvalue.cpp \
     $$PWD/artifactvisitor.cpp \
+    $$PWD/backgroundscanner.cpp \
     $$PWD/buildgraph.cpp \
     $$PWD/buildgraphloader.cpp \
     $$PWD/buildgraphnode.cpp \
@@ -18,6 +20,8 @@ SOURCES += \
     $$PWD/executorjob.cpp \
     $$PWD/filedependency.cpp \
     $$PWD/inputartifactscanner.cpp \
+    $$PWD/jobserver.cpp \
+    $$PWD/jobslotpool.cpp \
     $$PWD/jscommandexecutor.cpp \
     $$PWD/nodeset.cpp \
     $$PWD/nodetreedumper.cpp \
@@ -41,10 +45,12 @@ SOURCES += \
 
 HEADERS += \
     $$PWD/abstractcommandexecutor.h \
+    $$PWD/actioncache.h \
     $$PWD/artifact.h \
     $$PWD/artifactcleaner.h \
     $$PWD/artifactsscriptvalue.h \
     $$PWD/artifactvisitor.h \
+    $$PWD/backgroundscanner.h \
     $$PWD/buildgraph.h \
     $$PWD/buildgraphloader.h \
     $$PWD/buildgraphnode.h \
@@ -59,6 +65,8 @@ HEADERS += \
     $$PWD/filedependency.h \
     $$PWD/forward_decls.h \
     $$PWD/inputartifactscanner.h \
+    $$PWD/jobserver.h \
+    $$PWD/jobslotpool.h \
     $$PWD/jscommandexecutor.h \
     $$PWD/nodeset.h \
     $$PWD/nodetreedumper.h \
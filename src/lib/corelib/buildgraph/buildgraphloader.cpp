@@ -853,6 +853,7 @@ void BuildGraphLoader::rescueOldBuildData(const ResolvedProductConstPtr &restore
         if (!newArtifact) {
             RescuableArtifactData rad;
             rad.timeStamp = oldArtifact->timestamp();
+            rad.contentHash = oldArtifact->contentHash;
             rad.fileTags = oldArtifact->fileTags();
             rad.properties = oldArtifact->properties;
             rad.commands = oldArtifact->transformer->commands;
@@ -875,6 +876,8 @@ void BuildGraphLoader::rescueOldBuildData(const ResolvedProductConstPtr &restore
             rad.artifactsMapRequestedInCommands
                     = oldArtifact->transformer->artifactsMapRequestedInCommands;
             rad.lastCommandExecutionTime = oldArtifact->transformer->lastCommandExecutionTime;
+            rad.lastCommandExecutionDuration
+                    = oldArtifact->transformer->lastCommandExecutionDuration;
             rad.lastPrepareScriptExecutionTime
                     = oldArtifact->transformer->lastPrepareScriptExecutionTime;
             const ChildrenInfo &childrenInfo = childLists.value(oldArtifact);
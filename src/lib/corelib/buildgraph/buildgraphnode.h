@@ -70,6 +70,10 @@ public:
 
     BuildState buildState;                  // Do not serialize. Will be refreshed for every build.
 
+    // Do not serialize. The sum of the recorded command durations on the longest path from
+    // this node to a root, in milliseconds. Initialized lazily in the executor; -1 means unknown.
+    qint64 criticalPathWeight = -1;
+
     enum Type
     {
         ArtifactNodeType,
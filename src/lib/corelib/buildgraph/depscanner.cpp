@@ -103,30 +103,53 @@ QStringList PluginDependencyScanner::collectSearchPaths(Artifact *artifact)
 QStringList PluginDependencyScanner::collectDependencies(FileResourceBase *file,
                                                          const char *fileTags)
 {
-    Set<QString> result;
-    QString baseDirOfInFilePath = file->dirPath();
-    const QString &filepath = file->filePath();
-    void *scannerHandle = m_plugin->open(filepath.utf16(), fileTags, ScanForDependenciesFlag);
+    return scan(m_plugin, file->filePath(), file->dirPath(), fileTags, false).dependencies;
+}
+
+PluginScanResult PluginDependencyScanner::scan(ScannerPlugin *plugin, const QString &filePath,
+        const QString &dirPath, const QByteArray &fileTags, bool scanForFileTags)
+{
+    PluginScanResult scanResult;
+    scanResult.fileTagsForScanner = fileTags;
+    scanResult.scannedForFileTags = scanForFileTags;
+    int scanFlags = ScanForDependenciesFlag;
+    if (scanForFileTags && plugin->additionalFileTags)
+        scanFlags |= ScanForFileTagsFlag;
+    scanResult.scanTime = FileTime::currentTime();
+    void *scannerHandle = plugin->open(filePath.utf16(), fileTags.constData(), scanFlags);
     if (!scannerHandle)
-        return QStringList();
+        return scanResult;
+    if (scanFlags & ScanForFileTagsFlag) {
+        int length = 0;
+        const char **additionalFileTags = plugin->additionalFileTags(scannerHandle, &length);
+        for (int i = 0; additionalFileTags && i < length; ++i)
+            scanResult.additionalFileTags << QByteArray(additionalFileTags[i]);
+    }
+    Set<QString> result;
     forever {
         int flags = 0;
         int length = 0;
-        const char *szOutFilePath = m_plugin->next(scannerHandle, &length, &flags);
+        const char *szOutFilePath = plugin->next(scannerHandle, &length, &flags);
         if (szOutFilePath == nullptr)
             break;
         QString outFilePath = QString::fromLocal8Bit(szOutFilePath, length);
         if (outFilePath.isEmpty())
             continue;
         if (flags & SC_LOCAL_INCLUDE_FLAG) {
-            QString localFilePath = FileInfo::resolvePath(baseDirOfInFilePath, outFilePath);
+            QString localFilePath = FileInfo::resolvePath(dirPath, outFilePath);
             if (FileInfo::exists(localFilePath))
                 outFilePath = localFilePath;
         }
         result += outFilePath;
     }
-    m_plugin->close(scannerHandle);
-    return QStringList(result.toList());
+    plugin->close(scannerHandle);
+    scanResult.dependencies = QStringList(result.toList());
+    return scanResult;
+}
+
+QByteArray PluginDependencyScanner::fileTagsForScanner(const FileTags &fileTags)
+{
+    return fileTags.toStringList().join(QLatin1Char(',')).toLatin1();
 }
 
 bool PluginDependencyScanner::recursive() const
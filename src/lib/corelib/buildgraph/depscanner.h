@@ -43,7 +43,10 @@
 #include <language/forward_decls.h>
 #include <language/filetags.h>
 #include <language/preparescriptobserver.h>
+#include <tools/filetime.h>
 
+#include <QtCore/qbytearray.h>
+#include <QtCore/qlist.h>
 #include <QtCore/qstringlist.h>
 
 #include <QtScript/qscriptvalue.h>
@@ -71,6 +74,7 @@ public:
     virtual const void *key() const = 0;
     virtual bool areModulePropertiesCompatible(const PropertyMapConstPtr &m1,
                                                const PropertyMapConstPtr &m2) const = 0;
+    virtual ScannerPlugin *scannerPlugin() const { return nullptr; }
 
 private:
     virtual QString createId() const = 0;
@@ -78,11 +82,29 @@ private:
     mutable QString m_id;
 };
 
+// The file tags are kept as plain strings, so that scanning does not create file tags.
+class PluginScanResult
+{
+public:
+    FileTime scanTime;
+    QByteArray fileTagsForScanner;
+    bool scannedForFileTags = false;
+    QStringList dependencies;
+    QList<QByteArray> additionalFileTags;
+};
+
 class PluginDependencyScanner : public DependencyScanner
 {
 public:
     PluginDependencyScanner(ScannerPlugin *plugin);
 
+    // Collects the dependencies and, if requested and the plugin provides them, the additional
+    // file tags in one pass. Does not touch the build graph, so it can be called from any thread.
+    static PluginScanResult scan(ScannerPlugin *plugin, const QString &filePath,
+                                 const QString &dirPath, const QByteArray &fileTags,
+                                 bool scanForFileTags);
+    static QByteArray fileTagsForScanner(const FileTags &fileTags);
+
 private:
     QStringList collectSearchPaths(Artifact *artifact);
     QStringList collectDependencies(FileResourceBase *file, const char *fileTags);
@@ -91,6 +113,7 @@ private:
     QString createId() const;
     bool areModulePropertiesCompatible(const PropertyMapConstPtr &m1,
                                        const PropertyMapConstPtr &m2) const;
+    ScannerPlugin *scannerPlugin() const { return m_plugin; }
 
     ScannerPlugin* m_plugin;
 };
@@ -38,6 +38,7 @@
 ****************************************************************************/
 #include "executor.h"
 
+#include "actioncache.h"
 #include "buildgraph.h"
 #include "emptydirectoriesremover.h"
 #include "environmentscriptrunner.h"
@@ -46,6 +47,7 @@
 #include "cycledetector.h"
 #include "executorjob.h"
 #include "inputartifactscanner.h"
+#include "jobslotpool.h"
 #include "productinstaller.h"
 #include "rescuableartifactdata.h"
 #include "rulecommands.h"
@@ -61,11 +63,13 @@
 #include <logging/translator.h>
 #include <tools/error.h>
 #include <tools/fileinfo.h>
+#include <tools/parallelfor.h>
 #include <tools/profiling.h>
 #include <tools/progressobserver.h>
 #include <tools/qbsassert.h>
 #include <tools/qttools.h>
 #include <tools/stringconstants.h>
+#include <tools/systemload.h>
 
 #include <QtCore/qdir.h>
 #include <QtCore/qtimer.h>
@@ -80,26 +84,71 @@ namespace Internal {
 
 bool Executor::ComparePriority::operator() (const BuildGraphNode *x, const BuildGraphNode *y) const
 {
+    // Nodes on a long chain of expensive commands are started first, so the tail of the build
+    // does not wait on them. Without timing data from earlier builds, product order decides.
+    if (x->criticalPathWeight != y->criticalPathWeight)
+        return x->criticalPathWeight < y->criticalPathWeight;
     return x->product->buildData->buildPriority() < y->product->buildData->buildPriority();
 }
 
+static qint64 commandDuration(const BuildGraphNode *node)
+{
+    if (node->type() != BuildGraphNode::ArtifactNodeType)
+        return 0;
+    const Artifact * const artifact = static_cast<const Artifact *>(node);
+    return artifact->transformer ? artifact->transformer->lastCommandExecutionDuration : 0;
+}
+
+static qint64 computeCriticalPathWeight(BuildGraphNode *node)
+{
+    if (node->criticalPathWeight >= 0)
+        return node->criticalPathWeight;
+    qint64 maxParentWeight = 0;
+    for (BuildGraphNode * const parent : qAsConst(node->parents)) {
+        if (parent->buildState == BuildGraphNode::Untouched)
+            continue;
+        maxParentWeight = std::max(maxParentWeight, computeCriticalPathWeight(parent));
+    }
+    node->criticalPathWeight = commandDuration(node) + maxParentWeight;
+    return node->criticalPathWeight;
+}
+
 
 Executor::Executor(const Logger &logger, QObject *parent)
     : QObject(parent)
     , m_productInstaller(nullptr)
+    , m_actionCache(nullptr)
+    , m_traceRecorder(nullptr)
+    , m_traceProcessId(TraceRecorder::mainProcessId())
     , m_logger(logger)
     , m_progressObserver(nullptr)
     , m_state(ExecutorIdle)
     , m_cancelationTimer(new QTimer(this))
+    , m_throttleTimer(new QTimer(this))
+    , m_backgroundScanner(new BackgroundScanner(this))
+    , m_hasReservedJobSlot(false)
 {
     m_inputArtifactScanContext = new InputArtifactScannerContext;
     m_cancelationTimer->setSingleShot(false);
     m_cancelationTimer->setInterval(1000);
     connect(m_cancelationTimer, &QTimer::timeout, this, &Executor::checkForCancellation);
+    m_throttleTimer->setSingleShot(true);
+    m_throttleTimer->setInterval(500);
+    connect(m_throttleTimer, &QTimer::timeout, this, &Executor::handleThrottleTimeout);
+    connect(m_backgroundScanner, &BackgroundScanner::resultsAvailable,
+            this, &Executor::handleBackgroundScanResults);
 }
 
 Executor::~Executor()
 {
+    // If the build did not finish regularly, we still own job slots that the other executors
+    // in this process might be waiting for. Unregister first, so they do not get handed to us.
+    JobSlotPool::instance().unregisterExecutor(this);
+    for (auto it = m_processingJobs.cbegin(); it != m_processingJobs.cend(); ++it) {
+        JobSlotPool::instance().release();
+        releaseJobPoolSlots(it.value().get());
+    }
+    releaseReservedJobSlot();
     // jobs must be destroyed before deleting the shared scan result cache
     for (ExecutorJob *job : qAsConst(m_availableJobs))
         delete job;
@@ -107,6 +156,7 @@ Executor::~Executor()
         delete job;
     delete m_inputArtifactScanContext;
     delete m_productInstaller;
+    delete m_actionCache;
 }
 
 FileTime Executor::recursiveFileTime(const QString &filePath) const
@@ -131,16 +181,28 @@ FileTime Executor::recursiveFileTime(const QString &filePath) const
     return newest;
 }
 
-void Executor::retrieveSourceFileTimestamp(Artifact *artifact) const
+bool Executor::needsFileSystemTimestamp(const Artifact *artifact) const
+{
+    if (m_buildOptions.changedFiles().empty())
+        return true;
+    if (m_buildOptions.changedFiles().contains(artifact->filePath()))
+        return false;
+    return !artifact->timestamp().isValid();
+}
+
+void Executor::retrieveSourceFileTimestamp(Artifact *artifact,
+                                           const FileTime &prefetchedTimestamp) const
 {
     QBS_CHECK(artifact->artifactType == Artifact::SourceFile);
 
-    if (m_buildOptions.changedFiles().empty())
-        artifact->setTimestamp(recursiveFileTime(artifact->filePath()));
-    else if (m_buildOptions.changedFiles().contains(artifact->filePath()))
-        artifact->setTimestamp(FileTime::currentTime());
-    else if (!artifact->timestamp().isValid())
+    if (!needsFileSystemTimestamp(artifact)) {
+        if (m_buildOptions.changedFiles().contains(artifact->filePath()))
+            artifact->setTimestamp(FileTime::currentTime());
+    } else if (prefetchedTimestamp.isValid()) {
+        artifact->setTimestamp(prefetchedTimestamp);
+    } else {
         artifact->setTimestamp(recursiveFileTime(artifact->filePath()));
+    }
 
     artifact->timestampRetrieved = true;
     if (!artifact->timestamp().isValid())
@@ -229,6 +291,10 @@ void Executor::doBuild()
     m_tagsNeededForFilesToConsider.clear();
     m_productsOfFilesToConsider.clear();
     m_artifactsRemovedFromDisk.clear();
+    m_transformersWaitingForJobPool.clear();
+    m_transformersWaitingForScans.clear();
+    m_pendingScanCounts.clear();
+    m_finishedScans.clear();
 
     // TODO: The "filesToConsider" thing is badly designed; we should know exactly which artifact
     //       it is. Remove this from the BuildOptions class and introduce Project::buildSomeFiles()
@@ -265,6 +331,7 @@ void Executor::doBuild()
     m_evalContext = m_project->buildData->evaluationContext;
 
     m_elapsedTimeRules = m_elapsedTimeScanners = m_elapsedTimeInstalling = 0;
+    m_elapsedTimeSourceTimestamps = 0;
     m_evalContext->engine()->enableProfiling(m_buildOptions.logElapsedTime());
 
     InstallOptions installOptions;
@@ -277,7 +344,16 @@ void Executor::doBuild()
     if (m_buildOptions.removeExistingInstallation())
         m_productInstaller->removeInstallRoot();
 
+    if (!m_buildOptions.actionCacheDirectory().isEmpty() && !m_buildOptions.dryRun())
+        m_actionCache = new ActionCache(m_buildOptions.actionCacheDirectory(), m_logger);
+    if (m_traceRecorder) {
+        m_traceProcessId = m_traceRecorder->addProcess(QLatin1String("build ")
+                                                       + m_project->id());
+    }
     addExecutorJobs();
+    if (m_buildOptions.provideJobServer())
+        JobSlotPool::instance().startJobServer(m_buildOptions.maxJobCount());
+    JobSlotPool::instance().registerExecutor(this, m_buildOptions.maxJobCount());
     syncFileDependencies();
     prepareAllNodes();
     prepareProducts();
@@ -296,6 +372,7 @@ void Executor::doBuild()
 void Executor::setBuildOptions(const BuildOptions &buildOptions)
 {
     m_buildOptions = buildOptions;
+    m_traceRecorder = TraceRecorder::instance(buildOptions.traceFilePath());
 }
 
 
@@ -337,15 +414,36 @@ void Executor::updateLeaves(BuildGraphNode *node, NodeSet &seenNodes)
 
     if (isLeaf) {
         qCDebug(lcExec) << "adding leaf" << node->toString();
-        m_leaves.push(node);
+        addLeaf(node);
     }
 }
 
+void Executor::addLeaf(BuildGraphNode *node)
+{
+    computeCriticalPathWeight(node);
+    m_leaves.push(node);
+}
+
 // Returns true if some artifacts are still waiting to be built or currently building.
 bool Executor::scheduleJobs()
 {
     QBS_CHECK(m_state == ExecutorRunning);
     while (!m_leaves.empty() && !m_availableJobs.empty()) {
+        // Other executors in this process might be using up the global job budget.
+        if (!m_hasReservedJobSlot) {
+            // Keep at least one job running, so that the build always makes progress.
+            if (!m_processingJobs.empty() && systemIsOverloaded()) {
+                qCDebug(lcExec) << "system is overloaded, delaying new jobs";
+                m_throttleTimer->start();
+                break;
+            }
+            if (!JobSlotPool::instance().acquire(this)) {
+                qCDebug(lcExec) << "no job slot available, waiting";
+                break;
+            }
+            m_hasReservedJobSlot = true;
+        }
+
         BuildGraphNode * const nodeToBuild = m_leaves.top();
         m_leaves.pop();
 
@@ -368,7 +466,146 @@ bool Executor::scheduleJobs()
             break;
         }
     }
-    return !m_leaves.empty() || !m_processingJobs.empty();
+    releaseReservedJobSlot();
+    return !m_leaves.empty() || !m_processingJobs.empty()
+            || !m_transformersWaitingForScans.empty() || !m_transformersWaitingForJobPool.empty();
+}
+
+// For callbacks that resume a running build.
+void Executor::scheduleJobsOrFinish()
+{
+    try {
+        if (!scheduleJobs()) {
+            qCDebug(lcExec) << "Nothing left to build; finishing.";
+            finish();
+        }
+    } catch (const ErrorInfo &error) {
+        handleError(error);
+    }
+}
+
+void Executor::handleJobSlotGranted()
+{
+    if (m_state == ExecutorRunning && m_evalContext->engine()->isActive()) {
+        QTimer::singleShot(0, this, &Executor::handleJobSlotGranted);
+        return;
+    }
+    if (!JobSlotPool::instance().takeGrantedSlot(this))
+        return;
+    if (m_hasReservedJobSlot || m_state != ExecutorRunning) {
+        JobSlotPool::instance().release();
+        return;
+    }
+    m_hasReservedJobSlot = true;
+    scheduleJobsOrFinish();
+}
+
+// All transformers waiting for the pool get another chance. The ones that still do not
+// get a slot are put back into the queue.
+void Executor::handleJobPoolSlotFreed(const QString &pool)
+{
+    if (m_state == ExecutorRunning && m_evalContext->engine()->isActive()) {
+        QTimer::singleShot(0, this, [this, pool] { handleJobPoolSlotFreed(pool); });
+        return;
+    }
+    const QList<TransformerPtr> waitingTransformers = m_transformersWaitingForJobPool.take(pool);
+    if (m_state != ExecutorRunning)
+        return;
+    for (const TransformerPtr &transformer : waitingTransformers) {
+        for (Artifact * const output : qAsConst(transformer->outputs)) {
+            if (output->buildState == BuildGraphNode::Buildable) {
+                addLeaf(output);
+                break;
+            }
+        }
+    }
+    scheduleJobsOrFinish();
+}
+
+bool Executor::systemIsOverloaded() const
+{
+    const double maxLoad = m_buildOptions.maxLoad();
+    const qint64 minFreeMemory = qint64(m_buildOptions.minFreeMemory()) * 1024 * 1024;
+    if (maxLoad <= 0 && minFreeMemory <= 0)
+        return false;
+    const SystemLoad load = SystemLoad::current();
+    if (maxLoad > 0 && load.loadAverage() > maxLoad) {
+        qCDebug(lcExec) << "load average" << load.loadAverage() << "exceeds" << maxLoad;
+        return true;
+    }
+    if (minFreeMemory > 0 && load.availableMemory() >= 0
+            && load.availableMemory() < minFreeMemory) {
+        qCDebug(lcExec) << "available memory" << load.availableMemory()
+                        << "is below" << minFreeMemory;
+        return true;
+    }
+    return false;
+}
+
+void Executor::handleThrottleTimeout()
+{
+    if (m_state != ExecutorRunning)
+        return;
+    if (m_evalContext->engine()->isActive()) {
+        m_throttleTimer->start();
+        return;
+    }
+    scheduleJobsOrFinish();
+}
+
+void Executor::handleBackgroundScanResults(const QList<BackgroundScanner::Key> &keys)
+{
+    m_finishedScans << keys;
+    processFinishedBackgroundScans();
+}
+
+// Transformers whose scans are all done get scheduled again and re-run the input artifact
+// scanner, which now finds the results.
+void Executor::processFinishedBackgroundScans()
+{
+    if (m_state != ExecutorRunning || m_finishedScans.empty())
+        return;
+    if (m_evalContext->engine()->isActive()) {
+        QTimer::singleShot(0, this, &Executor::processFinishedBackgroundScans);
+        return;
+    }
+    const QList<BackgroundScanner::Key> finishedScans = m_finishedScans;
+    m_finishedScans.clear();
+    for (const BackgroundScanner::Key &key : finishedScans) {
+        const QList<TransformerPtr> transformers = m_transformersWaitingForScans.take(key);
+        for (const TransformerPtr &transformer : transformers) {
+            const auto it = m_pendingScanCounts.find(transformer.get());
+            QBS_CHECK(it != m_pendingScanCounts.end());
+            if (--it.value() > 0)
+                continue;
+            m_pendingScanCounts.erase(it);
+            for (Artifact * const output : qAsConst(transformer->outputs)) {
+                if (output->buildState == BuildGraphNode::Buildable) {
+                    addLeaf(output);
+                    break;
+                }
+            }
+        }
+    }
+    scheduleJobsOrFinish();
+}
+
+void Executor::releaseReservedJobSlot()
+{
+    if (!m_hasReservedJobSlot)
+        return;
+    m_hasReservedJobSlot = false;
+    JobSlotPool::instance().release();
+}
+
+// An artifact whose commands re-created it with unchanged contents keeps its old timestamp,
+// so that its parents are not rebuilt. Its children must then be compared with the time
+// its commands were last run instead.
+static FileTime upToDateCheckTime(const Artifact *artifact)
+{
+    if (artifact->contentHash.isEmpty() || !artifact->transformer)
+        return artifact->timestamp();
+    return std::max(artifact->timestamp(), artifact->transformer->lastCommandExecutionTime);
 }
 
 bool Executor::isUpToDate(Artifact *artifact) const
@@ -389,12 +626,14 @@ bool Executor::isUpToDate(Artifact *artifact) const
         return false;
     }
 
+    const FileTime checkTime = upToDateCheckTime(artifact);
+
     for (Artifact *childArtifact : filterByType<Artifact>(artifact->children)) {
         QBS_CHECK(childArtifact->timestamp().isValid());
         qCDebug(lcUpToDateCheck) << "child timestamp"
                                  << childArtifact->timestamp().toString()
                                  << childArtifact->filePath();
-        if (artifact->timestamp() < childArtifact->timestamp())
+        if (checkTime < childArtifact->timestamp())
             return false;
     }
 
@@ -411,7 +650,7 @@ bool Executor::isUpToDate(Artifact *artifact) const
         qCDebug(lcUpToDateCheck) << "file dependency timestamp"
                                  << fileDependency->timestamp().toString()
                                  << fileDependency->filePath();
-        if (artifact->timestamp() < fileDependency->timestamp())
+        if (checkTime < fileDependency->timestamp())
             return false;
     }
 
@@ -472,6 +711,10 @@ void Executor::buildArtifact(Artifact *artifact)
 void Executor::executeRuleNode(RuleNode *ruleNode)
 {
     AccumulatingTimer rulesTimer(m_buildOptions.logElapsedTime() ? &m_elapsedTimeRules : nullptr);
+    TraceSpan rulesSpan(m_traceRecorder, QLatin1String("rule"),
+                        [ruleNode] { return ruleNode->rule()->toString(); }, m_traceProcessId);
+    rulesSpan.addArg(QLatin1String("product"),
+                     [ruleNode] { return ruleNode->product->uniqueName(); });
 
     if (!checkNodeProduct(ruleNode))
         return;
@@ -496,7 +739,7 @@ void Executor::executeRuleNode(RuleNode *ruleNode)
                         continue;
                     if (!parent->alwaysUpdated)
                         continue;
-                    if (parent->timestamp() < artifact->timestamp()) {
+                    if (upToDateCheckTime(parent) < artifact->timestamp()) {
                         changedInputArtifacts += artifact;
                         break;
                     }
@@ -553,10 +796,14 @@ void Executor::finishJob(ExecutorJob *job, bool success)
     const TransformerPtr transformer = it.value();
     m_processingJobs.erase(it);
     m_availableJobs.push_back(job);
+    JobSlotPool::instance().release();
+    releaseJobPoolSlots(transformer.get());
+    m_inputArtifactScanContext->commandsFinished();
     if (success) {
         m_project->buildData->isDirty = true;
         for (Artifact * const artifact : qAsConst(transformer->outputs)) {
             if (artifact->alwaysUpdated) {
+                const FileTime oldTimestamp = artifact->timestamp();
                 artifact->setTimestamp(FileTime::currentTime());
                 if (m_buildOptions.forceOutputCheck()
                         && !m_buildOptions.dryRun() && !FileInfo(artifact->filePath()).exists()) {
@@ -574,6 +821,7 @@ void Executor::finishJob(ExecutorJob *job, bool success)
                                        "but the artifact was not produced.")
                                     .arg(artifact->filePath()));
                 }
+                checkForUnchangedContents(artifact, oldTimestamp);
             } else {
                 artifact->setTimestamp(FileInfo(artifact->filePath()).lastModified());
             }
@@ -604,6 +852,25 @@ void Executor::finishJob(ExecutorJob *job, bool success)
     }
 }
 
+void Executor::checkForUnchangedContents(Artifact *artifact, const FileTime &oldTimestamp)
+{
+    if (m_buildOptions.dryRun())
+        return;
+    if (!m_buildOptions.detectUnchangedOutputs()) {
+        artifact->contentHash.clear();
+        return;
+    }
+    const QByteArray oldContentHash = artifact->contentHash;
+    artifact->contentHash = FileInfo::contentHash(artifact->filePath());
+    if (oldTimestamp.isValid() && !oldContentHash.isEmpty()
+            && oldContentHash == artifact->contentHash
+            && !artifact->transformer->commands.empty()) {
+        qCDebug(lcExec) << "contents of" << relativeArtifactFileName(artifact)
+                        << "did not change, keeping old timestamp";
+        artifact->setTimestamp(oldTimestamp);
+    }
+}
+
 static bool allChildrenBuilt(BuildGraphNode *node)
 {
     return std::all_of(node->children.cbegin(), node->children.cend(),
@@ -621,7 +888,7 @@ void Executor::finishNode(BuildGraphNode *leaf)
         }
 
         if (allChildrenBuilt(parent)) {
-            m_leaves.push(parent);
+            addLeaf(parent);
             qCDebug(lcExec) << "finishNode adds leaf"
                             << parent->toString() << toString(parent->buildState);
         } else {
@@ -731,10 +998,15 @@ void Executor::addExecutorJobs()
         job->setObjectName(QString::fromLatin1("J%1").arg(i));
         job->setDryRun(m_buildOptions.dryRun());
         job->setEchoMode(m_buildOptions.echoMode());
+        job->setActionCache(m_actionCache);
+        job->setTraceRecorder(m_traceRecorder, m_traceProcessId, i);
+        if (m_traceRecorder)
+            m_traceRecorder->setThreadName(m_traceProcessId, i, job->objectName());
         m_availableJobs.push_back(job);
         connect(job, &ExecutorJob::reportCommandDescription,
                 this, &Executor::reportCommandDescription);
         connect(job, &ExecutorJob::reportProcessResult, this, &Executor::reportProcessResult);
+        connect(job, &ExecutorJob::reportProcessOutput, this, &Executor::reportProcessOutput);
         connect(job, &ExecutorJob::finished,
                 this, &Executor::onJobFinished, Qt::QueuedConnection);
     }
@@ -841,9 +1113,11 @@ void Executor::rescueOldBuildData(Artifact *artifact, bool *childrenAdded = 0)
         artifact->transformer->artifactsMapRequestedInCommands
                 = rad.artifactsMapRequestedInCommands;
         artifact->transformer->lastCommandExecutionTime = rad.lastCommandExecutionTime;
+        artifact->transformer->lastCommandExecutionDuration = rad.lastCommandExecutionDuration;
         artifact->transformer->lastPrepareScriptExecutionTime = rad.lastPrepareScriptExecutionTime;
         artifact->transformer->commandsNeedChangeTracking = true;
         artifact->setTimestamp(rad.timeStamp);
+        artifact->contentHash = rad.contentHash;
         if (childrenAdded && !childrenToConnect.empty())
             *childrenAdded = true;
         for (const ChildArtifactData &cad : qAsConst(childrenToConnect)) {
@@ -917,17 +1191,34 @@ void Executor::potentiallyRunTransformer(const TransformerPtr &transformer)
 
     const bool mustExecute = mustExecuteTransformer(transformer);
     if (mustExecute || m_buildOptions.forceTimestampCheck()) {
+        std::vector<BackgroundScanner::Key> pendingScans;
         for (Artifact * const output : qAsConst(transformer->outputs)) {
             // Scan all input artifacts. If new dependencies were found during scanning, delay
-            // execution of this transformer.
+            // execution of this transformer. The same goes for files that still need to be
+            // scanned by a scanner plugin; these scans run in the background.
             InputArtifactScanner scanner(output, m_inputArtifactScanContext, m_logger);
+            scanner.setBackgroundScanner(m_backgroundScanner);
             AccumulatingTimer scanTimer(m_buildOptions.logElapsedTime()
                                         ? &m_elapsedTimeScanners : nullptr);
+            TraceSpan scanSpan(m_traceRecorder, QLatin1String("scan"),
+                               [output] { return output->fileName(); }, m_traceProcessId);
+            scanSpan.addArg(QLatin1String("file"), output->filePath());
             scanner.scan();
             scanTimer.stop();
+            scanSpan.stop();
+            if (!scanner.pendingScans().empty()) {
+                output->inputsScanned = false;
+                pendingScans.insert(pendingScans.end(), scanner.pendingScans().cbegin(),
+                                    scanner.pendingScans().cend());
+                continue;
+            }
             if (scanner.newDependencyAdded() && checkForUnbuiltDependencies(output))
                 return;
         }
+        if (!pendingScans.empty()) {
+            waitForBackgroundScans(transformer, pendingScans);
+            return;
+        }
     }
 
     if (!mustExecute) {
@@ -938,8 +1229,68 @@ void Executor::potentiallyRunTransformer(const TransformerPtr &transformer)
 
     if (m_buildOptions.executeRulesOnly())
         finishTransformer(transformer);
-    else
+    else if (acquireJobPoolSlots(transformer))
+        runTransformerWithJobPoolSlots(transformer);
+}
+
+// The job pools are shared with other executors, so they must not leak if the job
+// does not get started.
+void Executor::runTransformerWithJobPoolSlots(const TransformerPtr &transformer)
+{
+    try {
         runTransformer(transformer);
+    } catch (const ErrorInfo &) {
+        releaseJobPoolSlots(transformer.get());
+        throw;
+    }
+}
+
+void Executor::waitForBackgroundScans(const TransformerPtr &transformer,
+                                      const std::vector<BackgroundScanner::Key> &keys)
+{
+    qCDebug(lcExec) << "waiting for" << keys.size() << "background scan(s)";
+    int &pendingScanCount = m_pendingScanCounts[transformer.get()];
+    for (const BackgroundScanner::Key &key : keys) {
+        QList<TransformerPtr> &waitingTransformers = m_transformersWaitingForScans[key];
+        if (waitingTransformers.contains(transformer))
+            continue;
+        waitingTransformers << transformer;
+        ++pendingScanCount;
+    }
+}
+
+static QStringList jobPools(const Transformer *transformer)
+{
+    QStringList pools;
+    for (const AbstractCommandPtr &command : transformer->commands.commands()) {
+        const QString &pool = command->jobPool();
+        if (!pool.isEmpty() && !pools.contains(pool))
+            pools << pool;
+    }
+    return pools;
+}
+
+// If one of the transformer's job pools is exhausted, the transformer gets put into that
+// pool's queue and will be scheduled again once one of the pool's commands has finished,
+// possibly in a different executor.
+bool Executor::acquireJobPoolSlots(const TransformerPtr &transformer)
+{
+    const QStringList pools = jobPools(transformer.get());
+    QString exhaustedPool;
+    if (JobSlotPool::instance().acquireJobPools(this, pools, m_buildOptions.jobLimits(),
+                                                &exhaustedPool)) {
+        return true;
+    }
+    qCDebug(lcExec) << "job pool" << exhaustedPool << "is exhausted, delaying execution";
+    QList<TransformerPtr> &waitingTransformers = m_transformersWaitingForJobPool[exhaustedPool];
+    if (!waitingTransformers.contains(transformer))
+        waitingTransformers << transformer;
+    return false;
+}
+
+void Executor::releaseJobPoolSlots(const Transformer *transformer)
+{
+    JobSlotPool::instance().releaseJobPools(jobPools(transformer));
 }
 
 void Executor::runTransformer(const TransformerPtr &transformer)
@@ -958,6 +1309,8 @@ void Executor::runTransformer(const TransformerPtr &transformer)
     }
 
     QBS_CHECK(!m_availableJobs.empty());
+    QBS_CHECK(m_hasReservedJobSlot);
+    m_hasReservedJobSlot = false; // Now owned by the job.
     ExecutorJob *job = m_availableJobs.takeFirst();
     for (Artifact * const artifact : qAsConst(transformer->outputs))
         artifact->buildState = BuildGraphNode::Building;
@@ -1073,6 +1426,13 @@ void Executor::finish()
     QBS_ASSERT(m_state != ExecutorIdle, /* ignore */);
     QBS_ASSERT(!m_evalContext || !m_evalContext->engine()->isActive(), /* ignore */);
 
+    m_throttleTimer->stop();
+    releaseReservedJobSlot();
+    JobSlotPool::instance().unregisterExecutor(this);
+    m_backgroundScanner->reset();
+    m_transformersWaitingForScans.clear();
+    m_pendingScanCounts.clear();
+    m_finishedScans.clear();
     checkForUnbuiltProducts();
     if (m_explicitlyCanceled) {
         QString message = Tr::tr(m_buildOptions.executeRulesOnly()
@@ -1088,9 +1448,17 @@ void Executor::finish()
     EmptyDirectoriesRemover(m_project.get(), m_logger)
             .removeEmptyParentDirectories(m_artifactsRemovedFromDisk);
 
+    if (m_actionCache) {
+        m_logger.qbsInfo() << Tr::tr("Action cache: %1 hit(s), %2 miss(es).")
+                              .arg(m_actionCache->hitCount()).arg(m_actionCache->missCount());
+    }
+
     if (m_buildOptions.logElapsedTime()) {
         m_logger.qbsLog(LoggerInfo, true) << "\t" << Tr::tr("Rule execution took %1.")
                                              .arg(elapsedTimeString(m_elapsedTimeRules));
+        m_logger.qbsLog(LoggerInfo, true) << "\t" << Tr::tr("Retrieving source file timestamps "
+                                                             "took %1.")
+                                             .arg(elapsedTimeString(m_elapsedTimeSourceTimestamps));
         m_logger.qbsLog(LoggerInfo, true) << "\t" << Tr::tr("Artifact scanning took %1.")
                                              .arg(elapsedTimeString(m_elapsedTimeScanners));
         m_logger.qbsLog(LoggerInfo, true) << "\t" << Tr::tr("Installing artifacts took %1.")
@@ -1107,6 +1475,11 @@ void Executor::checkForCancellation()
         cancelJobs();
         if (m_evalContext->engine()->isActive())
             m_evalContext->engine()->cancel();
+        else if (m_processingJobs.empty()) {
+            // We were only waiting for job slots or background scans.
+            m_explicitlyCanceled = true;
+            finish();
+        }
     }
 }
 
@@ -1137,71 +1510,118 @@ void Executor::prepareAllNodes()
     for (const ResolvedProductPtr &product : m_allProducts) {
         if (product->enabled) {
             QBS_CHECK(product->buildData);
-            for (BuildGraphNode * const node : qAsConst(product->buildData->allNodes()))
+            for (BuildGraphNode * const node : qAsConst(product->buildData->allNodes())) {
                 node->buildState = BuildGraphNode::Untouched;
+                node->criticalPathWeight = -1;
+            }
         }
     }
+    std::vector<Artifact *> artifacts;
     for (const ResolvedProductPtr &product : qAsConst(m_productsToBuild)) {
         QBS_CHECK(product->buildData);
         for (Artifact * const artifact : filterByType<Artifact>(product->buildData->allNodes()))
-            prepareArtifact(artifact);
+            artifacts.push_back(artifact);
     }
+    const std::vector<FileTime> timestamps = prefetchSourceFileTimestamps(artifacts);
+    for (std::size_t i = 0; i < artifacts.size(); ++i)
+        prepareArtifact(artifacts.at(i), timestamps.at(i));
+}
+
+/**
+  * Retrieves the timestamps of all plain source files in \a artifacts concurrently, as on
+  * network file systems and with cold caches the stat() calls dominate null builds.
+  * Entries for all other artifacts, as well as for directories and missing files, are invalid;
+  * these are handled serially by retrieveSourceFileTimestamp().
+  */
+std::vector<FileTime> Executor::prefetchSourceFileTimestamps(
+        const std::vector<Artifact *> &artifacts)
+{
+    std::vector<FileTime> timestamps(artifacts.size());
+    AccumulatingTimer timer(m_buildOptions.logElapsedTime()
+                            ? &m_elapsedTimeSourceTimestamps : nullptr);
+    parallelFor(int(artifacts.size()), m_buildOptions.maxJobCount(), [&](int i) {
+        const Artifact * const artifact = artifacts.at(i);
+        if (artifact->artifactType != Artifact::SourceFile || !needsFileSystemTimestamp(artifact))
+            return;
+        const FileInfo fileInfo(artifact->filePath());
+        if (fileInfo.exists() && !fileInfo.isDir())
+            timestamps[i] = std::max(fileInfo.lastModified(), fileInfo.lastStatusChange());
+    });
+    return timestamps;
 }
 
 void Executor::syncFileDependencies()
 {
     Set<FileDependency *> &globalFileDepList = m_project->buildData->fileDependencies;
-    for (auto it = globalFileDepList.begin(); it != globalFileDepList.end(); ) {
-        FileDependency * const dep = *it;
-        if (FileInfo(dep->filePath()).exists()) {
-            ++it;
+
+    // This also refreshes the timestamps that the up-to-date checks compare against, so that
+    // all file dependencies are stat()ed concurrently, like the source files.
+    const std::vector<FileDependency *> deps(globalFileDepList.cbegin(), globalFileDepList.cend());
+    {
+        AccumulatingTimer timer(m_buildOptions.logElapsedTime()
+                                ? &m_elapsedTimeSourceTimestamps : nullptr);
+        parallelFor(int(deps.size()), m_buildOptions.maxJobCount(), [&deps](int i) {
+            FileDependency * const dep = deps.at(i);
+            dep->setTimestamp(FileInfo(dep->filePath()).lastModified());
+        });
+    }
+
+    std::vector<FileDependency *> vanishedDeps;
+    for (FileDependency * const dep : deps) {
+        if (dep->timestamp().isValid())
             continue;
-        }
         qCDebug(lcBuildGraph()) << "file dependency" << dep->filePath() << "no longer exists; "
                                    "removing from lookup table";
         m_project->buildData->removeFromLookupTable(dep);
-        bool isReferencedByArtifact = false;
-        for (const ResolvedProductConstPtr &product : m_allProducts) {
-            if (!product->buildData)
-                continue;
-            const auto artifactList = filterByType<Artifact>(product->buildData->allNodes());
-            isReferencedByArtifact = std::any_of(artifactList.begin(), artifactList.end(),
-                    [dep](const Artifact *a) { return a->fileDependencies.contains(dep); });
+        vanishedDeps.push_back(dep);
+    }
+    if (vanishedDeps.empty())
+        return;
+
+    // Find the references to all vanished dependencies in one pass over the artifacts.
+    // Checking each dependency separately is quadratic, which hurts when e.g. an SDK upgrade
+    // makes thousands of headers disappear at once.
+    const Set<FileDependency *> vanishedDepsSet
+            = Set<FileDependency *>::fromStdVector(vanishedDeps);
+    std::vector<FileDependency *> referencedDeps;
+    for (const ResolvedProductConstPtr &product : m_allProducts) {
+        if (!product->buildData)
+            continue;
+        for (const Artifact * const a : filterByType<Artifact>(product->buildData->allNodes())) {
             // TODO: Would it be safe to mark the artifact as "not up to date" here and clear
             //       its list of file dependencies, rather than doing the check again in
             //       isUpToDate()?
-            if (isReferencedByArtifact)
-                break;
-        }
-        if (!isReferencedByArtifact) {
-            qCDebug(lcBuildGraph()) << "dependency is not referenced by any artifact, deleting";
-            it = globalFileDepList.erase(it);
-            delete dep;
-        } else {
-            ++it;
+            for (FileDependency * const dep : a->fileDependencies) {
+                if (vanishedDepsSet.contains(dep))
+                    referencedDeps.push_back(dep);
+            }
         }
     }
+    const Set<FileDependency *> unreferencedDeps
+            = vanishedDepsSet - Set<FileDependency *>::fromStdVector(referencedDeps);
+    for (FileDependency * const dep : unreferencedDeps) {
+        qCDebug(lcBuildGraph()) << "dependency" << dep->filePath()
+                                << "is not referenced by any artifact, deleting";
+    }
+    globalFileDepList -= unreferencedDeps;
+    qDeleteAll(unreferencedDeps);
 }
 
-void Executor::prepareArtifact(Artifact *artifact)
+void Executor::prepareArtifact(Artifact *artifact, const FileTime &prefetchedTimestamp)
 {
     artifact->inputsScanned = false;
     artifact->timestampRetrieved = false;
 
     if (artifact->artifactType == Artifact::SourceFile) {
         const FileTime oldTimestamp = artifact->timestamp();
-        retrieveSourceFileTimestamp(artifact);
+        retrieveSourceFileTimestamp(artifact, prefetchedTimestamp);
         if (oldTimestamp != artifact->timestamp())
             m_changedSourceArtifacts.push_back(artifact);
         possiblyInstallArtifact(artifact);
     }
 
-    // Timestamps of file dependencies must be invalid for every build.
-    // TODO: These should be a subset of ProjectBuildData::fileDependencies, so clear the
-    // timestamps in syncFileDepencencies() instead.
-    // TODO: Verify this assumption in the sanity checks.
-    for (FileDependency * const fileDependency : qAsConst(artifact->fileDependencies))
-        fileDependency->clearTimestamp();
+    // The timestamps of the file dependencies were refreshed in syncFileDependencies().
+    // They are a subset of ProjectBuildData::fileDependencies, as the sanity checks verify.
 }
 
 void Executor::setupForBuildingSelectedFiles(const BuildGraphNode *node)
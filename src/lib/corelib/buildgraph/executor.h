@@ -41,6 +41,7 @@
 #define QBS_BUILDGRAPHEXECUTOR_H
 
 #include "forward_decls.h"
+#include "backgroundscanner.h"
 #include "buildgraphvisitor.h"
 #include <buildgraph/artifact.h>
 #include <language/forward_decls.h>
@@ -48,12 +49,14 @@
 #include <logging/logger.h>
 #include <tools/buildoptions.h>
 #include <tools/error.h>
+#include <tools/filetime.h>
 #include <tools/qttools.h>
 
 #include <QtCore/qobject.h>
 
 #include <queue>
 #include <unordered_map>
+#include <vector>
 
 QT_BEGIN_NAMESPACE
 class QTimer;
@@ -63,12 +66,13 @@ namespace qbs {
 class ProcessResult;
 
 namespace Internal {
+class ActionCache;
 class ExecutorJob;
-class FileTime;
 class InputArtifactScannerContext;
 class ProductInstaller;
 class ProgressObserver;
 class RuleNode;
+class TraceRecorder;
 
 class Executor : public QObject, private BuildGraphVisitor
 {
@@ -90,10 +94,19 @@ public:
 signals:
     void reportCommandDescription(const QString &highlight, const QString &message);
     void reportProcessResult(const qbs::ProcessResult &result);
+    void reportProcessOutput(const qbs::ProcessResult &partialResult);
 
     void finished();
 
 private:
+    Q_INVOKABLE void handleJobSlotGranted();
+    Q_INVOKABLE void handleJobPoolSlotFreed(const QString &pool);
+    void releaseReservedJobSlot();
+    bool systemIsOverloaded() const;
+    void handleThrottleTimeout();
+    void handleBackgroundScanResults(const QList<BackgroundScanner::Key> &keys);
+    void processFinishedBackgroundScans();
+
     void onJobFinished(const qbs::ErrorInfo &err);
     void finish();
     void checkForCancellation();
@@ -115,7 +128,7 @@ private:
     void doBuild();
     void prepareAllNodes();
     void syncFileDependencies();
-    void prepareArtifact(Artifact *artifact);
+    void prepareArtifact(Artifact *artifact, const FileTime &prefetchedTimestamp);
     void setupForBuildingSelectedFiles(const BuildGraphNode *node);
     void prepareReachableNodes();
     void prepareReachableNodes_impl(BuildGraphNode *node);
@@ -124,10 +137,13 @@ private:
     void initLeaves();
     void updateLeaves(const NodeSet &nodes);
     void updateLeaves(BuildGraphNode *node, NodeSet &seenNodes);
+    void addLeaf(BuildGraphNode *node);
     bool scheduleJobs();
+    void scheduleJobsOrFinish();
     void buildArtifact(Artifact *artifact);
     void executeRuleNode(RuleNode *ruleNode);
     void finishJob(ExecutorJob *job, bool success);
+    void checkForUnchangedContents(Artifact *artifact, const FileTime &oldTimestamp);
     void finishNode(BuildGraphNode *leaf);
     void finishArtifact(Artifact *artifact);
     void setState(ExecutorState);
@@ -140,14 +156,23 @@ private:
     bool checkForUnbuiltDependencies(Artifact *artifact);
     void potentiallyRunTransformer(const TransformerPtr &transformer);
     void runTransformer(const TransformerPtr &transformer);
+    void runTransformerWithJobPoolSlots(const TransformerPtr &transformer);
     void finishTransformer(const TransformerPtr &transformer);
+    void waitForBackgroundScans(const TransformerPtr &transformer,
+                                const std::vector<BackgroundScanner::Key> &keys);
+    bool acquireJobPoolSlots(const TransformerPtr &transformer);
+    void releaseJobPoolSlots(const Transformer *transformer);
     void possiblyInstallArtifact(const Artifact *artifact);
     void checkForUnbuiltProducts();
     bool checkNodeProduct(BuildGraphNode *node);
 
     bool mustExecuteTransformer(const TransformerPtr &transformer) const;
     bool isUpToDate(Artifact *artifact) const;
-    void retrieveSourceFileTimestamp(Artifact *artifact) const;
+    bool needsFileSystemTimestamp(const Artifact *artifact) const;
+    std::vector<FileTime> prefetchSourceFileTimestamps(
+            const std::vector<Artifact *> &artifacts);
+    void retrieveSourceFileTimestamp(Artifact *artifact,
+                                     const FileTime &prefetchedTimestamp = FileTime()) const;
     FileTime recursiveFileTime(const QString &filePath) const;
     QString configString() const;
     bool transformerHasMatchingOutputTags(const TransformerConstPtr &transformer) const;
@@ -156,8 +181,15 @@ private:
 
     typedef QHash<ExecutorJob *, TransformerPtr> JobMap;
     JobMap m_processingJobs;
+    QHash<QString, QList<TransformerPtr>> m_transformersWaitingForJobPool;
+    QHash<BackgroundScanner::Key, QList<TransformerPtr>> m_transformersWaitingForScans;
+    QHash<const Transformer *, int> m_pendingScanCounts;
+    QList<BackgroundScanner::Key> m_finishedScans;
 
     ProductInstaller *m_productInstaller;
+    ActionCache *m_actionCache;
+    TraceRecorder *m_traceRecorder;
+    int m_traceProcessId;
     RulesEvaluationContextPtr m_evalContext;
     BuildOptions m_buildOptions;
     Logger m_logger;
@@ -180,11 +212,15 @@ private:
     FileTags m_tagsNeededForFilesToConsider;
     QList<ResolvedProductPtr> m_productsOfFilesToConsider;
     QTimer * const m_cancelationTimer;
+    QTimer * const m_throttleTimer;
+    BackgroundScanner * const m_backgroundScanner;
     QStringList m_artifactsRemovedFromDisk;
     bool m_partialBuild;
+    bool m_hasReservedJobSlot;
     qint64 m_elapsedTimeRules;
     qint64 m_elapsedTimeScanners;
     qint64 m_elapsedTimeInstalling;
+    qint64 m_elapsedTimeSourceTimestamps;
 };
 
 } // namespace Internal
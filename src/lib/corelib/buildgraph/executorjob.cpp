@@ -39,13 +39,16 @@
 
 #include "executorjob.h"
 
+#include "actioncache.h"
 #include "artifact.h"
 #include "jscommandexecutor.h"
 #include "processcommandexecutor.h"
 #include "rulecommands.h"
 #include "transformer.h"
 #include <language/language.h>
+#include <logging/translator.h>
 #include <tools/error.h>
+#include <tools/profiling.h>
 #include <tools/qbsassert.h>
 
 #include <QtCore/qthread.h>
@@ -62,6 +65,8 @@ ExecutorJob::ExecutorJob(const Logger &logger, QObject *parent)
             this, &ExecutorJob::reportCommandDescription);
     connect(m_processCommandExecutor, &ProcessCommandExecutor::reportProcessResult,
             this, &ExecutorJob::reportProcessResult);
+    connect(m_processCommandExecutor, &ProcessCommandExecutor::reportProcessOutput,
+            this, &ExecutorJob::reportProcessOutput);
     connect(m_processCommandExecutor, &AbstractCommandExecutor::finished,
             this, &ExecutorJob::onCommandFinished);
     connect(m_jsCommandExecutor, &AbstractCommandExecutor::reportCommandDescription,
@@ -91,6 +96,14 @@ void ExecutorJob::setEchoMode(CommandEchoMode echoMode)
 {
     m_processCommandExecutor->setEchoMode(echoMode);
     m_jsCommandExecutor->setEchoMode(echoMode);
+    m_echoMode = echoMode;
+}
+
+void ExecutorJob::setTraceRecorder(TraceRecorder *recorder, int processId, int jobSlot)
+{
+    m_traceRecorder = recorder;
+    m_traceProcessId = processId;
+    m_jobSlot = jobSlot;
 }
 
 void ExecutorJob::run(Transformer *t)
@@ -112,6 +125,13 @@ void ExecutorJob::run(Transformer *t)
     m_processCommandExecutor->setProcessEnvironment(
                 (*t->outputs.cbegin())->product->buildEnvironment);
     m_transformer = t;
+    m_elapsedTimer.start();
+    if (restoreFromActionCache()) {
+        // The time it took to copy the outputs says nothing about the commands.
+        m_elapsedTimer.invalidate();
+        setFinished();
+        return;
+    }
     runNextCommand();
 }
 
@@ -123,6 +143,29 @@ void ExecutorJob::cancel()
     m_currentCommandExecutor->cancel();
 }
 
+bool ExecutorJob::restoreFromActionCache()
+{
+    if (!m_actionCache)
+        return false;
+    m_actionCacheKey = m_actionCache->computeKey(m_transformer);
+    if (m_actionCacheKey.isEmpty() || !m_actionCache->restoreOutputs(m_actionCacheKey,
+                                                                     m_transformer)) {
+        return false;
+    }
+    m_actionCacheKey.clear(); // Nothing to store.
+    if (m_echoMode == CommandEchoModeSilent)
+        return true;
+    for (int i = 0; i < m_transformer->commands.size(); ++i) {
+        const AbstractCommandPtr &command = m_transformer->commands.commandAt(i);
+        if (!command->isSilent() && !command->description().isEmpty()) {
+            emit reportCommandDescription(command->highlight(),
+                                          Tr::tr("%1 (from action cache)")
+                                          .arg(command->description()));
+        }
+    }
+    return true;
+}
+
 void ExecutorJob::runNextCommand()
 {
     QBS_ASSERT(m_currentCommandIdx <= m_transformer->commands.size(), return);
@@ -144,12 +187,16 @@ void ExecutorJob::runNextCommand()
         qFatal("Missing implementation for command type %d", command->type());
     }
 
+    if (m_traceRecorder)
+        m_commandStartTime = TraceRecorder::currentTime();
     m_currentCommandExecutor->start(m_transformer, command.get());
 }
 
 void ExecutorJob::onCommandFinished(const ErrorInfo &err)
 {
     QBS_ASSERT(m_transformer, return);
+    if (m_traceRecorder)
+        traceCurrentCommand();
     if (m_error.hasError()) { // Canceled?
         setFinished();
     } else if (err.hasError()) {
@@ -160,8 +207,28 @@ void ExecutorJob::onCommandFinished(const ErrorInfo &err)
     }
 }
 
+void ExecutorJob::traceCurrentCommand()
+{
+    const AbstractCommandPtr &command = m_transformer->commands.commandAt(m_currentCommandIdx);
+    QString name = command->description();
+    if (name.isEmpty() && command->type() == AbstractCommand::ProcessCommandType)
+        name = static_cast<const ProcessCommand *>(command.get())->program();
+    QJsonObject args;
+    args.insert(QLatin1String("product"), m_transformer->product()->uniqueName());
+    if (m_transformer->rule)
+        args.insert(QLatin1String("rule"), m_transformer->rule->toString());
+    m_traceRecorder->addEvent(QLatin1String("command"), name, m_commandStartTime,
+                              m_traceProcessId, m_jobSlot, args);
+}
+
 void ExecutorJob::setFinished()
 {
+    if (m_transformer && !m_error.hasError()) {
+        if (m_elapsedTimer.isValid())
+            m_transformer->lastCommandExecutionDuration = m_elapsedTimer.elapsed();
+        if (!m_actionCacheKey.isEmpty())
+            m_actionCache->storeOutputs(m_actionCacheKey, m_transformer);
+    }
     const ErrorInfo err = m_error;
     reset();
     emit finished(err);
@@ -172,6 +239,8 @@ void ExecutorJob::reset()
     m_transformer = nullptr;
     m_currentCommandExecutor = nullptr;
     m_currentCommandIdx = -1;
+    m_actionCacheKey.clear();
+    m_elapsedTimer.invalidate();
     m_error.clear();
 }
 
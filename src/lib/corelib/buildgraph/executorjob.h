@@ -44,6 +44,8 @@
 #include <tools/commandechomode.h>
 #include <tools/error.h>
 
+#include <QtCore/qbytearray.h>
+#include <QtCore/qelapsedtimer.h>
 #include <QtCore/qobject.h>
 
 namespace qbs {
@@ -52,11 +54,13 @@ class ProcessResult;
 
 namespace Internal {
 class AbstractCommandExecutor;
+class ActionCache;
 class ProductBuildData;
 class JsCommandExecutor;
 class Logger;
 class ProcessCommandExecutor;
 class ScriptEngine;
+class TraceRecorder;
 class Transformer;
 
 class ExecutorJob : public QObject
@@ -69,17 +73,22 @@ public:
     void setMainThreadScriptEngine(ScriptEngine *engine);
     void setDryRun(bool enabled);
     void setEchoMode(CommandEchoMode echoMode);
+    void setActionCache(ActionCache *actionCache) { m_actionCache = actionCache; }
+    void setTraceRecorder(TraceRecorder *recorder, int processId, int jobSlot);
     void run(Transformer *t);
     void cancel();
 
 signals:
     void reportCommandDescription(const QString &highlight, const QString &message);
     void reportProcessResult(const qbs::ProcessResult &result);
+    void reportProcessOutput(const qbs::ProcessResult &partialResult);
     void finished(const qbs::ErrorInfo &error = ErrorInfo()); // !hasError() <=> command successful
 
 private:
+    bool restoreFromActionCache();
     void runNextCommand();
     void onCommandFinished(const qbs::ErrorInfo &err);
+    void traceCurrentCommand();
 
     void setFinished();
     void reset();
@@ -87,9 +96,17 @@ private:
     AbstractCommandExecutor *m_currentCommandExecutor;
     ProcessCommandExecutor *m_processCommandExecutor;
     JsCommandExecutor *m_jsCommandExecutor;
+    ActionCache *m_actionCache = nullptr;
+    QByteArray m_actionCacheKey;
+    CommandEchoMode m_echoMode = defaultCommandEchoMode();
+    TraceRecorder *m_traceRecorder = nullptr;
+    int m_traceProcessId = 0;
+    int m_jobSlot = 0;
+    qint64 m_commandStartTime = 0;
     Transformer *m_transformer;
     int m_currentCommandIdx;
     ErrorInfo m_error;
+    QElapsedTimer m_elapsedTimer;
 };
 
 } // namespace Internal
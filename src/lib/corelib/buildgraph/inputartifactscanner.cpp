@@ -43,6 +43,7 @@
 #include "buildgraph.h"
 #include "productbuilddata.h"
 #include "projectbuilddata.h"
+#include "qtmocscanner.h"
 #include "transformer.h"
 #include "depscanner.h"
 #include "rulesevaluationcontext.h"
@@ -50,21 +51,68 @@
 #include <language/language.h>
 #include <logging/categories.h>
 #include <tools/fileinfo.h>
+#include <tools/hostosinfo.h>
 #include <tools/scannerpluginmanager.h>
 #include <tools/qbsassert.h>
 #include <tools/error.h>
 #include <tools/qttools.h>
 
 #include <QtCore/qdir.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qfileinfo.h>
 #include <QtCore/qstringlist.h>
 #include <QtCore/qvariant.h>
 
+#include <algorithm>
+
+#if defined(Q_OS_MACOS) || defined(Q_OS_OSX)
+#include <unistd.h>
+#endif
+
 namespace qbs {
 namespace Internal {
 
+static bool isCaseSensitiveDirectory(const QString &dirPath)
+{
+    if (HostOsInfo::isWindowsHost())
+        return false;
+#if defined(Q_OS_MACOS) || defined(Q_OS_OSX)
+    // Depends on how the volume was formatted.
+    return pathconf(QFile::encodeName(dirPath).constData(), _PC_CASE_SENSITIVE) != 0;
+#else
+    Q_UNUSED(dirPath);
+    return true;
+#endif
+}
+
+bool DirectoryContentsCache::fileExists(const QString &dirPath, const QString &fileName)
+{
+    Listing &listing = m_listings[dirPath];
+    if (listing.generation != m_generation) {
+        const QDateTime dirTimestamp = QFileInfo(dirPath).lastModified();
+        if (!listing.timestampIsReliable || dirTimestamp != listing.dirTimestamp) {
+            // Timestamps have a limited resolution, so a file created right after the listing
+            // might not change the timestamp of a recently modified directory.
+            const QDateTime now = QDateTime::currentDateTime();
+            listing.fileNames.clear();
+            listing.dirTimestamp = dirTimestamp;
+            listing.timestampIsReliable = !dirTimestamp.isValid()
+                    || dirTimestamp.msecsTo(now) > 2000;
+            listing.caseSensitive = isCaseSensitiveDirectory(dirPath);
+            for (const QString &entry : QDir(dirPath).entryList(QDir::Files | QDir::Hidden,
+                                                                QDir::NoSort)) {
+                listing.fileNames.insert(listing.caseSensitive ? entry : entry.toLower());
+            }
+        }
+        listing.generation = m_generation;
+    }
+    return listing.fileNames.count(listing.caseSensitive ? fileName : fileName.toLower()) > 0;
+}
+
 static void resolveDepencency(const RawScannedDependency &dependency,
-                              const ResolvedProduct *product, ResolvedDependency *result,
-                              const QString &baseDir = QString())
+                              const ResolvedProduct *product,
+                              DirectoryContentsCache &directoryContents,
+                              ResolvedDependency *result, const QString &baseDir = QString())
 {
     QString absDirPath = baseDir.isEmpty()
             ? dependency.dirPath()
@@ -104,14 +152,22 @@ static void resolveDepencency(const RawScannedDependency &dependency,
         return;
     }
 
-    const QString &absFilePath = baseDir.isEmpty()
+    // TODO: We probably need a flag that tells us whether directories are allowed.
+    if (!directoryContents.fileExists(absDirPath, dependency.fileName()))
+        return;
+    result->filePath = baseDir.isEmpty()
             ? dependency.filePath()
             : absDirPath + QLatin1Char('/') + dependency.fileName();
+}
 
-    // TODO: We probably need a flag that tells us whether directories are allowed.
-    const FileInfo fi(absFilePath);
-    if (fi.exists(absFilePath) && !fi.isDir())
-        result->filePath = absFilePath;
+// Do not scan an artifact that is not built yet: Its contents might still change.
+static bool canBeScanned(const FileResourceBase *file)
+{
+    if (file->fileType() != FileResourceBase::FileTypeArtifact)
+        return true;
+    const Artifact * const artifact = static_cast<const Artifact *>(file);
+    return artifact->artifactType == Artifact::SourceFile
+            || artifact->buildState == BuildGraphNode::Built;
 }
 
 InputArtifactScanner::InputArtifactScanner(Artifact *artifact, InputArtifactScannerContext *ctx,
@@ -120,6 +176,7 @@ InputArtifactScanner::InputArtifactScanner(Artifact *artifact, InputArtifactScan
       m_rawScanResults(artifact->product->topLevelProject()->buildData->rawScanResults),
       m_context(ctx),
       m_newDependencyAdded(false),
+      m_backgroundScanner(nullptr),
       m_logger(logger)
 {
 }
@@ -160,8 +217,23 @@ void InputArtifactScanner::scanForFileDependencies(Artifact *inputArtifact)
     const Set<DependencyScanner *> scanners = scannersForArtifact(inputArtifact);
     if (scanners.empty())
         return;
-    m_fileTagsForScanner
-            = inputArtifact->fileTags().toStringList().join(QLatin1Char(',')).toLatin1();
+    m_fileTagsForScanner = PluginDependencyScanner::fileTagsForScanner(inputArtifact->fileTags());
+
+    // Typically, many input artifacts include the same headers, so in the common case of just
+    // one scanner, we remember the transitive dependencies of all files.
+    if (scanners.size() == 1 && (*scanners.begin())->recursive()) {
+        DependencyScanner * const scanner = *scanners.begin();
+        const FileResourceListConstPtr closure
+                = dependencyClosure(scanner, inputArtifact, cacheItem[scanner->key()]);
+        for (FileResourceBase * const file : *closure) {
+            ResolvedDependency dependency;
+            dependency.file = file;
+            dependency.filePath = file->filePath();
+            handleDependency(dependency);
+        }
+        return;
+    }
+
     while (!filesToScan.empty()) {
         FileResourceBase *fileToBeScanned = filesToScan.takeFirst();
         const QString &filePathToBeScanned = fileToBeScanned->filePath();
@@ -175,6 +247,95 @@ void InputArtifactScanner::scanForFileDependencies(Artifact *inputArtifact)
     }
 }
 
+FileResourceListConstPtr InputArtifactScanner::dependencyClosure(DependencyScanner *scanner,
+        Artifact *inputArtifact,
+        InputArtifactScannerContext::ScannerResolvedDependenciesCache &cache)
+{
+    if (const FileResourceListConstPtr closure = cache.dependencyClosures.value(inputArtifact))
+        return closure;
+    ClosureComputation computation;
+    computation.scanner = scanner;
+    computation.inputArtifact = inputArtifact;
+    computation.cache = &cache;
+    visitForDependencyClosure(computation, inputArtifact);
+    return computation.closures.value(inputArtifact);
+}
+
+// Files that include each other share their transitive dependencies, so this is Tarjan's
+// algorithm for strongly connected components, collecting the dependencies of each
+// component once it is complete.
+void InputArtifactScanner::visitForDependencyClosure(ClosureComputation &computation,
+                                                     FileResourceBase *file)
+{
+    ClosureNode &node = computation.nodes[file];
+    node.index = node.lowLink = computation.nextIndex++;
+    node.onStack = true;
+    computation.stack.push_back(file);
+    node.scanned = scanForScannerFileDependencies(computation.scanner, computation.inputArtifact,
+            file, nullptr, *computation.cache, &node.directDependencies);
+
+    for (FileResourceBase * const dependency : node.directDependencies) {
+        if (!canBeScanned(dependency) || computation.cache->dependencyClosures.contains(dependency))
+            continue;
+        const auto it = computation.nodes.find(dependency);
+        if (it == computation.nodes.end()) {
+            visitForDependencyClosure(computation, dependency);
+            node.lowLink = std::min(node.lowLink, computation.nodes.at(dependency).lowLink);
+        } else if (it->second.onStack) {
+            node.lowLink = std::min(node.lowLink, it->second.index);
+        }
+    }
+
+    if (node.lowLink != node.index)
+        return;
+
+    Set<const FileResourceBase *> component;
+    const FileResourceBase *current;
+    do {
+        current = computation.stack.back();
+        computation.stack.pop_back();
+        computation.nodes.at(current).onStack = false;
+        component.insert(current);
+    } while (current != file);
+
+    bool complete = true;
+    FileResourceList closure;
+    for (const FileResourceBase * const member : component) {
+        const ClosureNode &node = computation.nodes.at(member);
+        if (!node.scanned)
+            complete = false;
+        for (FileResourceBase * const dependency : node.directDependencies) {
+            closure.push_back(dependency);
+            if (component.contains(dependency))
+                continue;
+            if (!canBeScanned(dependency)) {
+                complete = false;
+                continue;
+            }
+            FileResourceListConstPtr dependencyClosure
+                    = computation.cache->dependencyClosures.value(dependency);
+            if (!dependencyClosure) {
+                dependencyClosure = computation.closures.value(dependency);
+                QBS_CHECK(dependencyClosure);
+                if (computation.incompleteClosures.contains(dependency))
+                    complete = false;
+            }
+            closure.insert(closure.end(), dependencyClosure->cbegin(), dependencyClosure->cend());
+        }
+    }
+    std::sort(closure.begin(), closure.end());
+    closure.erase(std::unique(closure.begin(), closure.end()), closure.end());
+
+    const auto closureList = std::make_shared<const FileResourceList>(std::move(closure));
+    for (const FileResourceBase * const member : component) {
+        computation.closures.insert(member, closureList);
+        if (complete)
+            computation.cache->dependencyClosures.insert(member, closureList);
+        else
+            computation.incompleteClosures.insert(member);
+    }
+}
+
 Set<DependencyScanner *> InputArtifactScanner::scannersForArtifact(const Artifact *artifact) const
 {
     Set<DependencyScanner *> scanners;
@@ -204,10 +365,12 @@ Set<DependencyScanner *> InputArtifactScanner::scannersForArtifact(const Artifac
     return scanners;
 }
 
-void InputArtifactScanner::scanForScannerFileDependencies(DependencyScanner *scanner,
+// Returns false if the file is waiting for the background scanner.
+bool InputArtifactScanner::scanForScannerFileDependencies(DependencyScanner *scanner,
         Artifact *inputArtifact, FileResourceBase *fileToBeScanned,
         QList<FileResourceBase *> *filesToScan,
-        InputArtifactScannerContext::ScannerResolvedDependenciesCache &cache)
+        InputArtifactScannerContext::ScannerResolvedDependenciesCache &cache,
+        FileResourceList *resolvedFiles)
 {
     qCDebug(lcDepScan) << "file" << fileToBeScanned->filePath();
 
@@ -224,22 +387,59 @@ void InputArtifactScanner::scanForScannerFileDependencies(DependencyScanner *sca
     RawScanResults::ScanData &scanData = m_rawScanResults.findScanData(fileToBeScanned, scanner,
                                                                        m_artifact->properties);
     if (scanData.lastScanTime < fileToBeScanned->timestamp()) {
-        try {
-            qCDebug(lcDepScan) << "scanning" << FileInfo::fileName(filePathToBeScanned);
-            scanWithScannerPlugin(scanner, fileToBeScanned, &scanData.rawScanResult);
-            scanData.lastScanTime = FileTime::currentTime();
-        } catch (const ErrorInfo &error) {
-            m_logger.printWarning(error);
-            return;
+        if (ScannerPlugin * const plugin = scanner->scannerPlugin()) {
+            // In products with a QtMocScanner, artifacts are scanned with their own file tags
+            // and for additional file tags, so that the result can also serve the QtMocScanner.
+            const Artifact * const artifactToBeScanned
+                    = fileToBeScanned->fileType() == FileResourceBase::FileTypeArtifact
+                    ? static_cast<Artifact *>(fileToBeScanned) : nullptr;
+            const bool scanForFileTags = artifactToBeScanned
+                    && QtMocScanner::isUsedBy(artifactToBeScanned->product.get());
+            const QByteArray fileTagsForScanner = scanForFileTags
+                    ? PluginDependencyScanner::fileTagsForScanner(artifactToBeScanned->fileTags())
+                    : m_fileTagsForScanner;
+            if (m_backgroundScanner) {
+                PluginScanResult result;
+                if (!m_backgroundScanner->takeResult(plugin, filePathToBeScanned,
+                                                     fileToBeScanned->dirPath(),
+                                                     fileTagsForScanner, scanForFileTags,
+                                                     &result)) {
+                    qCDebug(lcDepScan) << "waiting for background scan of"
+                                       << FileInfo::fileName(filePathToBeScanned);
+                    m_pendingScans.emplace_back(plugin, filePathToBeScanned);
+                    return false;
+                }
+                qCDebug(lcDepScan) << "scanning" << FileInfo::fileName(filePathToBeScanned)
+                                   << "(in the background)";
+                scanData.update(result);
+            } else {
+                qCDebug(lcDepScan) << "scanning" << FileInfo::fileName(filePathToBeScanned);
+                scanData.update(PluginDependencyScanner::scan(plugin, filePathToBeScanned,
+                        fileToBeScanned->dirPath(), fileTagsForScanner, scanForFileTags));
+            }
+            m_rawScanResults.setModified(fileToBeScanned);
+        } else {
+            try {
+                qCDebug(lcDepScan) << "scanning" << FileInfo::fileName(filePathToBeScanned);
+                scanWithScannerPlugin(scanner, fileToBeScanned, &scanData.rawScanResult);
+                scanData.lastScanTime = FileTime::currentTime();
+                m_rawScanResults.setModified(fileToBeScanned);
+            } catch (const ErrorInfo &error) {
+                m_logger.printWarning(error);
+                return true;
+            }
         }
     }
 
-    resolveScanResultDependencies(inputArtifact, scanData.rawScanResult, filesToScan, cache);
+    resolveScanResultDependencies(inputArtifact, scanData.rawScanResult, filesToScan, cache,
+                                  resolvedFiles);
+    return true;
 }
 
 void InputArtifactScanner::resolveScanResultDependencies(const Artifact *inputArtifact,
         const RawScanResult &scanResult, QList<FileResourceBase *> *artifactsToScan,
-        InputArtifactScannerContext::ScannerResolvedDependenciesCache &cache)
+        InputArtifactScannerContext::ScannerResolvedDependenciesCache &cache,
+        FileResourceList *resolvedFiles)
 {
     for (const RawScannedDependency &dependency : scanResult.deps) {
         const QString &dependencyFilePath = dependency.filePath();
@@ -254,14 +454,15 @@ void InputArtifactScanner::resolveScanResultDependencies(const Artifact *inputAr
         cachedResolvedDependencyItem.valid = true;
 
         if (FileInfo::isAbsolute(dependencyFilePath)) {
-            resolveDepencency(dependency, inputArtifact->product.get(), &resolvedDependency);
+            resolveDepencency(dependency, inputArtifact->product.get(),
+                              m_context->directoryContents, &resolvedDependency);
             goto resolved;
         }
 
         // try include paths
         for (const QString &includePath : cache.searchPaths) {
             resolveDepencency(dependency, inputArtifact->product.get(),
-                              &resolvedDependency, includePath);
+                              m_context->directoryContents, &resolvedDependency, includePath);
             if (resolvedDependency.isValid())
                 goto resolved;
         }
@@ -272,20 +473,10 @@ unresolved:
 
 resolved:
         handleDependency(resolvedDependency);
-        if (artifactsToScan && resolvedDependency.file) {
-            if (resolvedDependency.file->fileType() == FileResourceBase::FileTypeArtifact) {
-                // Do not scan an artifact that is not built yet: Its contents might still change.
-                Artifact * const artifactDependency
-                        = static_cast<Artifact *>(resolvedDependency.file);
-                if (artifactDependency->artifactType == Artifact::SourceFile
-                        || artifactDependency->buildState == BuildGraphNode::Built) {
-                    artifactsToScan->push_back(artifactDependency);
-                }
-            } else {
-                // Add file dependency to the next round of scanning.
-                artifactsToScan->push_back(resolvedDependency.file);
-            }
-        }
+        if (resolvedFiles && resolvedDependency.file)
+            resolvedFiles->push_back(resolvedDependency.file);
+        if (artifactsToScan && resolvedDependency.file && canBeScanned(resolvedDependency.file))
+            artifactsToScan->push_back(resolvedDependency.file);
     }
 }
 
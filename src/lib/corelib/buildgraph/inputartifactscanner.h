@@ -40,14 +40,23 @@
 #ifndef QBS_INPUTARTIFACTSCANNER_H
 #define QBS_INPUTARTIFACTSCANNER_H
 
+#include "backgroundscanner.h"
+
 #include <language/filetags.h>
 #include <language/forward_decls.h>
 #include <logging/logger.h>
+#include <tools/qttools.h>
 #include <tools/set.h>
 
+#include <QtCore/qdatetime.h>
 #include <QtCore/qhash.h>
 #include <QtCore/qstringlist.h>
 
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
 class ScannerPlugin;
 
 namespace qbs {
@@ -71,8 +80,42 @@ public:
     FileResourceBase *file = nullptr;
 };
 
+typedef std::vector<FileResourceBase *> FileResourceList;
+typedef std::shared_ptr<const FileResourceList> FileResourceListConstPtr;
+
+// Listings of the directories that dependencies are looked up in. Include paths are probed
+// for every dependency, so answering from a listing saves one stat() call per probe.
+class DirectoryContentsCache
+{
+public:
+    // Directories do not count as existing files.
+    bool fileExists(const QString &dirPath, const QString &fileName);
+
+    // To be called when files might have been created or removed. Each listing is then
+    // checked against its directory's timestamp on its next use.
+    void invalidate() { ++m_generation; }
+
+private:
+    struct Listing
+    {
+        std::unordered_set<QString> fileNames;
+        QDateTime dirTimestamp;
+        int generation = -1;
+        bool caseSensitive = true;
+        bool timestampIsReliable = false;
+    };
+
+    QHash<QString, Listing> m_listings;
+    int m_generation = 0;
+};
+
 class InputArtifactScannerContext
 {
+public:
+    // Commands can create files that are not declared as their outputs.
+    void commandsFinished() { directoryContents.invalidate(); }
+
+private:
     struct ResolvedDependencyCacheItem
     {
         ResolvedDependencyCacheItem()
@@ -94,6 +137,10 @@ class InputArtifactScannerContext
         bool valid;
         QStringList searchPaths;
         ResolvedDependenciesCache resolvedDependenciesCache;
+
+        // The transitive dependencies of a file. Only complete closures are stored,
+        // that is, none that contain generated artifacts that were not built yet.
+        QHash<const FileResourceBase *, FileResourceListConstPtr> dependencyClosures;
     };
 
     struct DependencyScannerCacheItem
@@ -109,6 +156,7 @@ class InputArtifactScannerContext
 
     QHash<PropertyMapConstPtr, CacheItem> cache;
     QHash<ResolvedProduct*, QHash<FileTag, DependencyScannerCacheItem> > scannersCache;
+    DirectoryContentsCache directoryContents;
 
     friend class InputArtifactScanner;
 };
@@ -121,16 +169,48 @@ public:
     void scan();
     bool newDependencyAdded() const { return m_newDependencyAdded; }
 
+    // With a background scanner, files that need to be scanned by a scanner plugin are
+    // handed to it instead of being scanned right away. The scan is then incomplete,
+    // and pendingScans() lists what it is waiting for.
+    void setBackgroundScanner(BackgroundScanner *scanner) { m_backgroundScanner = scanner; }
+    const std::vector<BackgroundScanner::Key> &pendingScans() const { return m_pendingScans; }
+
 private:
+    struct ClosureNode
+    {
+        int index;
+        int lowLink;
+        bool onStack;
+        bool scanned;
+        FileResourceList directDependencies;
+    };
+
+    struct ClosureComputation
+    {
+        DependencyScanner *scanner;
+        Artifact *inputArtifact;
+        InputArtifactScannerContext::ScannerResolvedDependenciesCache *cache;
+        std::unordered_map<const FileResourceBase *, ClosureNode> nodes;
+        std::vector<FileResourceBase *> stack;
+        QHash<const FileResourceBase *, FileResourceListConstPtr> closures;
+        Set<const FileResourceBase *> incompleteClosures;
+        int nextIndex = 0;
+    };
+
     void scanForFileDependencies(Artifact *inputArtifact);
+    FileResourceListConstPtr dependencyClosure(DependencyScanner *scanner, Artifact *inputArtifact,
+            InputArtifactScannerContext::ScannerResolvedDependenciesCache &cache);
+    void visitForDependencyClosure(ClosureComputation &computation, FileResourceBase *file);
     Set<DependencyScanner *> scannersForArtifact(const Artifact *artifact) const;
-    void scanForScannerFileDependencies(DependencyScanner *scanner,
+    bool scanForScannerFileDependencies(DependencyScanner *scanner,
             Artifact *inputArtifact, FileResourceBase *fileToBeScanned,
             QList<FileResourceBase *> *filesToScan,
-            InputArtifactScannerContext::ScannerResolvedDependenciesCache &cache);
+            InputArtifactScannerContext::ScannerResolvedDependenciesCache &cache,
+            FileResourceList *resolvedFiles = nullptr);
     void resolveScanResultDependencies(const Artifact *inputArtifact,
             const RawScanResult &scanResult, QList<FileResourceBase *> *artifactsToScan,
-            InputArtifactScannerContext::ScannerResolvedDependenciesCache &cache);
+            InputArtifactScannerContext::ScannerResolvedDependenciesCache &cache,
+            FileResourceList *resolvedFiles);
     void handleDependency(ResolvedDependency &dependency);
     void scanWithScannerPlugin(DependencyScanner *scanner, FileResourceBase *fileToBeScanned,
                                RawScanResult *scanResult);
@@ -140,6 +220,8 @@ private:
     InputArtifactScannerContext *const m_context;
     QByteArray m_fileTagsForScanner;
     bool m_newDependencyAdded;
+    BackgroundScanner *m_backgroundScanner;
+    std::vector<BackgroundScanner::Key> m_pendingScans;
     Logger m_logger;
 };
 
@@ -0,0 +1,315 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "jobserver.h"
+
+#include <logging/categories.h>
+
+#include <QtCore/qcoreapplication.h>
+#include <QtCore/qdir.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qmetaobject.h>
+#include <QtCore/qsocketnotifier.h>
+#include <QtCore/qthread.h>
+
+#ifdef Q_OS_UNIX
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace qbs {
+namespace Internal {
+
+#ifdef Q_OS_UNIX
+static void closeFd(int fd)
+{
+    if (fd != -1)
+        ::close(fd);
+}
+#endif
+
+// The job slot pool is used from all executor threads, which come and go with the builds.
+// A socket notifier must only be touched from the thread it lives in, so it is put into the
+// main thread, which is around for as long as the pool. It is created and toggled via queued
+// calls.
+class JobServerNotifier : public QObject
+{
+    Q_OBJECT
+public:
+    JobServerNotifier(int fd, const std::function<void()> &callback)
+        : m_fd(fd), m_callback(callback)
+    {
+        if (QCoreApplication::instance())
+            moveToThread(QCoreApplication::instance()->thread());
+    }
+
+    Q_INVOKABLE void setEnabled(bool enabled)
+    {
+        if (!m_notifier) {
+            if (!enabled)
+                return;
+            m_notifier = new QSocketNotifier(m_fd, QSocketNotifier::Read, this);
+            connect(m_notifier, &QSocketNotifier::activated, this, [this] { m_callback(); });
+        }
+        m_notifier->setEnabled(enabled);
+    }
+
+private:
+    const int m_fd;
+    const std::function<void()> m_callback;
+    QSocketNotifier *m_notifier = nullptr;
+};
+
+JobServerClient::JobServerClient(int readFd, int writeFd, bool readFdBlocks)
+    : m_readFd(readFd), m_writeFd(writeFd), m_readFdBlocks(readFdBlocks)
+{
+}
+
+JobServerClient::~JobServerClient()
+{
+    if (m_notifier) {
+        if (m_notifier->thread() == QThread::currentThread())
+            delete m_notifier;
+        else
+            m_notifier->deleteLater();
+    }
+#ifdef Q_OS_UNIX
+    while (!m_tokens.empty())
+        releaseToken();
+    closeFd(m_readFd);
+    closeFd(m_writeFd);
+#endif
+}
+
+std::unique_ptr<JobServerClient> JobServerClient::fromEnvironment()
+{
+#ifdef Q_OS_UNIX
+    const QByteArray makeFlags = qgetenv("MAKEFLAGS");
+    QByteArray auth;
+    for (const QByteArray &flag : makeFlags.split(' ')) {
+        // Later flags override earlier ones. "--jobserver-fds" is used by GNU make < 4.2.
+        if (flag.startsWith("--jobserver-auth="))
+            auth = flag.mid(17);
+        else if (flag.startsWith("--jobserver-fds="))
+            auth = flag.mid(16);
+    }
+    if (auth.isEmpty())
+        return nullptr;
+    if (auth.startsWith("fifo:"))
+        return fromFifo(QFile::decodeName(auth.mid(5)));
+
+    const QList<QByteArray> fds = auth.split(',');
+    bool readFdOk = false;
+    bool writeFdOk = false;
+    const int inheritedReadFd = fds.size() == 2 ? fds.first().toInt(&readFdOk) : -1;
+    const int inheritedWriteFd = fds.size() == 2 ? fds.last().toInt(&writeFdOk) : -1;
+    if (!readFdOk || !writeFdOk || ::fcntl(inheritedReadFd, F_GETFD) == -1
+            || ::fcntl(inheritedWriteFd, F_GETFD) == -1) {
+        // This happens if make did not consider us a sub-make, e.g. due to a missing '+'.
+        qCDebug(lcExec) << "ignoring unusable jobserver file descriptors" << auth;
+        return nullptr;
+    }
+
+    // The read end must not block, but we cannot set O_NONBLOCK on the inherited descriptor,
+    // as that would affect all other processes sharing it.
+#ifdef Q_OS_LINUX
+    // Re-opening it via procfs gives us our own file description.
+    const QByteArray procPath = "/proc/self/fd/" + QByteArray::number(inheritedReadFd);
+    const int readFd = ::open(procPath.constData(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    const bool readFdBlocks = false;
+#else
+    // Elsewhere, there is no such way, so tryAcquireToken() has to poll before reading.
+    const int readFd = ::fcntl(inheritedReadFd, F_DUPFD_CLOEXEC, 0);
+    const bool readFdBlocks = true;
+#endif
+    if (readFd == -1) {
+        qCDebug(lcExec) << "cannot use inherited jobserver:" << qt_error_string(errno);
+        return nullptr;
+    }
+    const int writeFd = ::fcntl(inheritedWriteFd, F_DUPFD_CLOEXEC, 0);
+    if (writeFd == -1) {
+        closeFd(readFd);
+        return nullptr;
+    }
+    qCDebug(lcExec) << "using jobserver with file descriptors" << auth;
+    return std::unique_ptr<JobServerClient>(new JobServerClient(readFd, writeFd, readFdBlocks));
+#else
+    return nullptr;
+#endif
+}
+
+std::unique_ptr<JobServerClient> JobServerClient::fromFifo(const QString &fifoPath)
+{
+#ifdef Q_OS_UNIX
+    const QByteArray encodedPath = QFile::encodeName(fifoPath);
+    const int readFd = ::open(encodedPath.constData(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    if (readFd == -1) {
+        qCDebug(lcExec) << "cannot open jobserver fifo" << fifoPath << ":"
+                        << qt_error_string(errno);
+        return nullptr;
+    }
+    const int writeFd = ::open(encodedPath.constData(), O_WRONLY | O_CLOEXEC);
+    if (writeFd == -1) {
+        closeFd(readFd);
+        return nullptr;
+    }
+    qCDebug(lcExec) << "using jobserver with fifo" << fifoPath;
+    return std::unique_ptr<JobServerClient>(new JobServerClient(readFd, writeFd));
+#else
+    Q_UNUSED(fifoPath);
+    return nullptr;
+#endif
+}
+
+bool JobServerClient::tryAcquireToken()
+{
+#ifdef Q_OS_UNIX
+    if (m_readFdBlocks) {
+        // Another client can take the token between the poll and the read, in which case we
+        // block until the next token becomes available, which is still correct.
+        pollfd pfd = { m_readFd, POLLIN, 0 };
+        int ready;
+        do {
+            ready = ::poll(&pfd, 1, 0);
+        } while (ready == -1 && errno == EINTR);
+        if (ready != 1 || !(pfd.revents & POLLIN))
+            return false;
+    }
+    char token;
+    ssize_t bytesRead;
+    do {
+        bytesRead = ::read(m_readFd, &token, 1);
+    } while (bytesRead == -1 && errno == EINTR);
+    if (bytesRead != 1)
+        return false;
+    m_tokens.push_back(token);
+    return true;
+#else
+    return false;
+#endif
+}
+
+void JobServerClient::releaseToken()
+{
+    if (m_tokens.empty())
+        return;
+    const char token = m_tokens.back();
+    m_tokens.pop_back();
+#ifdef Q_OS_UNIX
+    while (::write(m_writeFd, &token, 1) == -1 && errno == EINTR)
+        ;
+#endif
+}
+
+void JobServerClient::setTokenAvailableCallback(const std::function<void()> &callback)
+{
+    m_tokenAvailableCallback = callback;
+}
+
+void JobServerClient::setWaitingForToken(bool waiting)
+{
+    if (waiting == m_waitingForToken)
+        return;
+    m_waitingForToken = waiting;
+    if (!m_notifier) {
+        if (!waiting)
+            return;
+        m_notifier = new JobServerNotifier(m_readFd, [this] {
+            if (m_tokenAvailableCallback)
+                m_tokenAvailableCallback();
+        });
+    }
+    QMetaObject::invokeMethod(m_notifier, "setEnabled", Qt::QueuedConnection,
+                              Q_ARG(bool, waiting));
+}
+
+JobServer::~JobServer()
+{
+#ifdef Q_OS_UNIX
+    closeFd(m_fd);
+    ::unlink(QFile::encodeName(m_fifoPath).constData());
+#endif
+}
+
+std::unique_ptr<JobServer> JobServer::create(int jobCount)
+{
+#ifdef Q_OS_UNIX
+    const QString fifoPath = QDir::temp().filePath(QString::fromLatin1("qbs-jobserver-%1")
+                                                   .arg(QCoreApplication::applicationPid()));
+    const QByteArray encodedPath = QFile::encodeName(fifoPath);
+    ::unlink(encodedPath.constData());
+    if (::mkfifo(encodedPath.constData(), 0600) == -1) {
+        qCDebug(lcExec) << "cannot create jobserver fifo" << fifoPath << ":"
+                        << qt_error_string(errno);
+        return nullptr;
+    }
+
+    // Opening for reading and writing keeps the fifo alive even when no client is attached.
+    const int fd = ::open(encodedPath.constData(), O_RDWR | O_NONBLOCK | O_CLOEXEC);
+    if (fd == -1) {
+        ::unlink(encodedPath.constData());
+        return nullptr;
+    }
+
+    // As with make, the first job does not need a token.
+    const QByteArray tokens(jobCount - 1, '+');
+    if (!tokens.isEmpty() && ::write(fd, tokens.constData(), tokens.size()) != tokens.size()) {
+        closeFd(fd);
+        ::unlink(encodedPath.constData());
+        return nullptr;
+    }
+    return std::unique_ptr<JobServer>(new JobServer(fifoPath, fd, jobCount));
+#else
+    Q_UNUSED(jobCount);
+    return nullptr;
+#endif
+}
+
+QString JobServer::makeFlags() const
+{
+    return QString::fromLatin1("-j%1 --jobserver-auth=fifo:%2").arg(m_jobCount).arg(m_fifoPath);
+}
+
+} // namespace Internal
+} // namespace qbs
+
+#include "jobserver.moc"
@@ -0,0 +1,113 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QBS_JOBSERVER_H
+#define QBS_JOBSERVER_H
+
+#include <tools/qbs_export.h>
+
+#include <QtCore/qbytearray.h>
+#include <QtCore/qstring.h>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace qbs {
+namespace Internal {
+class JobServerNotifier;
+
+// The client side of the GNU make jobserver protocol: Every job except the first one needs a
+// token, which is a byte read from the jobserver's pipe or fifo and has to be written back
+// once the job has finished. Only implemented on Unix.
+class QBS_AUTOTEST_EXPORT JobServerClient
+{
+public:
+    ~JobServerClient();
+
+    // Connects to the jobserver announced in the MAKEFLAGS environment variable, if there is one.
+    static std::unique_ptr<JobServerClient> fromEnvironment();
+    static std::unique_ptr<JobServerClient> fromFifo(const QString &fifoPath);
+
+    bool tryAcquireToken();
+    void releaseToken();
+    int tokenCount() const { return int(m_tokens.size()); }
+
+    // The callback gets invoked from the main thread's event loop when a token might be
+    // available. The read end is watched only while we are waiting for a token.
+    void setTokenAvailableCallback(const std::function<void()> &callback);
+    void setWaitingForToken(bool waiting);
+
+private:
+    JobServerClient(int readFd, int writeFd, bool readFdBlocks = false);
+
+    const int m_readFd;
+    const int m_writeFd;
+    const bool m_readFdBlocks;
+    std::vector<char> m_tokens;
+    JobServerNotifier *m_notifier = nullptr;
+    std::function<void()> m_tokenAvailableCallback;
+    bool m_waitingForToken = false;
+};
+
+// Provides tokens to child processes, which find it via the flags in makeFlags().
+// Uses a named fifo, which requires GNU make 4.4 or later on the client side.
+class QBS_AUTOTEST_EXPORT JobServer
+{
+public:
+    ~JobServer();
+
+    static std::unique_ptr<JobServer> create(int jobCount);
+
+    QString fifoPath() const { return m_fifoPath; }
+    QString makeFlags() const;
+
+private:
+    JobServer(const QString &fifoPath, int fd, int jobCount)
+        : m_fifoPath(fifoPath), m_fd(fd), m_jobCount(jobCount) { }
+
+    const QString m_fifoPath;
+    const int m_fd;
+    const int m_jobCount;
+};
+
+} // namespace Internal
+} // namespace qbs
+
+#endif // QBS_JOBSERVER_H
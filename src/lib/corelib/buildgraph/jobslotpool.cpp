@@ -0,0 +1,280 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "jobslotpool.h"
+
+#include "executor.h"
+#include "jobserver.h"
+
+#include <tools/qbsassert.h>
+
+#include <QtCore/qmetaobject.h>
+
+#include <algorithm>
+#include <utility>
+
+namespace qbs {
+namespace Internal {
+
+JobSlotPool &JobSlotPool::instance()
+{
+    static JobSlotPool pool;
+    return pool;
+}
+
+JobSlotPool::JobSlotPool() : m_jobServerClient(JobServerClient::fromEnvironment())
+{
+    setupJobServerClient();
+}
+
+JobSlotPool::~JobSlotPool()
+{
+    // The client must let go of the fifo before the server removes it.
+    m_jobServerClient.reset();
+}
+
+// Does nothing if we are a jobserver client already, as sub-makes then use the same
+// jobserver as we do.
+void JobSlotPool::startJobServer(int jobCount)
+{
+    std::lock_guard<std::mutex> locker(m_mutex);
+    if (m_jobServer || m_jobServerClient)
+        return;
+    m_jobServer = JobServer::create(jobCount);
+    if (!m_jobServer)
+        return;
+    m_jobServerClient = JobServerClient::fromFifo(m_jobServer->fifoPath());
+    if (!m_jobServerClient) {
+        m_jobServer.reset();
+        return;
+    }
+    setupJobServerClient();
+}
+
+QString JobSlotPool::makeFlags()
+{
+    std::lock_guard<std::mutex> locker(m_mutex);
+    return m_jobServer ? m_jobServer->makeFlags() : QString();
+}
+
+void JobSlotPool::registerExecutor(Executor *executor, int jobCount)
+{
+    std::vector<Executor *> executorsToNotify;
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        m_jobCounts[executor] = jobCount;
+        m_capacity = std::max(m_capacity, jobCount);
+        grantFreeSlots(executorsToNotify);
+    }
+    notify(executorsToNotify);
+}
+
+void JobSlotPool::unregisterExecutor(Executor *executor)
+{
+    std::vector<Executor *> executorsToNotify;
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        if (m_jobCounts.erase(executor) == 0)
+            return;
+        const auto grantedIt = m_grantedSlots.find(executor);
+        if (grantedIt != m_grantedSlots.end()) {
+            m_usedSlots -= grantedIt->second;
+            m_grantedSlots.erase(grantedIt);
+            returnSurplusTokens();
+        }
+        m_waitingExecutors.erase(std::remove(m_waitingExecutors.begin(),
+                                             m_waitingExecutors.end(), executor),
+                                 m_waitingExecutors.end());
+        for (auto it = m_executorsWaitingForJobPool.begin();
+             it != m_executorsWaitingForJobPool.end(); ++it) {
+            it.value().erase(std::remove(it.value().begin(), it.value().end(), executor),
+                             it.value().end());
+        }
+        m_capacity = 0;
+        for (const auto &jobCount : m_jobCounts)
+            m_capacity = std::max(m_capacity, jobCount.second);
+        grantFreeSlots(executorsToNotify);
+    }
+    notify(executorsToNotify);
+}
+
+// Returns false if no slot is free. The executor is then put into the waiting queue.
+bool JobSlotPool::acquire(Executor *executor)
+{
+    std::lock_guard<std::mutex> locker(m_mutex);
+    if (std::find(m_waitingExecutors.cbegin(), m_waitingExecutors.cend(), executor)
+            != m_waitingExecutors.cend()) {
+        return false;
+    }
+    if (m_usedSlots < m_capacity && m_waitingExecutors.empty() && obtainTokenForNewSlot()) {
+        ++m_usedSlots;
+        return true;
+    }
+    m_waitingExecutors.push_back(executor);
+    if (m_jobServerClient)
+        m_jobServerClient->setWaitingForToken(m_usedSlots < m_capacity);
+    return false;
+}
+
+// Transfers a slot that was granted to a waiting executor into its possession.
+bool JobSlotPool::takeGrantedSlot(Executor *executor)
+{
+    std::lock_guard<std::mutex> locker(m_mutex);
+    const auto it = m_grantedSlots.find(executor);
+    if (it == m_grantedSlots.end())
+        return false;
+    if (--it->second == 0)
+        m_grantedSlots.erase(it);
+    return true;
+}
+
+void JobSlotPool::release()
+{
+    std::vector<Executor *> executorsToNotify;
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        QBS_CHECK(m_usedSlots > 0);
+        --m_usedSlots;
+        grantFreeSlots(executorsToNotify);
+        returnSurplusTokens();
+    }
+    notify(executorsToNotify);
+}
+
+// Returns false if one of the pools has reached its limit. The executor is then notified
+// once that pool has room again.
+bool JobSlotPool::acquireJobPools(Executor *executor, const QStringList &pools,
+                                  const QHash<QString, int> &limits, QString *exhaustedPool)
+{
+    std::lock_guard<std::mutex> locker(m_mutex);
+    for (const QString &pool : pools) {
+        const int limit = limits.value(pool);
+        if (limit > 0 && m_jobPoolUsage.value(pool) >= limit) {
+            std::vector<Executor *> &waitingExecutors = m_executorsWaitingForJobPool[pool];
+            if (std::find(waitingExecutors.cbegin(), waitingExecutors.cend(), executor)
+                    == waitingExecutors.cend()) {
+                waitingExecutors.push_back(executor);
+            }
+            *exhaustedPool = pool;
+            return false;
+        }
+    }
+    for (const QString &pool : pools)
+        ++m_jobPoolUsage[pool];
+    return true;
+}
+
+// All executors waiting for one of the pools get notified. Those that do not get to use the
+// free slot put themselves back into the queue, so no wakeup can get lost.
+void JobSlotPool::releaseJobPools(const QStringList &pools)
+{
+    std::vector<std::pair<Executor *, QString>> executorsToNotify;
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        for (const QString &pool : pools) {
+            QBS_CHECK(m_jobPoolUsage.value(pool) > 0);
+            --m_jobPoolUsage[pool];
+            for (Executor * const executor : m_executorsWaitingForJobPool.take(pool))
+                executorsToNotify.push_back(std::make_pair(executor, pool));
+        }
+    }
+    for (const auto &executorAndPool : executorsToNotify) {
+        QMetaObject::invokeMethod(executorAndPool.first, "handleJobPoolSlotFreed",
+                                  Qt::QueuedConnection, Q_ARG(QString, executorAndPool.second));
+    }
+}
+
+void JobSlotPool::setupJobServerClient()
+{
+    if (m_jobServerClient)
+        m_jobServerClient->setTokenAvailableCallback([this] { handleTokenAvailable(); });
+}
+
+void JobSlotPool::handleTokenAvailable()
+{
+    std::vector<Executor *> executorsToNotify;
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        grantFreeSlots(executorsToNotify);
+        returnSurplusTokens();
+    }
+    notify(executorsToNotify);
+}
+
+// The first slot is implicitly ours, every further one needs a token.
+// Tokens of released slots are kept as long as they can be passed on to waiting executors.
+bool JobSlotPool::obtainTokenForNewSlot()
+{
+    if (!m_jobServerClient || m_usedSlots == 0 || m_jobServerClient->tokenCount() >= m_usedSlots)
+        return true;
+    return m_jobServerClient->tryAcquireToken();
+}
+
+void JobSlotPool::returnSurplusTokens()
+{
+    if (!m_jobServerClient)
+        return;
+    while (m_jobServerClient->tokenCount() > std::max(0, m_usedSlots - 1))
+        m_jobServerClient->releaseToken();
+}
+
+void JobSlotPool::grantFreeSlots(std::vector<Executor *> &executorsToNotify)
+{
+    while (m_usedSlots < m_capacity && !m_waitingExecutors.empty()
+           && obtainTokenForNewSlot()) {
+        Executor * const executor = m_waitingExecutors.front();
+        m_waitingExecutors.pop_front();
+        ++m_usedSlots;
+        ++m_grantedSlots[executor];
+        executorsToNotify.push_back(executor);
+    }
+    if (m_jobServerClient) {
+        m_jobServerClient->setWaitingForToken(!m_waitingExecutors.empty()
+                                              && m_usedSlots < m_capacity);
+    }
+}
+
+void JobSlotPool::notify(const std::vector<Executor *> &executors)
+{
+    for (Executor * const executor : executors)
+        QMetaObject::invokeMethod(executor, "handleJobSlotGranted", Qt::QueuedConnection);
+}
+
+} // namespace Internal
+} // namespace qbs
@@ -0,0 +1,115 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QBS_JOBSLOTPOOL_H
+#define QBS_JOBSLOTPOOL_H
+
+#include <QtCore/qhash.h>
+#include <QtCore/qstring.h>
+#include <QtCore/qstringlist.h>
+
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace qbs {
+namespace Internal {
+class Executor;
+class JobServer;
+class JobServerClient;
+
+// Limits the number of commands run concurrently by all executors in this process, so that
+// building several configurations at the same time does not overcommit the machine.
+// The capacity is the highest job count of all registered executors. Slots that become free
+// while executors are waiting get handed to them in order of arrival; they are notified via
+// a queued call to Executor::handleJobSlotGranted().
+// Job pools (see BuildOptions::jobLimits()) are accounted for here as well, so their limits
+// apply to all configurations together. An executor that finds a pool exhausted gets notified
+// via Executor::handleJobPoolSlotFreed() once one of the pool's commands has finished.
+// If qbs runs under a GNU make jobserver, every slot except the first one additionally
+// requires a token from that jobserver. Optionally, the pool can provide a jobserver itself,
+// so that sub-makes started by commands share the slots with qbs.
+class JobSlotPool
+{
+public:
+    static JobSlotPool &instance();
+
+    void startJobServer(int jobCount);
+    QString makeFlags();
+
+    void registerExecutor(Executor *executor, int jobCount);
+    void unregisterExecutor(Executor *executor);
+
+    bool acquire(Executor *executor);
+    bool takeGrantedSlot(Executor *executor);
+    void release();
+
+    bool acquireJobPools(Executor *executor, const QStringList &pools,
+                         const QHash<QString, int> &limits, QString *exhaustedPool);
+    void releaseJobPools(const QStringList &pools);
+
+private:
+    JobSlotPool();
+    ~JobSlotPool();
+
+    void setupJobServerClient();
+    void handleTokenAvailable();
+    bool obtainTokenForNewSlot();
+    void returnSurplusTokens();
+    void grantFreeSlots(std::vector<Executor *> &executorsToNotify);
+    static void notify(const std::vector<Executor *> &executors);
+
+    std::mutex m_mutex;
+    std::unordered_map<Executor *, int> m_jobCounts;
+    std::unordered_map<Executor *, int> m_grantedSlots;
+    std::deque<Executor *> m_waitingExecutors;
+    QHash<QString, int> m_jobPoolUsage;
+    QHash<QString, std::vector<Executor *>> m_executorsWaitingForJobPool;
+    std::unique_ptr<JobServer> m_jobServer;
+    std::unique_ptr<JobServerClient> m_jobServerClient;
+    int m_capacity = 0;
+    int m_usedSlots = 0;
+};
+
+} // namespace Internal
+} // namespace qbs
+
+#endif // QBS_JOBSLOTPOOL_H
@@ -40,6 +40,7 @@
 #include "processcommandexecutor.h"
 
 #include "artifact.h"
+#include "jobslotpool.h"
 #include "rulecommands.h"
 #include "transformer.h"
 
@@ -66,6 +67,8 @@
 
 #include <QtScript/qscriptvalue.h>
 
+#include <algorithm>
+
 namespace qbs {
 namespace Internal {
 
@@ -74,10 +77,18 @@ ProcessCommandExecutor::ProcessCommandExecutor(const Logger &logger, QObject *pa
 {
     connect(&m_process, static_cast<void (QbsProcess::*)(QProcess::ProcessError)>(&QbsProcess::error),
             this, &ProcessCommandExecutor::onProcessError);
+    connect(&m_process, &QbsProcess::readyReadStandardOutput, this, [this] {
+        onProcessOutput(QProcess::StandardOutput);
+    });
+    connect(&m_process, &QbsProcess::readyReadStandardError, this, [this] {
+        onProcessOutput(QProcess::StandardError);
+    });
     connect(&m_process, static_cast<void (QbsProcess::*)(int)>(&QbsProcess::finished),
             this, &ProcessCommandExecutor::onProcessFinished);
 }
 
+static const int maxRetainedOutputSize = 4 * 1024 * 1024; // Per channel.
+
 static QProcessEnvironment mergeEnvironments(const QProcessEnvironment &baseEnv,
                                              const QProcessEnvironment &additionalEnv)
 {
@@ -123,7 +134,15 @@ void ProcessCommandExecutor::doStart()
 
     const ProcessCommand * const cmd = processCommand();
 
-    m_process.setProcessEnvironment(m_commandEnvironment);
+    QProcessEnvironment processEnvironment = m_commandEnvironment;
+    const QString jobServerFlags = JobSlotPool::instance().makeFlags();
+    if (!jobServerFlags.isEmpty()) {
+        // Later flags win, so ours override any jobserver inherited from the environment.
+        const QString makeFlags = processEnvironment.value(QStringLiteral("MAKEFLAGS"));
+        processEnvironment.insert(QStringLiteral("MAKEFLAGS"), makeFlags.isEmpty()
+                                  ? jobServerFlags : makeFlags + QLatin1Char(' ') + jobServerFlags);
+    }
+    m_process.setProcessEnvironment(processEnvironment);
 
     QStringList arguments = m_arguments;
 
@@ -187,6 +206,11 @@ void ProcessCommandExecutor::doStart()
         }
     }
 
+    m_stdout = RetainedOutput();
+    m_stdout.unlimited = !cmd->stdoutFilePath().isEmpty() || !cmd->stdoutFilterFunction().isEmpty();
+    m_stderr = RetainedOutput();
+    m_stderr.unlimited = !cmd->stderrFilePath().isEmpty() || !cmd->stderrFilterFunction().isEmpty();
+
     qCDebug(lcExec) << "Running external process; full command line is:" << m_shellInvocation;
     const QProcessEnvironment &additionalVariables = cmd->environment();
     qCDebug(lcExec) << "Additional environment:" << additionalVariables.toStringList();
@@ -253,19 +277,81 @@ static QProcess::ProcessError saveToFile(const QString &filePath, const QByteArr
     return f.error() == QFileDevice::NoError ? QProcess::UnknownError : QProcess::WriteError;
 }
 
+void ProcessCommandExecutor::onProcessOutput(QProcess::ProcessChannel channel)
+{
+    const bool isStdOut = channel == QProcess::StandardOutput;
+    const QByteArray newData = isStdOut ? m_process.readAllStandardOutput()
+                                        : m_process.readAllStandardError();
+    if (newData.isEmpty())
+        return;
+    RetainedOutput &output = isStdOut ? m_stdout : m_stderr;
+    if (!output.unlimited) {
+        // Give live feedback for long-running commands. Only complete lines are forwarded,
+        // so that no line is split and no multi-byte character is torn apart.
+        const int lineEnd = newData.lastIndexOf('\n') + 1;
+        if (lineEnd == 0) {
+            output.incompleteLine += newData;
+        } else {
+            output.incompleteLine += newData.left(lineEnd);
+            forwardOutputLines(channel);
+            output.incompleteLine = newData.mid(lineEnd);
+        }
+    }
+    const int freeSpace = output.unlimited
+            ? newData.size() : std::max(0, maxRetainedOutputSize - output.data.size());
+    if (freeSpace >= newData.size()) {
+        output.data += newData;
+    } else {
+        output.data += newData.left(freeSpace);
+        output.discardedBytes += newData.size() - freeSpace;
+    }
+}
+
+void ProcessCommandExecutor::forwardOutputLines(QProcess::ProcessChannel channel)
+{
+    const bool isStdOut = channel == QProcess::StandardOutput;
+    RetainedOutput &output = isStdOut ? m_stdout : m_stderr;
+    QString text = QString::fromLocal8Bit(output.incompleteLine);
+    output.incompleteLine.clear();
+    if (text.endsWith(QLatin1Char('\n')))
+        text.chop(1);
+    const QStringList lines = text.split(QLatin1Char('\n'), QString::SkipEmptyParts);
+    if (lines.empty())
+        return;
+    if (logger().traceEnabled()) {
+        logger().qbsTrace() << QDir::toNativeSeparators(m_program) << ": "
+                            << lines.join(QLatin1Char('\n'));
+    }
+    ProcessResult partialResult;
+    partialResult.d->executableFilePath = m_program;
+    partialResult.d->arguments = m_arguments;
+    partialResult.d->workingDirectory = m_process.workingDirectory();
+    (isStdOut ? partialResult.d->stdOut : partialResult.d->stdErr) = lines;
+    emit reportProcessOutput(partialResult);
+}
+
 void ProcessCommandExecutor::getProcessOutput(bool stdOut, ProcessResult &result)
 {
-    QByteArray content;
+    const QProcess::ProcessChannel channel = stdOut ? QProcess::StandardOutput
+                                                    : QProcess::StandardError;
+    onProcessOutput(channel);
+    RetainedOutput &output = stdOut ? m_stdout : m_stderr;
+    if (!output.incompleteLine.isEmpty())
+        forwardOutputLines(channel);
+    QByteArray content = output.data;
+    if (output.discardedBytes > 0) {
+        content += Tr::tr("\n[%1 bytes of further output were discarded]")
+                .arg(output.discardedBytes).toLocal8Bit();
+    }
+    output = RetainedOutput();
     QString filterFunction;
     QString redirectPath;
     QStringList *target;
     if (stdOut) {
-        content = m_process.readAllStandardOutput();
         filterFunction = processCommand()->stdoutFilterFunction();
         redirectPath = processCommand()->stdoutFilePath();
         target = &result.d->stdOut;
     } else {
-        content = m_process.readAllStandardError();
         filterFunction = processCommand()->stderrFilterFunction();
         redirectPath = processCommand()->stderrFilePath();
         target = &result.d->stdErr;
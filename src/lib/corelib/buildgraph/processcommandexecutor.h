@@ -64,9 +64,11 @@ public:
 
 signals:
     void reportProcessResult(const qbs::ProcessResult &result);
+    void reportProcessOutput(const qbs::ProcessResult &partialResult);
 
 private:
     void onProcessError();
+    void onProcessOutput(QProcess::ProcessChannel channel);
     void onProcessFinished();
 
     void doSetup();
@@ -76,6 +78,7 @@ private:
 
     void startProcessCommand();
     QString filterProcessOutput(const QByteArray &output, const QString &filterFunctionSource);
+    void forwardOutputLines(QProcess::ProcessChannel channel);
     void getProcessOutput(bool stdOut, ProcessResult &result);
 
     void sendProcessOutput();
@@ -91,6 +94,18 @@ private:
     QProcessEnvironment m_buildEnvironment;
     QProcessEnvironment m_commandEnvironment;
     QString m_responseFileName;
+
+    // The output of a command is only retained up to a limit, unless it is needed in full
+    // for redirection or filtering. Otherwise, it is also forwarded line by line.
+    struct RetainedOutput
+    {
+        QByteArray data;
+        QByteArray incompleteLine;
+        qint64 discardedBytes = 0;
+        bool unlimited = false;
+    };
+    RetainedOutput m_stdout;
+    RetainedOutput m_stderr;
 };
 
 } // namespace Internal
@@ -81,7 +81,7 @@ public:
 
 
     Set<FileDependency *> fileDependencies;
-    RawScanResults rawScanResults;
+    RawScanResults rawScanResults; // Serialized via the head data of the PersistentPool.
 
     // do not serialize:
     RulesEvaluationContextPtr evaluationContext;
@@ -93,7 +93,7 @@ public:
 private:
     template<PersistentPool::OpType opType> void serializationOp(PersistentPool &pool)
     {
-        pool.serializationOp<opType>(fileDependencies, rawScanResults);
+        pool.serializationOp<opType>(fileDependencies);
     }
 
     typedef QHash<QString, QList<FileResourceBase *> > ResultsPerDirectory;
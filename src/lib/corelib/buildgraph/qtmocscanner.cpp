@@ -57,6 +57,8 @@
 #include <QtScript/qscriptcontext.h>
 #include <QtScript/qscriptengine.h>
 
+#include <algorithm>
+
 namespace qbs {
 namespace Internal {
 
@@ -73,27 +75,6 @@ struct CommonFileTags
 
 Q_GLOBAL_STATIC(CommonFileTags, commonFileTags)
 
-class QtScanner : public DependencyScanner
-{
-public:
-    QtScanner(const DependencyScanner &actualScanner)
-        : m_id(QStringLiteral("qt") + actualScanner.id()) {}
-
-private:
-    QStringList collectSearchPaths(Artifact *) override { return QStringList(); }
-    QStringList collectDependencies(FileResourceBase *, const char *) override { return QStringList(); }
-    bool recursive() const override { return false; }
-    const void *key() const override { return nullptr; }
-    QString createId() const override { return m_id; }
-    bool areModulePropertiesCompatible(const PropertyMapConstPtr &,
-                                       const PropertyMapConstPtr &) const override
-    {
-        return true;
-    }
-
-    const QString m_id;
-};
-
 static QString qtMocScannerJsName() { return QStringLiteral("QtMocScanner"); }
 
 QtMocScanner::QtMocScanner(const ResolvedProductPtr &product, QScriptValue targetScriptValue)
@@ -115,6 +96,18 @@ QtMocScanner::~QtMocScanner()
     m_targetScriptValue.setProperty(qtMocScannerJsName(), QScriptValue());
 }
 
+// The name of the rule that the QtMocScanner is created for.
+QString QtMocScanner::ruleName()
+{
+    return QStringLiteral("QtCoreMocRule");
+}
+
+bool QtMocScanner::isUsedBy(const ResolvedProduct *product)
+{
+    return std::any_of(product->rules.cbegin(), product->rules.cend(),
+                       [](const RulePtr &rule) { return rule->name == ruleName(); });
+}
+
 ScannerPlugin *QtMocScanner::scannerPluginForFileTags(const FileTags &ft)
 {
     if (ft.contains(m_tags.objcpp))
@@ -124,51 +117,27 @@ ScannerPlugin *QtMocScanner::scannerPluginForFileTags(const FileTags &ft)
     return m_hppScanner;
 }
 
+// The include scanner shares this scan data, so usually the file has already been scanned.
+// It must be scanned again if it was scanned as part of another file's dependencies, that is,
+// with different file tags, or without asking for file tags.
 static RawScanResult runScanner(ScannerPlugin *scanner, const Artifact *artifact)
 {
-    const QString &filepath = artifact->filePath();
-    QtScanner depScanner((PluginDependencyScanner(scanner)));
+    const PluginDependencyScanner depScanner(scanner);
     RawScanResults &rawScanResults
             = artifact->product->topLevelProject()->buildData->rawScanResults;
     RawScanResults::ScanData &scanData = rawScanResults.findScanData(artifact, &depScanner,
                                                                      artifact->properties);
-    if (scanData.lastScanTime < artifact->timestamp()) {
-        const QByteArray tagsForScanner
-                = artifact->fileTags().toStringList().join(QLatin1Char(',')).toLatin1();
-        void *opaq = scanner->open(filepath.utf16(), tagsForScanner.constData(),
-                                   ScanForDependenciesFlag | ScanForFileTagsFlag);
-        if (!opaq || !scanner->additionalFileTags)
-            return scanData.rawScanResult;
-
-        scanData.rawScanResult.additionalFileTags.clear();
-        scanData.rawScanResult.deps.clear();
-        int length = 0;
-        const char **szFileTagsFromScanner = scanner->additionalFileTags(opaq, &length);
-        if (szFileTagsFromScanner) {
-            for (int i = length; --i >= 0;)
-                scanData.rawScanResult.additionalFileTags += szFileTagsFromScanner[i];
-        }
-
-        QString baseDirOfInFilePath = artifact->dirPath();
-        forever {
-            int flags = 0;
-            const char *szOutFilePath = scanner->next(opaq, &length, &flags);
-            if (szOutFilePath == nullptr)
-                break;
-            QString includedFilePath = QString::fromLocal8Bit(szOutFilePath, length);
-            if (includedFilePath.isEmpty())
-                continue;
-            bool isLocalInclude = (flags & SC_LOCAL_INCLUDE_FLAG);
-            if (isLocalInclude) {
-                QString localFilePath = FileInfo::resolvePath(baseDirOfInFilePath, includedFilePath);
-                if (FileInfo::exists(localFilePath))
-                    includedFilePath = localFilePath;
-            }
-            scanData.rawScanResult.deps.push_back(RawScannedDependency(includedFilePath));
-        }
-
-        scanner->close(opaq);
-        scanData.lastScanTime = FileTime::currentTime();
+    const QByteArray fileTagsForScanner
+            = PluginDependencyScanner::fileTagsForScanner(artifact->fileTags());
+    if (scanData.lastScanTime < artifact->timestamp()
+            || scanData.fileTagsForScanner != fileTagsForScanner
+            || !scanData.scannedForFileTags) {
+        qCDebug(lcDepScan) << "scanning" << FileInfo::fileName(artifact->filePath())
+                           << "for moc";
+        scanData.update(PluginDependencyScanner::scan(scanner, artifact->filePath(),
+                                                      artifact->dirPath(), fileTagsForScanner,
+                                                      true));
+        rawScanResults.setModified(artifact);
     }
     return scanData.rawScanResult;
 }
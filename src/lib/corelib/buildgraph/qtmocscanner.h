@@ -65,6 +65,9 @@ public:
     explicit QtMocScanner(const ResolvedProductPtr &product, QScriptValue targetScriptValue);
     ~QtMocScanner();
 
+    static QString ruleName();
+    static bool isUsedBy(const ResolvedProduct *product);
+
 private:
     ScannerPlugin *scannerPluginForFileTags(const FileTags &ft);
     void findIncludedMocCppFiles();
@@ -42,6 +42,13 @@
 #include "filedependency.h"
 #include "depscanner.h"
 
+#include <logging/logger.h>
+#include <tools/error.h>
+#include <tools/parallelfor.h>
+
+#include <QtCore/qstringlist.h>
+
+#include <algorithm>
 #include <utility>
 
 namespace qbs {
@@ -65,8 +72,191 @@ RawScanResults::ScanData &RawScanResults::findScanData(
     newScanData.scannerId = scannerId;
     newScanData.moduleProperties = moduleProperties;
     scanDataForFile.push_back(std::move(newScanData));
+    setChunkModified(file->filePath());
     return scanDataForFile.back();
 }
 
+void RawScanResults::setModified(const FileResourceBase *file)
+{
+    setChunkModified(file->filePath());
+}
+
+void RawScanResults::setChunkModified(const QString &filePath)
+{
+    if (!m_storedChunks.empty())
+        m_modifiedChunks.at(chunkIndex(filePath)) = true;
+}
+
+int RawScanResults::chunkIndex(const QString &filePath) const
+{
+    return int(qHash(filePath) % uint(m_storedChunks.size()));
+}
+
+void RawScanResults::ScanData::update(const PluginScanResult &scanResult)
+{
+    lastScanTime = scanResult.scanTime;
+    fileTagsForScanner = scanResult.fileTagsForScanner;
+    scannedForFileTags = scanResult.scannedForFileTags;
+    rawScanResult.deps.clear();
+    for (const QString &dependency : scanResult.dependencies)
+        rawScanResult.deps.push_back(RawScannedDependency(dependency));
+    rawScanResult.additionalFileTags.clear();
+    for (const QByteArray &fileTag : scanResult.additionalFileTags)
+        rawScanResult.additionalFileTags += FileTag(fileTag);
+}
+
+// Has the same serialized layout as ScanData, but keeps the file tags as strings.
+struct RawScanResults::LoadedScanData
+{
+    RawScanResults::ScanData scanData;
+    QStringList additionalFileTags;
+
+    template<PersistentPool::OpType opType> void completeSerializationOp(PersistentPool &pool)
+    {
+        pool.serializationOp<opType>(scanData.scannerId, scanData.moduleProperties,
+                                     scanData.lastScanTime, scanData.fileTagsForScanner,
+                                     scanData.scannedForFileTags, scanData.rawScanResult.deps,
+                                     additionalFileTags);
+    }
+};
+
+static uint variantHash(const QVariant &value)
+{
+    switch (value.type()) {
+    case QVariant::Map: {
+        const QVariantMap map = value.toMap();
+        uint hash = uint(map.size());
+        for (auto it = map.cbegin(); it != map.cend(); ++it)
+            hash = hash * 31 + (qHash(it.key()) ^ variantHash(it.value()));
+        return hash;
+    }
+    case QVariant::List: {
+        uint hash = 0;
+        for (const QVariant &element : value.toList())
+            hash = hash * 31 + variantHash(element);
+        return hash;
+    }
+    case QVariant::StringList:
+        return qHash(value.toStringList());
+    default:
+        return qHash(value.toString()); // Good enough for the bool, number and string values.
+    }
+}
+
+// Each chunk has the same layout as a serialized QHash, so it can be loaded as one.
+QList<QByteArray> RawScanResults::storeChunks()
+{
+    // Changing the number of chunks moves most files to another chunk, so it is only done
+    // if the chunks have become much larger or smaller than intended.
+    static const int filesPerChunk = 1000;
+    const int idealChunkCount
+            = std::max(1, (m_rawScanData.size() + filesPerChunk - 1) / filesPerChunk);
+    const int chunkCount = m_storedChunks.size();
+    if (chunkCount == 0 || chunkCount > 2 * idealChunkCount || 2 * chunkCount < idealChunkCount) {
+        m_storedChunks.clear();
+        for (int i = 0; i < idealChunkCount; ++i)
+            m_storedChunks << QByteArray();
+        m_modifiedChunks.assign(idealChunkCount, true);
+    }
+
+    using FileIterator = QHash<QString, std::vector<ScanData>>::const_iterator;
+    std::vector<std::vector<FileIterator>> filesPerModifiedChunk(m_storedChunks.size());
+    for (auto it = m_rawScanData.cbegin(); it != m_rawScanData.cend(); ++it) {
+        const int index = chunkIndex(it.key());
+        if (m_modifiedChunks.at(index))
+            filesPerModifiedChunk.at(index).push_back(it);
+    }
+    for (int i = 0; i < m_storedChunks.size(); ++i) {
+        if (!m_modifiedChunks.at(i))
+            continue;
+        const std::vector<FileIterator> &files = filesPerModifiedChunk.at(i);
+        QByteArray chunk;
+        Logger logger;
+        PersistentPool pool(logger);
+        pool.setupWriteStream(&chunk);
+        pool.store(int(files.size()));
+        for (const FileIterator &it : files)
+            pool.store(it.key(), it.value());
+        pool.closeStream();
+        m_storedChunks[i] = chunk;
+        m_modifiedChunks.at(i) = false;
+    }
+    return m_storedChunks;
+}
+
+void RawScanResults::loadChunks(const QList<QByteArray> &chunks)
+{
+    std::vector<LoadedChunk> chunkData(chunks.size());
+    std::vector<ErrorInfo> errors(chunks.size());
+    parallelFor(chunks.size(), 0, [&](int i) {
+        try {
+            Logger logger;
+            PersistentPool pool(logger);
+            pool.setupReadStream(chunks.at(i));
+            pool.load(chunkData[i]);
+        } catch (const ErrorInfo &error) {
+            errors[i] = error;
+        }
+    });
+    for (const ErrorInfo &error : errors) {
+        if (error.hasError())
+            throw error;
+    }
+
+    // The chunks can be stored again as they are, unless the files were distributed
+    // differently, e.g. by an older version of the hash function.
+    m_storedChunks = chunks;
+    for (int i = 0; i < int(chunkData.size()) && !m_storedChunks.empty(); ++i) {
+        for (auto it = chunkData.at(i).cbegin(); it != chunkData.at(i).cend(); ++it) {
+            if (chunkIndex(it.key()) != i) {
+                m_storedChunks.clear();
+                break;
+            }
+        }
+    }
+    m_modifiedChunks.assign(m_storedChunks.size(), false);
+    m_loadedChunks = std::move(chunkData);
+}
+
+void RawScanResults::finishLoading(const std::vector<PropertyMapConstPtr> &moduleProperties)
+{
+    // Comparing the maps is expensive, so each decoded map is looked up only once.
+    // Within a chunk, equal maps are already shared.
+    QHash<uint, std::vector<PropertyMapConstPtr>> mapsByHash;
+    const auto canonicalMap = [&mapsByHash](const PropertyMapConstPtr &map) {
+        std::vector<PropertyMapConstPtr> &candidates
+                = mapsByHash[variantHash(QVariant(map->value()))];
+        for (const PropertyMapConstPtr &candidate : candidates) {
+            if (candidate == map || *candidate == *map)
+                return candidate;
+        }
+        candidates.push_back(map);
+        return map;
+    };
+    for (const PropertyMapConstPtr &map : moduleProperties)
+        canonicalMap(map);
+    QHash<const PropertyMapInternal *, PropertyMapConstPtr> replacements;
+
+    m_rawScanData.clear();
+    for (LoadedChunk &chunk : m_loadedChunks) {
+        for (auto it = chunk.begin(); it != chunk.end(); ++it) {
+            std::vector<ScanData> &scanDataForFile = m_rawScanData[it.key()];
+            for (LoadedScanData &loadedData : it.value()) {
+                ScanData &scanData = loadedData.scanData;
+                scanData.rawScanResult.additionalFileTags
+                        = FileTags::fromStringList(loadedData.additionalFileTags);
+                if (const PropertyMapConstPtr map = scanData.moduleProperties) {
+                    PropertyMapConstPtr &replacement = replacements[map.get()];
+                    if (!replacement)
+                        replacement = canonicalMap(map);
+                    scanData.moduleProperties = replacement;
+                }
+                scanDataForFile.push_back(std::move(scanData));
+            }
+        }
+    }
+    m_loadedChunks.clear();
+}
+
 } // namespace Internal
 } // namespace qbs
@@ -48,7 +48,9 @@
 #include <tools/filetime.h>
 #include <tools/persistence.h>
 
+#include <QtCore/qbytearray.h>
 #include <QtCore/qhash.h>
+#include <QtCore/qlist.h>
 #include <QtCore/qstring.h>
 
 #include <vector>
@@ -57,6 +59,7 @@ namespace qbs {
 namespace Internal {
 class DependencyScanner;
 class FileResourceBase;
+class PluginScanResult;
 
 class RawScanResult
 {
@@ -78,11 +81,19 @@ public:
         QString scannerId;
         PropertyMapConstPtr moduleProperties;
         FileTime lastScanTime;
+
+        // Plugins report additional file tags depending on the tags they were given,
+        // and only if they were asked to.
+        QByteArray fileTagsForScanner;
+        bool scannedForFileTags = false;
         RawScanResult rawScanResult;
 
+        void update(const PluginScanResult &scanResult);
+
         template<PersistentPool::OpType opType> void completeSerializationOp(PersistentPool &pool)
         {
-            pool.serializationOp<opType>(scannerId, moduleProperties, lastScanTime, rawScanResult);
+            pool.serializationOp<opType>(scannerId, moduleProperties, lastScanTime,
+                                         fileTagsForScanner, scannedForFileTags, rawScanResult);
         }
     };
 
@@ -91,13 +102,36 @@ public:
             const DependencyScanner *scanner,
             const PropertyMapConstPtr &moduleProperties);
 
-    template<PersistentPool::OpType opType> void completeSerializationOp(PersistentPool &pool)
-    {
-        pool.serializationOp<opType>(m_rawScanData);
-    }
+    // Must be called after updating the scan data of a file, so that its chunk gets serialized
+    // again. Forgetting it is harmless, though: The old scan data gets stored with its old
+    // scan time, so the file will just be scanned again next time.
+    void setModified(const FileResourceBase *file);
+
+    // The scan results do not point into the rest of the build graph (module properties are
+    // only compared by value), so they are serialized separately, in chunks that can be
+    // decoded in parallel with it.
+    // Decoding must not create any Ids, because the thread that decodes the rest of the
+    // build graph does so at the same time. Therefore, loadChunks() keeps the file tags as
+    // strings, and finishLoading() has to be called on the loading thread afterwards.
+    // It also replaces the module property maps decoded from the chunks with equal ones
+    // from the given list, so they are shared with the products again.
+    // Files are assigned to chunks by the hash of their path, and only the chunks with
+    // modified scan data are serialized again.
+    QList<QByteArray> storeChunks();
+    void loadChunks(const QList<QByteArray> &chunks);
+    void finishLoading(const std::vector<PropertyMapConstPtr> &moduleProperties);
 
 private:
+    struct LoadedScanData;
+    using LoadedChunk = QHash<QString, std::vector<LoadedScanData>>;
+
+    int chunkIndex(const QString &filePath) const;
+    void setChunkModified(const QString &filePath);
+
     QHash<QString, std::vector<ScanData>> m_rawScanData;
+    std::vector<LoadedChunk> m_loadedChunks;
+    QList<QByteArray> m_storedChunks; // As last stored or loaded.
+    std::vector<bool> m_modifiedChunks;
 };
 
 } // namespace Internal
@@ -65,7 +65,7 @@ class QBS_AUTOTEST_EXPORT RescuableArtifactData
 public:
     template<PersistentPool::OpType opType> void completeSerializationOp(PersistentPool &pool)
     {
-        pool.serializationOp<opType>(timeStamp, children, fileDependencies,
+        pool.serializationOp<opType>(timeStamp, contentHash, children, fileDependencies,
                                      propertiesRequestedInPrepareScript,
                                      propertiesRequestedInCommands,
                                      propertiesRequestedFromArtifactInPrepareScript,
@@ -75,7 +75,8 @@ public:
                                      commands, artifactsMapRequestedInPrepareScript,
                                      artifactsMapRequestedInCommands,
                                      lastPrepareScriptExecutionTime,
-                                     lastCommandExecutionTime, fileTags, properties);
+                                     lastCommandExecutionTime, lastCommandExecutionDuration,
+                                     fileTags, properties);
     }
 
     bool isValid() const { return !!properties; }
@@ -100,6 +101,7 @@ public:
     };
 
     FileTime timeStamp;
+    QByteArray contentHash;
     QList<ChildData> children;
     std::vector<QString> fileDependencies;
 
@@ -117,6 +119,7 @@ public:
     RequestedArtifacts artifactsMapRequestedInCommands;
     FileTime lastPrepareScriptExecutionTime;
     FileTime lastCommandExecutionTime;
+    qint64 lastCommandExecutionDuration = 0;
 
     // Only needed for API purposes
     FileTags fileTags;
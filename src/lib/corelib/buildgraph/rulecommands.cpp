@@ -58,6 +58,7 @@ static QString environmentProperty() { return QStringLiteral("environment"); }
 static QString extendedDescriptionProperty() { return QStringLiteral("extendedDescription"); }
 static QString highlightProperty() { return QStringLiteral("highlight"); }
 static QString ignoreDryRunProperty() { return QStringLiteral("ignoreDryRun"); }
+static QString jobPoolProperty() { return QStringLiteral("jobPool"); }
 static QString maxExitCodeProperty() { return QStringLiteral("maxExitCode"); }
 static QString programProperty() { return QStringLiteral("program"); }
 static QString responseFileArgumentIndexProperty()
@@ -88,7 +89,8 @@ AbstractCommand::AbstractCommand()
       m_extendedDescription(defaultExtendedDescription()),
       m_highlight(defaultHighLight()),
       m_ignoreDryRun(defaultIgnoreDryRun()),
-      m_silent(defaultIsSilent())
+      m_silent(defaultIsSilent()),
+      m_jobPool(defaultJobPool())
 {
 }
 
@@ -104,6 +106,7 @@ bool AbstractCommand::equals(const AbstractCommand *other) const
             && m_highlight == other->m_highlight
             && m_ignoreDryRun == other->m_ignoreDryRun
             && m_silent == other->m_silent
+            && m_jobPool == other->m_jobPool
             && m_properties == other->m_properties;
 }
 
@@ -114,6 +117,7 @@ void AbstractCommand::fillFromScriptValue(const QScriptValue *scriptValue, const
     m_highlight = scriptValue->property(highlightProperty()).toString();
     m_ignoreDryRun = scriptValue->property(ignoreDryRunProperty()).toBool();
     m_silent = scriptValue->property(silentProperty()).toBool();
+    m_jobPool = scriptValue->property(jobPoolProperty()).toString();
     m_codeLocation = codeLocation;
 
     m_predefinedProperties
@@ -121,6 +125,7 @@ void AbstractCommand::fillFromScriptValue(const QScriptValue *scriptValue, const
             << extendedDescriptionProperty()
             << highlightProperty()
             << ignoreDryRunProperty()
+            << jobPoolProperty()
             << silentProperty();
 }
 
@@ -164,6 +169,8 @@ static QScriptValue js_CommandBase(QScriptContext *context, QScriptEngine *engin
                     engine->toScriptValue(AbstractCommand::defaultIgnoreDryRun()));
     cmd.setProperty(silentProperty(),
                     engine->toScriptValue(AbstractCommand::defaultIsSilent()));
+    cmd.setProperty(jobPoolProperty(),
+                    engine->toScriptValue(AbstractCommand::defaultJobPool()));
     return cmd;
 }
 
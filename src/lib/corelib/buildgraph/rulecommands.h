@@ -70,6 +70,7 @@ public:
     static QString defaultHighLight() { return QString(); }
     static bool defaultIgnoreDryRun() { return false; }
     static bool defaultIsSilent() { return false; }
+    static QString defaultJobPool() { return QString(); }
 
     virtual CommandType type() const = 0;
     virtual bool equals(const AbstractCommand *other) const;
@@ -80,6 +81,7 @@ public:
     const QString highlight() const { return m_highlight; }
     bool ignoreDryRun() const { return m_ignoreDryRun; }
     bool isSilent() const { return m_silent; }
+    QString jobPool() const { return m_jobPool; }
     CodeLocation codeLocation() const { return m_codeLocation; }
 
     const QVariantMap &properties() const { return m_properties; }
@@ -97,7 +99,8 @@ private:
     template<PersistentPool::OpType opType> void serializationOp(PersistentPool &pool)
     {
         pool.serializationOp<opType>(m_description, m_extendedDescription, m_highlight,
-                                     m_ignoreDryRun, m_silent, m_codeLocation, m_properties);
+                                     m_ignoreDryRun, m_silent, m_jobPool, m_codeLocation,
+                                     m_properties);
     }
 
     QString m_description;
@@ -105,6 +108,7 @@ private:
     QString m_highlight;
     bool m_ignoreDryRun;
     bool m_silent;
+    QString m_jobPool;
     CodeLocation m_codeLocation;
     QVariantMap m_properties;
 };
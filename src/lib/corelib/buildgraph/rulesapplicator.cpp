@@ -104,7 +104,7 @@ void RulesApplicator::applyRule(const RuleConstPtr &rule, const ArtifactSet &inp
 
     m_rule = rule;
     m_completeInputSet = inputArtifacts;
-    if (rule->name == QLatin1String("QtCoreMocRule")) {
+    if (rule->name == QtMocScanner::ruleName()) {
         delete m_mocScanner;
         m_mocScanner = new QtMocScanner(m_product, scope());
     }
@@ -289,6 +289,7 @@ void Transformer::rescueChangeTrackingData(const TransformerConstPtr &other)
     artifactsMapRequestedInPrepareScript = other->artifactsMapRequestedInPrepareScript;
     artifactsMapRequestedInCommands = other->artifactsMapRequestedInCommands;
     lastCommandExecutionTime = other->lastCommandExecutionTime;
+    lastCommandExecutionDuration = other->lastCommandExecutionDuration;
     lastPrepareScriptExecutionTime = other->lastPrepareScriptExecutionTime;
     prepareScriptNeedsChangeTracking = other->prepareScriptNeedsChangeTracking;
     commandsNeedChangeTracking = other->commandsNeedChangeTracking;
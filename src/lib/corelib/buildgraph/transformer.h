@@ -83,6 +83,7 @@ public:
     RequestedArtifacts artifactsMapRequestedInCommands;
     FileTime lastPrepareScriptExecutionTime;
     FileTime lastCommandExecutionTime;
+    qint64 lastCommandExecutionDuration = 0; // In milliseconds. Used for job scheduling.
     bool alwaysRun;
     bool prepareScriptNeedsChangeTracking = false;
     bool commandsNeedChangeTracking = false;
@@ -110,7 +111,8 @@ public:
                                      commands, artifactsMapRequestedInPrepareScript,
                                      artifactsMapRequestedInCommands,
                                      lastPrepareScriptExecutionTime,
-                                     lastCommandExecutionTime, alwaysRun,
+                                     lastCommandExecutionTime, lastCommandExecutionDuration,
+                                     alwaysRun,
                                      prepareScriptNeedsChangeTracking, commandsNeedChangeTracking);
     }
 
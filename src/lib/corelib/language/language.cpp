@@ -72,6 +72,7 @@
 #include <algorithm>
 #include <memory>
 #include <mutex>
+#include <thread>
 
 namespace qbs {
 namespace Internal {
@@ -618,12 +619,17 @@ void ResolvedProject::store(PersistentPool &pool)
 
 
 TopLevelProject::TopLevelProject()
-    : bgLocker(nullptr), locked(false), lastResolveTime(FileTime::oldestTime())
+    : bgLocker(nullptr), locked(false), compressBuildGraph(false),
+      lastResolveTime(FileTime::oldestTime())
 {
 }
 
 TopLevelProject::~TopLevelProject()
 {
+    // Other processes must not get the lock before the build graph is complete.
+    // A write error is reported when the build graph is loaded or stored the next time.
+    if (bgLocker)
+        PersistentPool::finishBackgroundWrite(buildGraphFilePath());
     delete bgLocker;
 }
 
@@ -656,33 +662,88 @@ QString TopLevelProject::buildGraphFilePath() const
     return ProjectBuildData::deriveBuildGraphFilePath(buildDirectory, id());
 }
 
-void TopLevelProject::store(Logger logger)
+void TopLevelProject::store(Logger logger, bool inBackground, bool logSizes)
 {
     // TODO: Use progress observer here.
 
     if (!buildData)
         return;
+    const QString fileName = buildGraphFilePath();
+    const ErrorInfo writeError = PersistentPool::waitForBackgroundWrite(fileName);
+    if (writeError.hasError()) {
+        logger.printWarning(writeError);
+        buildData->isDirty = true; // The file still contains an older state.
+    }
     if (!buildData->isDirty) {
         qCDebug(lcBuildGraph) << "build graph is unchanged in project" << id();
         return;
     }
-    const QString fileName = buildGraphFilePath();
     qCDebug(lcBuildGraph) << "storing:" << fileName;
     PersistentPool pool(logger);
     PersistentPool::HeadData headData;
     headData.projectConfig = buildConfiguration();
+    headData.rawScanResults = buildData->rawScanResults.storeChunks();
     pool.setHeadData(headData);
-    pool.setupWriteStream(fileName);
+    PersistentPool::WriteOptions writeOptions = PersistentPool::NoWriteOptions;
+    if (inBackground)
+        writeOptions |= PersistentPool::WriteInBackground;
+    if (compressBuildGraph)
+        writeOptions |= PersistentPool::Compress;
+    pool.setupWriteStream(fileName, writeOptions);
     store(pool);
     pool.finalizeWriteStream();
+    if (logSizes) {
+        if (compressBuildGraph) {
+            logger.qbsLog(LoggerInfo, true) << "\t"
+                    << Tr::tr("Build graph size: %1 bytes, compressed to %2 bytes.")
+                       .arg(pool.uncompressedSize()).arg(pool.storedSize());
+        } else {
+            logger.qbsLog(LoggerInfo, true) << "\t"
+                    << Tr::tr("Build graph size: %1 bytes.").arg(pool.storedSize());
+        }
+    }
     buildData->isDirty = false;
 }
 
 void TopLevelProject::load(PersistentPool &pool)
 {
-    ResolvedProject::load(pool);
-    serializationOp<PersistentPool::Load>(pool);
+    RawScanResults rawScanResults;
+    ErrorInfo rawScanResultsError;
+    std::thread rawScanResultsLoader([&pool, &rawScanResults, &rawScanResultsError] {
+        try {
+            rawScanResults.loadChunks(pool.headData().rawScanResults);
+        } catch (const ErrorInfo &error) {
+            rawScanResultsError = error;
+        }
+    });
+    try {
+        ResolvedProject::load(pool);
+        serializationOp<PersistentPool::Load>(pool);
+    } catch (...) {
+        rawScanResultsLoader.join();
+        throw;
+    }
+    rawScanResultsLoader.join();
+    if (rawScanResultsError.hasError())
+        throw rawScanResultsError;
     QBS_CHECK(buildData);
+    std::vector<PropertyMapConstPtr> moduleProperties;
+    Set<const PropertyMapInternal *> seenModuleProperties;
+    const auto addModuleProperties = [&](const PropertyMapConstPtr &properties) {
+        if (properties && seenModuleProperties.insert(properties.get()).second)
+            moduleProperties.push_back(properties);
+    };
+    for (const ResolvedProductConstPtr &product : allProducts()) {
+        addModuleProperties(product->moduleProperties);
+        if (!product->buildData)
+            continue;
+        for (const Artifact * const artifact
+             : filterByType<Artifact>(product->buildData->allNodes())) {
+            addModuleProperties(artifact->properties);
+        }
+    }
+    rawScanResults.finishLoading(moduleProperties);
+    buildData->rawScanResults = std::move(rawScanResults);
     buildData->isDirty = false;
 }
 
@@ -619,6 +619,7 @@ public:
     std::unique_ptr<ProjectBuildData> buildData;
     BuildGraphLocker *bgLocker; // This holds the system-wide build graph file lock.
     bool locked; // This is the API-level lock for the project instance.
+    bool compressBuildGraph; // Not saved
 
     Set<QString> buildSystemFiles;
     FileTime lastResolveTime;
@@ -632,7 +633,7 @@ public:
     QVariantMap overriddenValues;
 
     QString buildGraphFilePath() const;
-    void store(Logger logger);
+    void store(Logger logger, bool inBackground = false, bool logSizes = false);
 
 private:
     TopLevelProject();
@@ -276,6 +276,9 @@ ModuleLoaderResult ModuleLoader::load(const SetupProjectParameters &parameters)
 {
     TimedActivityLogger moduleLoaderTimer(m_logger, Tr::tr("ModuleLoader"),
                                           parameters.logElapsedTime());
+    m_traceRecorder = TraceRecorder::instance(parameters.traceFilePath());
+    TraceSpan moduleLoaderSpan(m_traceRecorder, QLatin1String("resolve"),
+                               QLatin1String("ModuleLoader"));
     qCDebug(lcModuleLoader) << "load" << parameters.projectFilePath();
     m_parameters = parameters;
     m_modulePrototypeItemCache.clear();
@@ -563,6 +566,7 @@ void ModuleLoader::handleTopLevelProject(ModuleLoaderResult *loadResult, Item *p
     m_reader->clearExtraSearchPathsStack();
     AccumulatingTimer timer(m_parameters.logElapsedTime()
                             ? &m_elapsedTimePropertyChecking : nullptr);
+    TraceSpan span(m_traceRecorder, QLatin1String("resolve"), QLatin1String("property checking"));
     PropertyDeclarationCheck check(m_disabledItems, m_parameters, m_logger);
     check(projectItem);
 }
@@ -941,6 +945,8 @@ void ModuleLoader::prepareProduct(ProjectContext *projectContext, Item *productI
 {
     AccumulatingTimer timer(m_parameters.logElapsedTime()
                             ? &m_elapsedTimePrepareProducts : nullptr);
+    TraceSpan span(m_traceRecorder, QLatin1String("resolve"), QLatin1String("prepare product"));
+    span.addArg(QLatin1String("file"), productItem->file()->filePath());
     checkCancelation();
     qCDebug(lcModuleLoader) << "prepareProduct" << productItem->file()->filePath();
 
@@ -993,6 +999,9 @@ void ModuleLoader::setupProductDependencies(ProductContext *productContext)
 {
     AccumulatingTimer timer(m_parameters.logElapsedTime()
                             ? &m_elapsedTimeProductDependencies : nullptr);
+    TraceSpan span(m_traceRecorder, QLatin1String("resolve"),
+                   QLatin1String("set up product dependencies"));
+    span.addArg(QLatin1String("product"), productContext->name);
     checkCancelation();
     Item *item = productContext->item;
     qCDebug(lcModuleLoader) << "setupProductDependencies" << productContext->name
@@ -1084,6 +1093,8 @@ ModuleLoader::ModuleDependencies ModuleLoader::setupReverseModuleDependencies(co
 void ModuleLoader::handleProduct(ModuleLoader::ProductContext *productContext)
 {
     AccumulatingTimer timer(m_parameters.logElapsedTime() ? &m_elapsedTimeHandleProducts : nullptr);
+    TraceSpan span(m_traceRecorder, QLatin1String("resolve"), QLatin1String("handle product"));
+    span.addArg(QLatin1String("product"), productContext->name);
     if (productContext->info.delayedError.hasError())
         return;
 
@@ -3074,6 +3085,8 @@ void ModuleLoader::resolveProbe(ProductContext *productContext, Item *parent, It
     const QString &probeId = probeGlobalId(probe);
     if (Q_UNLIKELY(probeId.isEmpty()))
         throw ErrorInfo(Tr::tr("Probe.id must be set."), probe->location());
+    TraceSpan span(m_traceRecorder, QLatin1String("probe"), probeId);
+    span.addArg(QLatin1String("location"), [probe] { return probe->location().toString(); });
     const JSSourceValueConstPtr configureScript
             = probe->sourceProperty(StringConstants::configureProperty());
     QBS_CHECK(configureScript);
@@ -3122,6 +3135,7 @@ void ModuleLoader::resolveProbe(ProductContext *productContext, Item *parent, It
     } else if (!resolvedProbe) {
         ++m_probesRun;
         qCDebug(lcModuleLoader) << "configure script needs to run";
+        span.addArg(QLatin1String("configure script executed"), QStringLiteral("true"));
         const Evaluator::FileContextScopes fileCtxScopes
                 = m_evaluator->fileContextScopes(configureScript->file());
         engine->currentContext()->pushScope(fileCtxScopes.fileScope);
@@ -3375,6 +3389,9 @@ void ModuleLoader::addTransitiveDependencies(ProductContext *ctx)
 {
     AccumulatingTimer timer(m_parameters.logElapsedTime()
                             ? &m_elapsedTimeTransitiveDependencies : nullptr);
+    TraceSpan span(m_traceRecorder, QLatin1String("resolve"),
+                   QLatin1String("add transitive dependencies"));
+    span.addArg(QLatin1String("product"), ctx->name);
     qCDebug(lcModuleLoader) << "addTransitiveDependencies";
 
     std::vector<Item::Module> transitiveDeps = allModules(ctx->item);
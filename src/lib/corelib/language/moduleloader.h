@@ -72,6 +72,7 @@ class Item;
 class ItemReader;
 class ProgressObserver;
 class QualifiedId;
+class TraceRecorder;
 
 using ModulePropertiesPerGroup = std::unordered_map<const Item *, QualifiedIdSet>;
 
@@ -380,6 +381,7 @@ private:
     std::unique_ptr<Settings> m_settings;
     Version m_qbsVersion;
     Item *m_tempScopeItem = nullptr;
+    TraceRecorder *m_traceRecorder = nullptr;
 
     qint64 m_elapsedTimeProbes;
     qint64 m_elapsedTimePrepareProducts;
@@ -150,6 +150,9 @@ TopLevelProjectPtr ProjectResolver::resolve()
 {
     TimedActivityLogger projectResolverTimer(m_logger, Tr::tr("ProjectResolver"),
                                              m_setupParams.logElapsedTime());
+    m_traceRecorder = TraceRecorder::instance(m_setupParams.traceFilePath());
+    TraceSpan projectResolverSpan(m_traceRecorder, QLatin1String("resolve"),
+                                  QLatin1String("ProjectResolver"));
     qCDebug(lcProjectResolver) << "resolving" << m_loadResult.root->file()->filePath();
 
     m_productContext = nullptr;
@@ -257,6 +260,8 @@ TopLevelProjectPtr ProjectResolver::resolveTopLevelProject()
     resolveProductDependencies(projectContext);
     checkForDuplicateProductNames(project);
 
+    TraceSpan fileTaggingSpan(m_traceRecorder, QLatin1String("resolve"),
+                              QLatin1String("apply file taggers"));
     for (const ResolvedProductPtr &product : project->allProducts()) {
         if (!product->enabled)
             continue;
@@ -396,8 +401,10 @@ void ProjectResolver::resolveProduct(Item *item, ProjectContext *projectContext)
     productContext.product = product;
     product->location = item->location();
     ProductContextSwitcher contextSwitcher(this, &productContext, m_progressObserver);
+    TraceSpan span(m_traceRecorder, QLatin1String("resolve"), QLatin1String("resolve product"));
     try {
         resolveProductFully(item, projectContext);
+        span.addArg(QLatin1String("product"), product->name);
     } catch (const ErrorInfo &e) {
         QString mainErrorString = !product->name.isEmpty()
                 ? Tr::tr("Error while handling product '%1':").arg(product->name)
@@ -1186,6 +1193,9 @@ static DependencyMap allDependencies(const QList<ResolvedProductPtr> &products)
 
 void ProjectResolver::resolveProductDependencies(const ProjectContext &projectContext)
 {
+    TraceSpan span(m_traceRecorder, QLatin1String("resolve"),
+                   QLatin1String("resolve product dependencies"));
+
     // Resolve all inter-product dependencies.
     const QList<ResolvedProductPtr> allProducts = projectContext.project->allProducts();
     bool disabledDependency = false;
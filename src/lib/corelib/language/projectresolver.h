@@ -61,6 +61,7 @@ class Evaluator;
 class Item;
 class ProgressObserver;
 class ScriptEngine;
+class TraceRecorder;
 
 class ProjectResolver
 {
@@ -169,6 +170,7 @@ private:
     qint64 m_elapsedTimeModPropEval;
     qint64 m_elapsedTimeAllPropEval;
     qint64 m_elapsedTimeGroups;
+    TraceRecorder *m_traceRecorder = nullptr;
 
     typedef void (ProjectResolver::*ItemFuncPtr)(Item *item, ProjectContext *projectContext);
     typedef QMap<ItemType, ItemFuncPtr> ItemFuncMap;
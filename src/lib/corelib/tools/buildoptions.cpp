@@ -48,26 +48,37 @@ class BuildOptionsPrivate : public QSharedData
 {
 public:
     BuildOptionsPrivate()
-        : maxJobCount(0), dryRun(false), keepGoing(false), forceTimestampCheck(false),
-          forceOutputCheck(false),
+        : maxLoad(0), maxJobCount(0), minFreeMemory(0), processLauncherCount(0), dryRun(false),
+          keepGoing(false), forceTimestampCheck(false),
+          forceOutputCheck(false), detectUnchangedOutputs(false), provideJobServer(false),
           logElapsedTime(false), echoMode(defaultCommandEchoMode()), install(true),
-          removeExistingInstallation(false), onlyExecuteRules(false)
+          removeExistingInstallation(false), onlyExecuteRules(false),
+          storeBuildGraphInBackground(false)
     {
     }
 
     QStringList changedFiles;
     QStringList filesToConsider;
     QStringList activeFileTags;
+    QString actionCacheDirectory;
+    QString traceFilePath;
+    QHash<QString, int> jobLimits;
+    double maxLoad;
     int maxJobCount;
+    int minFreeMemory;
+    int processLauncherCount;
     bool dryRun;
     bool keepGoing;
     bool forceTimestampCheck;
     bool forceOutputCheck;
+    bool detectUnchangedOutputs;
+    bool provideJobServer;
     bool logElapsedTime;
     CommandEchoMode echoMode;
     bool install;
     bool removeExistingInstallation;
     bool onlyExecuteRules;
+    bool storeBuildGraphInBackground;
 };
 
 } // namespace Internal
@@ -188,6 +199,90 @@ void BuildOptions::setMaxJobCount(int jobCount)
     d->maxJobCount = jobCount;
 }
 
+/*!
+ * \brief Returns the maximum number of concurrently running commands per job pool.
+ * Commands declare the pool they belong to via their \c jobPool property. Pools without
+ * an entry here are limited only by \c maxJobCount.
+ * The default is an empty hash.
+ */
+QHash<QString, int> BuildOptions::jobLimits() const
+{
+    return d->jobLimits;
+}
+
+/*!
+ * \brief Sets the maximum number of concurrently running commands per job pool.
+ * Values <= 0 mean that the respective pool is not limited.
+ */
+void BuildOptions::setJobLimits(const QHash<QString, int> &jobLimits)
+{
+    d->jobLimits = jobLimits;
+}
+
+/*!
+ * \brief Returns the system load average above which no new jobs are started.
+ * As long as the load exceeds this value, qbs runs only the jobs that are already in progress;
+ * at least one job is always allowed to run. This only has an effect on platforms that report
+ * the load average, such as Linux and macOS.
+ * If the value is not valid (i.e. <= 0), the load is not taken into account.
+ * The default is 0.
+ */
+double BuildOptions::maxLoad() const
+{
+    return d->maxLoad;
+}
+
+/*!
+ * \brief Controls the system load average above which no new jobs are started.
+ * \sa BuildOptions::maxLoad()
+ */
+void BuildOptions::setMaxLoad(double maxLoad)
+{
+    d->maxLoad = maxLoad;
+}
+
+/*!
+ * \brief Returns the amount of available system memory in MiB below which no new jobs are started.
+ * As with maxLoad(), at least one job is always allowed to run. This only has an effect
+ * on Linux.
+ * If the value is not valid (i.e. <= 0), the available memory is not taken into account.
+ * The default is 0.
+ */
+int BuildOptions::minFreeMemory() const
+{
+    return d->minFreeMemory;
+}
+
+/*!
+ * \brief Controls the amount of available memory below which no new jobs are started.
+ * \sa BuildOptions::minFreeMemory()
+ */
+void BuildOptions::setMinFreeMemory(int megaBytes)
+{
+    d->minFreeMemory = megaBytes;
+}
+
+/*!
+ * \brief Returns the number of process launchers that run build commands.
+ * Each launcher is a helper process that starts commands on behalf of qbs. With many
+ * concurrent jobs, distributing the commands across several launchers reduces latency.
+ * If the value is not valid (i.e. <= 0), it will be derived from the job count at build time.
+ * The default is 0.
+ */
+int BuildOptions::processLauncherCount() const
+{
+    return d->processLauncherCount;
+}
+
+/*!
+ * \brief Controls how many process launchers are used for running build commands.
+ * A value <= 0 leaves the decision to qbs.
+ */
+void BuildOptions::setProcessLauncherCount(int launcherCount)
+{
+    d->processLauncherCount = launcherCount;
+}
+
 /*!
  * \brief Returns true iff qbs will not actually execute any commands, but just show what
  *        would happen.
@@ -269,6 +364,87 @@ void BuildOptions::setForceOutputCheck(bool enabled)
     d->forceOutputCheck = enabled;
 }
 
+/*!
+ * \brief Returns true if qbs will compare the contents of re-generated artifacts with
+ * their previous contents.
+ * The default is \c false.
+ */
+bool BuildOptions::detectUnchangedOutputs() const
+{
+    return d->detectUnchangedOutputs;
+}
+
+/*!
+ * \brief Controls whether qbs should record a hash of the contents of generated artifacts.
+ * If this is enabled and the commands of a rule are re-run, but produce artifacts with the
+ * same contents as before, then artifacts depending on them are not rebuilt.
+ * Enabling this introduces some I/O overhead for every generated artifact.
+ */
+void BuildOptions::setDetectUnchangedOutputs(bool enabled)
+{
+    d->detectUnchangedOutputs = enabled;
+}
+
+/*!
+ * \brief Returns true if qbs will act as a GNU make jobserver for the commands it runs.
+ * The default is \c false.
+ */
+bool BuildOptions::provideJobServer() const
+{
+    return d->provideJobServer;
+}
+
+/*!
+ * \brief Controls whether qbs should act as a GNU make jobserver for the commands it runs.
+ * If this is enabled, instances of make started by commands share the job slots with qbs,
+ * provided they support named fifos as jobserver (GNU make 4.4 and later).
+ * If qbs itself runs under a jobserver, that one is used instead. This is supported on Unix only.
+ */
+void BuildOptions::setProvideJobServer(bool provide)
+{
+    d->provideJobServer = provide;
+}
+
+/*!
+ * \brief Returns the directory in which the outputs of commands are cached.
+ * The default is an empty string, which means no caching takes place.
+ */
+QString BuildOptions::actionCacheDirectory() const
+{
+    return d->actionCacheDirectory;
+}
+
+/*!
+ * \brief Sets the directory in which the outputs of commands are cached.
+ * If this is non-empty, the output artifacts of rules that run only processes are copied into
+ * the directory, keyed on the command lines, the relevant environment and the contents of all
+ * input files. A later build, possibly in a different build directory, that would run the same
+ * commands on the same inputs then copies the artifacts from there instead.
+ */
+void BuildOptions::setActionCacheDirectory(const QString &directory)
+{
+    d->actionCacheDirectory = directory;
+}
+
+/*!
+ * \brief Returns the file that a timeline of the build is written to.
+ */
+QString BuildOptions::traceFilePath() const
+{
+    return d->traceFilePath;
+}
+
+/*!
+ * \brief Sets the file that a timeline of the build is written to.
+ * The file is in the Chrome trace event format and contains one event per rule execution,
+ * dependency scan and command, with commands being assigned to the job slot running them.
+ * The default is an empty string, which means that no trace is recorded.
+ */
+void BuildOptions::setTraceFilePath(const QString &traceFilePath)
+{
+    d->traceFilePath = traceFilePath;
+}
+
 /*!
  * \brief Returns true iff the time the operation takes will be logged.
  * The default is \c false.
@@ -359,6 +535,30 @@ void BuildOptions::setExecuteRulesOnly(bool onlyRules)
     d->onlyExecuteRules = onlyRules;
 }
 
+/*!
+ * \brief Returns true if the build graph is written to disk on a separate thread.
+ * The default is \c false.
+ */
+bool BuildOptions::storeBuildGraphInBackground() const
+{
+    return d->storeBuildGraphInBackground;
+}
+
+/*!
+ * If \a inBackground is \c true, the build job finishes as soon as the build graph has been
+ * serialized, and the data is written to disk on a separate thread. This only lets the write
+ * overlap with whatever the caller does next: Later attempts to load or store the same build
+ * graph wait for that thread, and so does the destruction of the project, which releases the
+ * build graph lock. Therefore, a process does not finish earlier because of this option.
+ * If the write fails, the previous build graph file stays in place, and a warning is
+ * printed the next time the build graph is loaded or stored in the same process.
+ * \note The build graph file might not exist yet when the job finishes.
+ */
+void BuildOptions::setStoreBuildGraphInBackground(bool inBackground)
+{
+    d->storeBuildGraphInBackground = inBackground;
+}
+
 
 bool operator==(const BuildOptions &bo1, const BuildOptions &bo2)
 {
@@ -368,8 +568,13 @@ bool operator==(const BuildOptions &bo1, const BuildOptions &bo2)
             && bo1.logElapsedTime() == bo2.logElapsedTime()
             && bo1.echoMode() == bo2.echoMode()
             && bo1.maxJobCount() == bo2.maxJobCount()
+            && bo1.jobLimits() == bo2.jobLimits()
+            && bo1.maxLoad() == bo2.maxLoad()
+            && bo1.minFreeMemory() == bo2.minFreeMemory()
+            && bo1.processLauncherCount() == bo2.processLauncherCount()
             && bo1.install() == bo2.install()
-            && bo1.removeExistingInstallation() == bo2.removeExistingInstallation();
+            && bo1.removeExistingInstallation() == bo2.removeExistingInstallation()
+            && bo1.storeBuildGraphInBackground() == bo2.storeBuildGraphInBackground();
 }
 
 } // namespace qbs
@@ -43,9 +43,11 @@
 
 #include "commandechomode.h"
 
+#include <QtCore/qhash.h>
 #include <QtCore/qshareddata.h>
 
 QT_BEGIN_NAMESPACE
+class QString;
 class QStringList;
 QT_END_NAMESPACE
 
@@ -73,6 +75,18 @@ public:
     int maxJobCount() const;
     void setMaxJobCount(int jobCount);
 
+    QHash<QString, int> jobLimits() const;
+    void setJobLimits(const QHash<QString, int> &jobLimits);
+
+    double maxLoad() const;
+    void setMaxLoad(double maxLoad);
+
+    int minFreeMemory() const;
+    void setMinFreeMemory(int megaBytes);
+
+    int processLauncherCount() const;
+    void setProcessLauncherCount(int launcherCount);
+
     bool dryRun() const;
     void setDryRun(bool dryRun);
 
@@ -85,9 +99,21 @@ public:
     bool forceOutputCheck() const;
     void setForceOutputCheck(bool enabled);
 
+    bool detectUnchangedOutputs() const;
+    void setDetectUnchangedOutputs(bool enabled);
+
+    bool provideJobServer() const;
+    void setProvideJobServer(bool provide);
+
+    QString actionCacheDirectory() const;
+    void setActionCacheDirectory(const QString &directory);
+
     bool logElapsedTime() const;
     void setLogElapsedTime(bool log);
 
+    QString traceFilePath() const;
+    void setTraceFilePath(const QString &traceFilePath);
+
     CommandEchoMode echoMode() const;
     void setEchoMode(CommandEchoMode echoMode);
 
@@ -100,6 +126,9 @@ public:
     bool executeRulesOnly() const;
     void setExecuteRulesOnly(bool onlyRules);
 
+    bool storeBuildGraphInBackground() const;
+    void setStoreBuildGraphInBackground(bool inBackground);
+
 private:
     QSharedDataPointer<Internal::BuildOptionsPrivate> d;
 };
@@ -44,8 +44,10 @@
 #include <tools/stringconstants.h>
 
 #include <QtCore/qcoreapplication.h>
+#include <QtCore/qcryptographichash.h>
 #include <QtCore/qdatetime.h>
 #include <QtCore/qdir.h>
+#include <QtCore/qfile.h>
 #include <QtCore/qfileinfo.h>
 #include <QtCore/qregexp.h>
 
@@ -273,6 +275,18 @@ bool FileInfo::fileExists(const QFileInfo &fi)
     return fi.isSymLink() || fi.exists();
 }
 
+// Returns an empty byte array if the file cannot be read.
+QByteArray FileInfo::contentHash(const QString &filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly))
+        return QByteArray();
+    QCryptographicHash hash(QCryptographicHash::Md5);
+    if (!hash.addData(&file))
+        return QByteArray();
+    return hash.result();
+}
+
 #if defined(Q_OS_WIN)
 
 #define z(x) reinterpret_cast<WIN32_FILE_ATTRIBUTE_DATA*>(const_cast<FileInfo::InternalStatType*>(&x))
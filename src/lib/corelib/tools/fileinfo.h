@@ -79,6 +79,7 @@ public:
                                HostOsInfo::HostOs hostOs = HostOsInfo::hostOs());
     static bool globMatches(const QRegExp &pattern, const QString &subject);
     static bool isFileCaseCorrect(const QString &filePath);
+    static QByteArray contentHash(const QString &filePath);
 
     // Symlink-correct check.
     static bool fileExists(const QFileInfo &fi);
@@ -50,6 +50,9 @@
 #include <QtCore/qdir.h>
 #include <QtCore/qprocess.h>
 #include <QtNetwork/qlocalserver.h>
+#include <QtNetwork/qlocalsocket.h>
+
+#include <algorithm>
 
 #ifdef Q_OS_UNIX
 #include <unistd.h>
@@ -80,7 +83,7 @@ static QString launcherSocketName()
 }
 
 LauncherInterface::LauncherInterface()
-    : m_server(new QLocalServer(this)), m_socket(new LauncherSocket(this))
+    : m_server(new QLocalServer(this)), m_sockets(1, new LauncherSocket(this)), m_nextSocket(0)
 {
     QObject::connect(m_server, &QLocalServer::newConnection,
                      this, &LauncherInterface::handleNewConnection);
@@ -97,28 +100,35 @@ LauncherInterface::~LauncherInterface()
     m_server->disconnect();
 }
 
-void LauncherInterface::doStart()
+void LauncherInterface::doStart(int launcherCount)
 {
     if (++m_startRequests > 1)
         return;
+    m_launcherCount = std::max(1, launcherCount);
+    while (int(m_sockets.size()) < m_launcherCount)
+        m_sockets.push_back(new LauncherSocket(this));
+    m_nextSocket = 0;
     const QString &socketName = launcherSocketName();
     QLocalServer::removeServer(socketName);
+    m_server->setMaxPendingConnections(m_launcherCount);
     if (!m_server->listen(socketName)) {
         emit errorOccurred(ErrorInfo(m_server->errorString()));
         return;
     }
-    m_process = new LauncherProcess(this);
-    connect(m_process,
-            static_cast<void (QProcess::*)(QProcess::ProcessError)>(&QProcess::error),
-            this, &LauncherInterface::handleProcessError);
-    connect(m_process, static_cast<void (QProcess::*)(int)>(&QProcess::finished),
-            this, &LauncherInterface::handleProcessFinished);
-    connect(m_process, &QProcess::readyReadStandardError,
-            this, &LauncherInterface::handleProcessStderr);
-    m_process->start(qApp->applicationDirPath() + QLatin1Char('/')
-                            + QLatin1String(QBS_RELATIVE_LIBEXEC_PATH)
-                            + QLatin1String("/qbs_processlauncher"),
-                           QStringList(m_server->fullServerName()));
+    const QString launcherFilePath = qApp->applicationDirPath() + QLatin1Char('/')
+            + QLatin1String(QBS_RELATIVE_LIBEXEC_PATH) + QLatin1String("/qbs_processlauncher");
+    for (int i = 0; i < m_launcherCount; ++i) {
+        const auto process = new LauncherProcess(this);
+        m_processes.push_back(process);
+        connect(process,
+                static_cast<void (QProcess::*)(QProcess::ProcessError)>(&QProcess::error),
+                this, [this, process] { handleProcessError(process); });
+        connect(process, static_cast<void (QProcess::*)(int)>(&QProcess::finished),
+                this, [this, process] { handleProcessFinished(process); });
+        connect(process, &QProcess::readyReadStandardError,
+                this, [this, process] { handleProcessStderr(process); });
+        process->start(launcherFilePath, QStringList(m_server->fullServerName()));
+    }
 }
 
 void LauncherInterface::doStop()
@@ -126,44 +136,63 @@ void LauncherInterface::doStop()
     if (--m_startRequests > 0)
         return;
     m_server->close();
-    if (!m_process)
-        return;
-    m_process->disconnect();
-    if (m_socket->isReady())
-        m_socket->shutdown();
-    m_process->waitForFinished(3000);
-    m_process->deleteLater();
-    m_process = nullptr;
+    for (LauncherProcess * const process : m_processes)
+        process->disconnect();
+    for (LauncherSocket * const socket : m_sockets) {
+        if (socket->isReady())
+            socket->shutdown();
+    }
+    for (LauncherProcess * const process : m_processes) {
+        process->waitForFinished(3000);
+        process->deleteLater();
+    }
+    m_processes.clear();
+}
+
+LauncherSocket *LauncherInterface::nextSocket()
+{
+    return m_sockets.at(m_nextSocket++ % static_cast<unsigned int>(m_launcherCount));
 }
 
 void LauncherInterface::handleNewConnection()
 {
-    QLocalSocket * const socket = m_server->nextPendingConnection();
-    if (!socket)
-        return;
-    m_server->close();
-    m_socket->setSocket(socket);
+    // The launchers are interchangeable, so we do not care which one a connection belongs to.
+    while (QLocalSocket * const socket = m_server->nextPendingConnection()) {
+        const auto end = m_sockets.begin() + m_launcherCount;
+        const auto it = std::find_if(m_sockets.begin(), end,
+                                     [](const LauncherSocket *s) { return !s->isReady(); });
+        if (it == end) {
+            qDebug() << "[launcher] unexpected connection";
+            socket->deleteLater();
+            continue;
+        }
+        (*it)->setSocket(socket);
+        if (std::none_of(m_sockets.begin(), end,
+                         [](const LauncherSocket *s) { return !s->isReady(); })) {
+            m_server->close();
+        }
+    }
 }
 
-void LauncherInterface::handleProcessError()
+void LauncherInterface::handleProcessError(LauncherProcess *process)
 {
-    if (m_process->error() == QProcess::FailedToStart) {
+    if (process->error() == QProcess::FailedToStart) {
         const QString launcherPathForUser
-                = QDir::toNativeSeparators(QDir::cleanPath(m_process->program()));
+                = QDir::toNativeSeparators(QDir::cleanPath(process->program()));
         emit errorOccurred(ErrorInfo(Tr::tr("Failed to start process launcher at '%1': %2")
-                                     .arg(launcherPathForUser, m_process->errorString())));
+                                     .arg(launcherPathForUser, process->errorString())));
     }
 }
 
-void LauncherInterface::handleProcessFinished()
+void LauncherInterface::handleProcessFinished(LauncherProcess *process)
 {
     emit errorOccurred(ErrorInfo(Tr::tr("Process launcher closed unexpectedly: %1")
-                                 .arg(m_process->errorString())));
+                                 .arg(process->errorString())));
 }
 
-void LauncherInterface::handleProcessStderr()
+void LauncherInterface::handleProcessStderr(LauncherProcess *process)
 {
-    qDebug() << "[launcher]" << m_process->readAllStandardError();
+    qDebug() << "[launcher]" << process->readAllStandardError();
 }
 
 } // namespace Internal
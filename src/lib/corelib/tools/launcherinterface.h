@@ -40,8 +40,13 @@
 #ifndef QBS_LAUNCHERINTERFACE_H
 #define QBS_LAUNCHERINTERFACE_H
 
+#include "qbs_export.h"
+
 #include <QtCore/qobject.h>
 
+#include <atomic>
+#include <vector>
+
 QT_BEGIN_NAMESPACE
 class QLocalServer;
 QT_END_NAMESPACE
@@ -52,16 +57,18 @@ namespace Internal {
 class LauncherProcess;
 class LauncherSocket;
 
-class LauncherInterface : public QObject
+class QBS_AUTOTEST_EXPORT LauncherInterface : public QObject
 {
     Q_OBJECT
 public:
     static LauncherInterface &instance();
     ~LauncherInterface();
 
-    static void startLauncher() { instance().doStart(); }
+    static void startLauncher(int launcherCount = 1) { instance().doStart(launcherCount); }
     static void stopLauncher() { instance().doStop(); }
-    static LauncherSocket *socket() { return instance().m_socket; }
+
+    // Successive calls hand out the sockets of the different launchers in turn.
+    static LauncherSocket *socket() { return instance().nextSocket(); }
 
 signals:
     void errorOccurred(const ErrorInfo &error);
@@ -69,16 +76,19 @@ signals:
 private:
     LauncherInterface();
 
-    void doStart();
+    void doStart(int launcherCount);
     void doStop();
+    LauncherSocket *nextSocket();
     void handleNewConnection();
-    void handleProcessError();
-    void handleProcessFinished();
-    void handleProcessStderr();
+    void handleProcessError(LauncherProcess *process);
+    void handleProcessFinished(LauncherProcess *process);
+    void handleProcessStderr(LauncherProcess *process);
 
     QLocalServer * const m_server;
-    LauncherSocket * const m_socket;
-    LauncherProcess * m_process = nullptr;
+    std::vector<LauncherSocket *> m_sockets; // Never empty. The first m_launcherCount are in use.
+    std::vector<LauncherProcess *> m_processes;
+    int m_launcherCount = 1;
+    std::atomic<unsigned int> m_nextSocket;
     int m_startRequests = 0;
 };
 
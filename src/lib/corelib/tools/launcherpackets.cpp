@@ -116,6 +116,25 @@ void ProcessErrorPacket::doDeserialize(QDataStream &stream)
 }
 
 
+ProcessOutputPacket::ProcessOutputPacket(quintptr token)
+    : LauncherPacket(LauncherPacketType::ProcessOutput, token)
+{
+}
+
+void ProcessOutputPacket::doSerialize(QDataStream &stream) const
+{
+    stream << static_cast<quint8>(channel) << data;
+}
+
+void ProcessOutputPacket::doDeserialize(QDataStream &stream)
+{
+    quint8 c;
+    stream >> c;
+    channel = static_cast<QProcess::ProcessChannel>(c);
+    stream >> data;
+}
+
+
 ProcessFinishedPacket::ProcessFinishedPacket(quintptr token)
     : LauncherPacket(LauncherPacketType::ProcessFinished, token)
 {
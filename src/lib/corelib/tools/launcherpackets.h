@@ -52,7 +52,7 @@ namespace qbs {
 namespace Internal {
 
 enum class LauncherPacketType {
-    Shutdown, StartProcess, StopProcess, ProcessError, ProcessFinished
+    Shutdown, StartProcess, StopProcess, ProcessError, ProcessFinished, ProcessOutput
 };
 
 class PacketParser
@@ -153,6 +153,22 @@ private:
     void doDeserialize(QDataStream &stream) override;
 };
 
+// Sent while the process is running, so the client does not have to wait for the
+// process to finish before seeing its output.
+class ProcessOutputPacket : public LauncherPacket
+{
+public:
+    ProcessOutputPacket(quintptr token);
+
+    QProcess::ProcessChannel channel;
+    QByteArray data;
+
+private:
+    void doSerialize(QDataStream &stream) const override;
+    void doDeserialize(QDataStream &stream) override;
+};
+
+// The output fields contain only what was not yet sent via a ProcessOutputPacket.
 class ProcessFinishedPacket : public LauncherPacket
 {
 public:
@@ -44,12 +44,239 @@
 #include <tools/error.h>
 #include <tools/qbsassert.h>
 
+#include <QtCore/qbuffer.h>
 #include <QtCore/qdir.h>
+#include <QtCore/qsavefile.h>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <thread>
 
 namespace qbs {
 namespace Internal {
 
-static const char QBS_PERSISTENCE_MAGIC[] = "QBSPERSISTENCE-114";
+static const char QBS_PERSISTENCE_MAGIC[] = "QBSPERSISTENCE-122";
+
+// Writes serialized build graphs to disk on threads of their own. There is at most one
+// such thread per file, and all of them are waited for when the process exits.
+class BackgroundWriters
+{
+public:
+    ~BackgroundWriters()
+    {
+        // Normally, the owner of the build graph has collected its writer already, so
+        // nobody is left to report errors to.
+        for (auto &writer : m_writers)
+            writer.second->thread.join();
+    }
+
+    void start(const QString &filePath, QByteArray data)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_errors.erase(filePath);
+        std::unique_ptr<Writer> &writer = m_writers[filePath];
+        QBS_CHECK(!writer); // The previous writer was waited for in setupWriteStream().
+        writer.reset(new Writer);
+        ErrorInfo &error = writer->error;
+
+        // The file is only ever touched by the writer thread.
+        writer->thread = std::thread([filePath, data = std::move(data), &error] {
+            QSaveFile file(filePath);
+            if (!file.open(QFile::WriteOnly) || file.write(data) != data.size()
+                    || !file.commit()) {
+                // The previous version of the file is still intact.
+                error = ErrorInfo(Tr::tr("Failure storing build graph '%1': %2")
+                                  .arg(QDir::toNativeSeparators(filePath),
+                                       file.errorString()));
+            }
+        });
+    }
+
+    ErrorInfo waitFor(const QString &filePath)
+    {
+        join(filePath);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const auto it = m_errors.find(filePath);
+        if (it == m_errors.end())
+            return ErrorInfo();
+        const ErrorInfo error = it->second;
+        m_errors.erase(it);
+        return error;
+    }
+
+    // Keeps the error for the next call of waitFor().
+    void join(const QString &filePath)
+    {
+        std::unique_ptr<Writer> writer;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            const auto it = m_writers.find(filePath);
+            if (it == m_writers.end())
+                return;
+            writer = std::move(it->second);
+            m_writers.erase(it);
+        }
+        writer->thread.join();
+        if (writer->error.hasError()) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_errors[filePath] = writer->error;
+        }
+    }
+
+private:
+    struct Writer
+    {
+        std::thread thread;
+        ErrorInfo error;
+    };
+
+    std::mutex m_mutex;
+    std::map<QString, std::unique_ptr<Writer>> m_writers;
+    std::map<QString, ErrorInfo> m_errors;
+};
+
+static BackgroundWriters &backgroundWriters()
+{
+    static BackgroundWriters writers;
+    return writers;
+}
+
+// In a compressed build graph, the data after the header is a sequence of independently
+// compressed chunks, each serialized as a QByteArray. An empty one marks the end.
+// This way, compression and decompression happen while the stream is written and read,
+// and neither the compressed nor the uncompressed data has to be kept in memory as a whole.
+static const int compressionChunkSize = 1 << 20;
+
+class CompressingDevice : public QIODevice
+{
+public:
+    explicit CompressingDevice(QIODevice *target) : m_target(target), m_uncompressedSize(0)
+    {
+        m_targetStream.setDevice(m_target);
+        m_targetStream.setVersion(QDataStream::Qt_4_8);
+        open(QIODevice::WriteOnly | QIODevice::Unbuffered);
+    }
+    ~CompressingDevice() override { delete m_target; }
+
+    // Writes out the remaining data and the end marker. Returns false on failure.
+    bool finish()
+    {
+        const bool success = writeChunk() && writeChunk();
+        close();
+        return success;
+    }
+
+    QIODevice *takeTarget()
+    {
+        QIODevice * const target = m_target;
+        m_target = nullptr;
+        m_targetStream.setDevice(nullptr);
+        return target;
+    }
+
+    qint64 uncompressedSize() const { return m_uncompressedSize; }
+    bool isSequential() const override { return true; }
+
+private:
+    qint64 readData(char *, qint64) override { return -1; }
+
+    qint64 writeData(const char *data, qint64 len) override
+    {
+        for (qint64 remaining = len; remaining > 0;) {
+            const int count = int(std::min<qint64>(remaining,
+                                                   compressionChunkSize - m_chunk.size()));
+            m_chunk.append(data, count);
+            data += count;
+            remaining -= count;
+            if (m_chunk.size() == compressionChunkSize && !writeChunk())
+                return -1;
+        }
+        m_uncompressedSize += len;
+        return len;
+    }
+
+    bool writeChunk()
+    {
+        // The data is highly redundant, so even the fastest compression level shrinks it
+        // considerably.
+        m_targetStream << (m_chunk.isEmpty() ? QByteArray() : qCompress(m_chunk, 1));
+        m_chunk.clear();
+        if (m_targetStream.status() == QDataStream::Ok)
+            return true;
+        setErrorString(m_target->errorString());
+        return false;
+    }
+
+    QIODevice *m_target;
+    QDataStream m_targetStream;
+    QByteArray m_chunk;
+    qint64 m_uncompressedSize;
+};
+
+class DecompressingDevice : public QIODevice
+{
+public:
+    explicit DecompressingDevice(QIODevice *source)
+        : m_source(source), m_chunkPos(0), m_atEnd(false)
+    {
+        m_sourceStream.setDevice(m_source);
+        m_sourceStream.setVersion(QDataStream::Qt_4_8);
+        open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+    }
+    ~DecompressingDevice() override { delete m_source; }
+
+    bool isSequential() const override { return true; }
+
+private:
+    qint64 readData(char *data, qint64 maxlen) override
+    {
+        qint64 count = 0;
+        while (count < maxlen) {
+            if (m_chunkPos == m_chunk.size() && !readChunk())
+                return m_atEnd ? count : -1;
+            const int n = int(std::min<qint64>(maxlen - count, m_chunk.size() - m_chunkPos));
+            std::memcpy(data + count, m_chunk.constData() + m_chunkPos, size_t(n));
+            m_chunkPos += n;
+            count += n;
+        }
+        return count;
+    }
+
+    qint64 writeData(const char *, qint64) override { return -1; }
+
+    bool readChunk()
+    {
+        if (m_atEnd)
+            return false;
+        QByteArray compressedChunk;
+        m_sourceStream >> compressedChunk;
+        if (m_sourceStream.status() != QDataStream::Ok) {
+            setErrorString(Tr::tr("Unexpected end of compressed data."));
+            return false;
+        }
+        m_chunkPos = 0;
+        if (compressedChunk.isEmpty()) {
+            m_chunk.clear();
+            m_atEnd = true;
+            return false;
+        }
+        m_chunk = qUncompress(compressedChunk);
+        if (m_chunk.isEmpty()) {
+            setErrorString(Tr::tr("Failed to decompress the data."));
+            return false;
+        }
+        return true;
+    }
+
+    QIODevice * const m_source;
+    QDataStream m_sourceStream;
+    QByteArray m_chunk;
+    int m_chunkPos;
+    bool m_atEnd;
+};
 
 NoBuildGraphError::NoBuildGraphError(const QString &filePath)
     : ErrorInfo(Tr::tr("Build graph not found for configuration '%1'. Expected location was '%2'.")
@@ -57,9 +284,9 @@ NoBuildGraphError::NoBuildGraphError(const QString &filePath)
 {
 }
 
-PersistentPool::PersistentPool(Logger &logger) : m_logger(logger)
+PersistentPool::PersistentPool(Logger &logger)
+    : m_writeOptions(NoWriteOptions), m_uncompressedSize(0), m_storedSize(0), m_logger(logger)
 {
-    Q_UNUSED(m_logger);
     m_stream.setVersion(QDataStream::Qt_4_8);
 }
 
@@ -68,8 +295,11 @@ PersistentPool::~PersistentPool()
     closeStream();
 }
 
-void PersistentPool::load(const QString &filePath)
+void PersistentPool::load(const QString &filePath, LoadOptions options)
 {
+    const ErrorInfo writeError = waitForBackgroundWrite(filePath);
+    if (writeError.hasError())
+        m_logger.printWarning(writeError);
     std::unique_ptr<QFile> file(new QFile(filePath));
     if (!file->exists())
         throw NoBuildGraphError(filePath);
@@ -78,19 +308,49 @@ void PersistentPool::load(const QString &filePath)
                     .arg(filePath, file->errorString()));
     }
 
-    m_stream.setDevice(file.get());
+    closeStream();
+
+    // With a mapping of the file, the stream's reads are plain copies from the page cache
+    // instead of read() calls on the file. The buffer is unbuffered, as another copy into
+    // QIODevice's read buffer would gain nothing. See testPersistentPoolLoadBenchmark() in
+    // tst_tools for a comparison.
+    const qint64 size = file->size();
+    uchar * const data = !(options & NoMemoryMapping) && size > 0
+            && size <= std::numeric_limits<int>::max() ? file->map(0, size) : nullptr;
+    if (data) {
+        m_mappedData = QByteArray::fromRawData(reinterpret_cast<const char *>(data), int(size));
+        const auto buffer = new QBuffer(&m_mappedData);
+        buffer->open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+        m_stream.setDevice(buffer);
+        m_mappedFile = std::move(file);
+    } else {
+        m_stream.setDevice(file.release());
+    }
+
     QByteArray magic;
     m_stream >> magic;
     if (magic != QBS_PERSISTENCE_MAGIC) {
-        m_stream.setDevice(0);
+        closeStream();
         throw ErrorInfo(Tr::tr("Cannot use stored build graph at '%1': Incompatible file format. "
                            "Expected magic token '%2', got '%3'.")
                     .arg(filePath, QString::fromLatin1(QBS_PERSISTENCE_MAGIC),
                          QString::fromLatin1(magic)));
     }
 
-    m_stream >> m_headData.projectConfig;
-    file.release();
+    bool compressed;
+    m_stream >> compressed;
+    if (compressed) {
+        const auto device = new DecompressingDevice(m_stream.device());
+        m_stream.setDevice(device);
+    }
+
+    m_stream >> m_headData.projectConfig >> m_headData.rawScanResults;
+    if (compressed && m_stream.status() != QDataStream::Ok) {
+        const QString errorString = m_stream.device()->errorString();
+        closeStream();
+        throw ErrorInfo(Tr::tr("Cannot use stored build graph at '%1': %2")
+                        .arg(filePath, errorString));
+    }
     m_loadedRaw.clear();
     m_loaded.clear();
     m_storageIndices.clear();
@@ -98,44 +358,102 @@ void PersistentPool::load(const QString &filePath)
     m_inverseStringStorage.clear();
 }
 
-void PersistentPool::setupWriteStream(const QString &filePath)
+void PersistentPool::setupWriteStream(const QString &filePath, WriteOptions options)
 {
+    const ErrorInfo writeError = waitForBackgroundWrite(filePath);
+    if (writeError.hasError())
+        m_logger.printWarning(writeError);
     QString dirPath = FileInfo::path(filePath);
     if (!FileInfo::exists(dirPath) && !QDir().mkpath(dirPath)) {
         throw ErrorInfo(Tr::tr("Failure storing build graph: Cannot create directory '%1'.")
                         .arg(dirPath));
     }
 
-    if (QFile::exists(filePath) && !QFile::remove(filePath)) {
-        throw ErrorInfo(Tr::tr("Failure storing build graph: Cannot remove old file '%1'")
-                        .arg(filePath));
-    }
-    QBS_CHECK(!QFile::exists(filePath));
-    std::unique_ptr<QFile> file(new QFile(filePath));
-    if (!file->open(QFile::WriteOnly)) {
-        throw ErrorInfo(Tr::tr("Failure storing build graph: "
-                "Cannot open file '%1' for writing: %2").arg(filePath, file->errorString()));
+    // The data goes to a temporary file that replaces the old build graph only once it has
+    // been written completely, so an interrupted build never leaves a broken file behind.
+    // When writing in the background, the data is serialized into memory, and the writer
+    // thread opens the file itself.
+    closeStream();
+    QIODevice *device;
+    if (options & WriteInBackground) {
+        const auto buffer = new QBuffer(&m_pendingData);
+        buffer->open(QIODevice::WriteOnly);
+        device = buffer;
+    } else {
+        std::unique_ptr<QSaveFile> file(new QSaveFile(filePath));
+        if (!file->open(QFile::WriteOnly)) {
+            throw ErrorInfo(Tr::tr("Failure storing build graph: "
+                    "Cannot open file '%1' for writing: %2").arg(filePath, file->errorString()));
+        }
+        device = file.release();
     }
 
-    m_stream.setDevice(file.release());
-    m_stream << QByteArray(qstrlen(QBS_PERSISTENCE_MAGIC), 0) << m_headData.projectConfig;
+    m_writeOptions = options;
+    m_pendingFilePath = filePath;
+    m_stream.setDevice(device);
+    m_stream << QByteArray(qstrlen(QBS_PERSISTENCE_MAGIC), 0) << bool(options & Compress);
+    m_uncompressedSize = device->pos();
+    if (options & Compress)
+        m_stream.setDevice(new CompressingDevice(device));
+    m_stream << m_headData.projectConfig << m_headData.rawScanResults;
+    m_lastStoredObjectId = 0;
+    m_lastStoredStringId = 0;
+}
+
+void PersistentPool::setupWriteStream(QByteArray *data)
+{
+    closeStream();
+    const auto buffer = new QBuffer(data);
+    buffer->open(QIODevice::WriteOnly);
+    m_stream.setDevice(buffer);
     m_lastStoredObjectId = 0;
     m_lastStoredStringId = 0;
 }
 
+void PersistentPool::setupReadStream(const QByteArray &data)
+{
+    closeStream();
+    const auto buffer = new QBuffer;
+    buffer->setData(data);
+    buffer->open(QIODevice::ReadOnly);
+    m_stream.setDevice(buffer);
+    clear();
+    m_loadedRaw.clear();
+}
+
 void PersistentPool::finalizeWriteStream()
 {
     if (m_stream.status() != QDataStream::Ok)
         throw ErrorInfo(Tr::tr("Failure serializing build graph."));
+    if (m_writeOptions & Compress) {
+        const auto device = static_cast<CompressingDevice *>(m_stream.device());
+        if (!device->finish()) {
+            throw ErrorInfo(Tr::tr("Failure serializing build graph: %1")
+                            .arg(device->errorString()));
+        }
+        m_uncompressedSize += device->uncompressedSize();
+        m_stream.setDevice(device->takeTarget());
+        delete device;
+    } else {
+        m_uncompressedSize = m_stream.device()->size();
+    }
+    m_storedSize = m_stream.device()->size();
+
     m_stream.device()->seek(0);
     m_stream << QByteArray(QBS_PERSISTENCE_MAGIC);
     if (m_stream.status() != QDataStream::Ok)
         throw ErrorInfo(Tr::tr("Failure serializing build graph."));
-    const auto file = static_cast<QFile *>(m_stream.device());
-    if (!file->flush()) {
-        file->close();
-        file->remove();
-        throw ErrorInfo(Tr::tr("Failure serializing build graph: %1").arg(file->errorString()));
+
+    if (m_writeOptions & WriteInBackground) {
+        delete m_stream.device();
+        m_stream.setDevice(nullptr);
+        backgroundWriters().start(m_pendingFilePath, std::move(m_pendingData));
+        return;
+    }
+    const auto file = static_cast<QSaveFile *>(m_stream.device());
+    if (!file->commit()) {
+        throw ErrorInfo(Tr::tr("Failure serializing build graph: %1")
+                        .arg(file->errorString()));
     }
 }
 
@@ -143,6 +461,22 @@ void PersistentPool::closeStream()
 {
     delete m_stream.device();
     m_stream.setDevice(nullptr);
+    m_mappedData.clear();
+    m_mappedFile.reset(); // Unmaps the file.
+    m_pendingData.clear();
+}
+
+// Must be called before anything else accesses a build graph file that might have been
+// stored in the background. Returns the error that occurred while writing the file, if any.
+ErrorInfo PersistentPool::waitForBackgroundWrite(const QString &filePath)
+{
+    return backgroundWriters().waitFor(filePath);
+}
+
+// Like waitForBackgroundWrite(), but leaves the error to be reported by its next call.
+void PersistentPool::finishBackgroundWrite(const QString &filePath)
+{
+    backgroundWriters().join(filePath);
 }
 
 
@@ -41,9 +41,11 @@
 #define QBS_PERSISTENCE
 
 #include "error.h"
+#include "qbs_export.h"
 #include <logging/logger.h>
 
 #include <QtCore/qdatastream.h>
+#include <QtCore/qfile.h>
 #include <QtCore/qflags.h>
 #include <QtCore/qprocess.h>
 #include <QtCore/qregexp.h>
@@ -65,7 +67,7 @@ public:
     NoBuildGraphError(const QString &filePath);
 };
 
-class PersistentPool
+class QBS_AUTOTEST_EXPORT PersistentPool
 {
 public:
     PersistentPool(Logger &logger);
@@ -75,6 +77,11 @@ public:
     {
     public:
         QVariantMap projectConfig;
+
+        // Self-contained parts of the build graph, each serialized by a pool of its own.
+        // They are located at the start of the file, so they can be decoded concurrently
+        // with the rest of the build graph.
+        QList<QByteArray> rawScanResults;
     };
 
     // We need a helper class template, because we require partial specialization for some of
@@ -131,12 +138,29 @@ public:
         OpTypeHelper<type, T, Types...>::serializationOp(this, value, args...);
     }
 
-    void load(const QString &filePath);
-    void setupWriteStream(const QString &filePath);
+    enum WriteOption { NoWriteOptions = 0, WriteInBackground = 1, Compress = 2 };
+    Q_DECLARE_FLAGS(WriteOptions, WriteOption)
+
+    // Reading from a memory mapping of the file is the default. Plain file reads are
+    // used if mapping fails, and can be requested for comparison.
+    enum LoadOption { NoLoadOptions = 0, NoMemoryMapping = 1 };
+    Q_DECLARE_FLAGS(LoadOptions, LoadOption)
+
+    void load(const QString &filePath, LoadOptions options = NoLoadOptions);
+    void setupWriteStream(const QString &filePath, WriteOptions options = NoWriteOptions);
     void finalizeWriteStream();
+    void setupWriteStream(QByteArray *data);
+    void setupReadStream(const QByteArray &data);
     void closeStream();
     void clear();
 
+    static ErrorInfo waitForBackgroundWrite(const QString &filePath);
+    static void finishBackgroundWrite(const QString &filePath);
+
+    // Available after finalizeWriteStream().
+    qint64 uncompressedSize() const { return m_uncompressedSize; }
+    qint64 storedSize() const { return m_storedSize; }
+
     const HeadData &headData() const { return m_headData; }
     void setHeadData(const HeadData &hd) { m_headData = hd; }
 
@@ -160,6 +184,13 @@ private:
     void load() {}
 
     QDataStream m_stream;
+    std::unique_ptr<QFile> m_mappedFile;
+    QByteArray m_mappedData;
+    QString m_pendingFilePath;
+    QByteArray m_pendingData;
+    WriteOptions m_writeOptions;
+    qint64 m_uncompressedSize;
+    qint64 m_storedSize;
     HeadData m_headData;
     std::vector<void *> m_loadedRaw;
     std::vector<std::shared_ptr<void>> m_loaded;
@@ -172,6 +203,9 @@ private:
     Logger &m_logger;
 };
 
+Q_DECLARE_OPERATORS_FOR_FLAGS(PersistentPool::LoadOptions)
+Q_DECLARE_OPERATORS_FOR_FLAGS(PersistentPool::WriteOptions)
+
 template<typename T> inline const void *uniqueAddress(const T *t) { return t; }
 
 template<typename T> inline void PersistentPool::storeSharedObject(const T *object)
@@ -327,6 +361,12 @@ template<> struct PersistentPool::Helper<QString>
     static void load(QString &s, PersistentPool *pool) { s = pool->idLoadString(); }
 };
 
+template<> struct PersistentPool::Helper<QByteArray>
+{
+    static void store(const QByteArray &ba, PersistentPool *pool) { pool->m_stream << ba; }
+    static void load(QByteArray &ba, PersistentPool *pool) { pool->m_stream >> ba; }
+};
+
 template<> struct PersistentPool::Helper<QVariant>
 {
     static void store(const QVariant &v, PersistentPool *pool) { pool->storeVariant(v); }
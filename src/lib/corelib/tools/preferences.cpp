@@ -106,6 +106,15 @@ CommandEchoMode Preferences::defaultEchoMode() const
     return commandEchoModeFromName(getPreference(QLatin1String("defaultEchoMode")).toString());
 }
 
+/*!
+ * \brief Returns true if build graph files are to be stored in compressed form.
+ * This trades CPU time for less I/O, which pays off on slow file systems.
+ */
+bool Preferences::compressBuildGraph() const
+{
+    return getPreference(QLatin1String("compressBuildGraph"), false).toBool();
+}
+
 /*!
  * \brief Returns the list of paths where qbs looks for modules and imports.
  * In addition to user-supplied locations, they will also be looked up at \c{baseDir}/share/qbs.
@@ -60,6 +60,7 @@ public:
     QString shell() const;
     QString defaultBuildDirectory() const;
     CommandEchoMode defaultEchoMode() const;
+    bool compressBuildGraph() const;
     QStringList searchPaths(const QString &baseDir = QString()) const;
     QStringList pluginPaths(const QString &baseDir = QString()) const;
 
@@ -41,8 +41,15 @@
 
 #include <logging/logger.h>
 #include <logging/translator.h>
+#include <tools/qttools.h>
 
+#include <QtCore/qfile.h>
+#include <QtCore/qjsondocument.h>
 #include <QtCore/qstring.h>
+#include <QtCore/qthread.h>
+
+#include <memory>
+#include <unordered_map>
 
 namespace qbs {
 namespace Internal {
@@ -122,5 +129,155 @@ QString elapsedTimeString(qint64 elapsedTimeInMs)
     return timeString;
 }
 
+static QElapsedTimer &traceClock()
+{
+    static QElapsedTimer clock;
+    return clock;
+}
+
+TraceRecorder *TraceRecorder::instance(const QString &traceFilePath)
+{
+    if (traceFilePath.isEmpty())
+        return nullptr;
+    static QMutex instancesMutex;
+    static std::unordered_map<QString, std::unique_ptr<TraceRecorder>> instances;
+    QMutexLocker locker(&instancesMutex);
+    if (!traceClock().isValid())
+        traceClock().start();
+    std::unique_ptr<TraceRecorder> &recorder = instances[traceFilePath];
+    if (!recorder)
+        recorder.reset(new TraceRecorder(traceFilePath));
+    return recorder.get();
+}
+
+TraceRecorder::TraceRecorder(const QString &filePath) : m_filePath(filePath)
+{
+    m_processNames.insert(mainProcessId(), QLatin1String("qbs"));
+}
+
+qint64 TraceRecorder::currentTime()
+{
+    return traceClock().nsecsElapsed() / 1000;
+}
+
+int TraceRecorder::addProcess(const QString &name)
+{
+    QMutexLocker locker(&m_mutex);
+    const int processId = m_processNames.lastKey() + 1;
+    m_processNames.insert(processId, name);
+    return processId;
+}
+
+static const int firstThreadId = 100000;
+
+// Thread ids are numbered in the order in which the threads first report something. They start
+// far above the job slot ids, so that the two can appear in the same process.
+int TraceRecorder::currentThreadId()
+{
+    QMutexLocker locker(&m_mutex);
+    const auto it = m_threadIds.emplace(QThread::currentThreadId(),
+                                        firstThreadId + int(m_threadIds.size()));
+    return it.first->second;
+}
+
+void TraceRecorder::addEvent(const QString &category, const QString &name, qint64 startTime,
+                             int processId, int threadId, const QJsonObject &args)
+{
+    QJsonObject event;
+    event.insert(QLatin1String("name"), name);
+    event.insert(QLatin1String("cat"), category);
+    event.insert(QLatin1String("ph"), QLatin1String("X"));
+    event.insert(QLatin1String("ts"), startTime);
+    event.insert(QLatin1String("dur"), currentTime() - startTime);
+    event.insert(QLatin1String("pid"), processId);
+    event.insert(QLatin1String("tid"), threadId);
+    if (!args.isEmpty())
+        event.insert(QLatin1String("args"), args);
+    QMutexLocker locker(&m_mutex);
+    m_events.append(event);
+    const auto threadKey = std::make_pair(processId, threadId);
+    if (threadId >= firstThreadId && !m_threadNames.contains(threadKey)) {
+        m_threadNames.insert(threadKey, QString::fromLatin1("thread %1")
+                             .arg(threadId - firstThreadId));
+    }
+}
+
+void TraceRecorder::setThreadName(int processId, int threadId, const QString &name)
+{
+    QMutexLocker locker(&m_mutex);
+    m_threadNames.insert(std::make_pair(processId, threadId), name);
+}
+
+static QJsonObject metaDataEvent(const QString &name, int processId, int threadId,
+                                 const QString &value)
+{
+    QJsonObject event;
+    event.insert(QLatin1String("name"), name);
+    event.insert(QLatin1String("ph"), QLatin1String("M"));
+    event.insert(QLatin1String("pid"), processId);
+    event.insert(QLatin1String("tid"), threadId);
+    event.insert(QLatin1String("args"), QJsonObject{{QLatin1String("name"), value}});
+    return event;
+}
+
+void TraceRecorder::writeFile(const Logger &logger)
+{
+    QMutexLocker locker(&m_mutex);
+    QJsonArray events = m_events;
+    for (auto it = m_processNames.cbegin(); it != m_processNames.cend(); ++it)
+        events.append(metaDataEvent(QLatin1String("process_name"), it.key(), 0, it.value()));
+    for (auto it = m_threadNames.cbegin(); it != m_threadNames.cend(); ++it) {
+        events.append(metaDataEvent(QLatin1String("thread_name"), it.key().first,
+                                    it.key().second, it.value()));
+    }
+    QJsonObject trace;
+    trace.insert(QLatin1String("traceEvents"), events);
+    trace.insert(QLatin1String("displayTimeUnit"), QLatin1String("ms"));
+    QFile file(m_filePath);
+    if (!file.open(QIODevice::WriteOnly)
+            || file.write(QJsonDocument(trace).toJson(QJsonDocument::Compact)) == -1) {
+        logger.qbsWarning() << Tr::tr("Cannot write trace file '%1': %2")
+                               .arg(m_filePath, file.errorString());
+    }
+}
+
+TraceSpan::TraceSpan(TraceRecorder *recorder, QLatin1String category, QLatin1String name,
+                     int processId)
+    : TraceSpan(recorder, category, QString(), processId)
+{
+    if (m_recorder)
+        m_name = name;
+}
+
+TraceSpan::TraceSpan(TraceRecorder *recorder, QLatin1String category, const QString &name,
+                     int processId)
+    : m_recorder(recorder)
+    , m_category(category)
+    , m_name(recorder ? name : QString())
+    , m_processId(processId)
+    , m_threadId(recorder ? recorder->currentThreadId() : 0)
+    , m_startTime(recorder ? TraceRecorder::currentTime() : 0)
+{
+}
+
+TraceSpan::~TraceSpan()
+{
+    stop();
+}
+
+void TraceSpan::addArg(QLatin1String key, const QString &value)
+{
+    if (m_recorder)
+        m_args.insert(key, value);
+}
+
+void TraceSpan::stop()
+{
+    if (!m_recorder)
+        return;
+    m_recorder->addEvent(m_category, m_name, m_startTime, m_processId, m_threadId, m_args);
+    m_recorder = nullptr;
+}
+
 } // namespace Internal
 } // namespace qbs
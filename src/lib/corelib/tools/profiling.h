@@ -41,10 +41,14 @@
 #define QBS_PROFILING_H
 
 #include <QtCore/qelapsedtimer.h>
+#include <QtCore/qjsonarray.h>
+#include <QtCore/qjsonobject.h>
+#include <QtCore/qmap.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qstring.h>
 
-QT_BEGIN_NAMESPACE
-class QString;
-QT_END_NAMESPACE
+#include <unordered_map>
+#include <utility>
 
 namespace qbs {
 namespace Internal {
@@ -76,6 +80,83 @@ private:
     qint64 * const m_elapsedTime;
 };
 
+// Collects events in the Chrome trace event format, which can be viewed with chrome://tracing
+// or Perfetto. There is one instance per trace file, so that e.g. resolving and building
+// in the same process end up in one timeline. Every executor shows up as a process of its own,
+// so that concurrently built configurations do not overlap. In there, commands are reported
+// with the id of the job slot running them. Everything else is reported with the id of the
+// thread it ran in.
+class TraceRecorder
+{
+public:
+    // Returns null if the file path is empty, i.e. if tracing is disabled.
+    static TraceRecorder *instance(const QString &traceFilePath);
+
+    // In microseconds.
+    static qint64 currentTime();
+
+    // The process that all events not belonging to an executor are reported in.
+    static int mainProcessId() { return 1; }
+
+    int addProcess(const QString &name);
+    int currentThreadId();
+
+    void addEvent(const QString &category, const QString &name, qint64 startTime,
+                  int processId, int threadId, const QJsonObject &args = QJsonObject());
+    void setThreadName(int processId, int threadId, const QString &name);
+
+    // Writes all events recorded so far.
+    void writeFile(const Logger &logger);
+
+private:
+    TraceRecorder(const QString &filePath);
+
+    const QString m_filePath;
+    QMutex m_mutex;
+    QJsonArray m_events;
+    QMap<int, QString> m_processNames;
+    QMap<std::pair<int, int>, QString> m_threadNames;
+    std::unordered_map<Qt::HANDLE, int> m_threadIds;
+};
+
+// Does nothing if the recorder is null. Names and argument values that are expensive to
+// compute can be passed as callables, which are then only called if tracing is enabled.
+class TraceSpan
+{
+public:
+    TraceSpan(TraceRecorder *recorder, QLatin1String category, QLatin1String name,
+              int processId = TraceRecorder::mainProcessId());
+    TraceSpan(TraceRecorder *recorder, QLatin1String category, const QString &name,
+              int processId = TraceRecorder::mainProcessId());
+    template<typename NameFunc>
+    TraceSpan(TraceRecorder *recorder, QLatin1String category, const NameFunc &nameFunc,
+              int processId = TraceRecorder::mainProcessId())
+        : TraceSpan(recorder, category, QString(), processId)
+    {
+        if (m_recorder)
+            m_name = nameFunc();
+    }
+    ~TraceSpan();
+
+    bool isActive() const { return m_recorder; }
+    void addArg(QLatin1String key, const QString &value);
+    template<typename ValueFunc> void addArg(QLatin1String key, const ValueFunc &valueFunc)
+    {
+        if (m_recorder)
+            m_args.insert(key, valueFunc());
+    }
+    void stop();
+
+private:
+    TraceRecorder *m_recorder;
+    const QLatin1String m_category;
+    QString m_name;
+    const int m_processId;
+    const int m_threadId;
+    const qint64 m_startTime;
+    QJsonObject m_args;
+};
+
 } // namespace Internal
 } // namespace qbs
 
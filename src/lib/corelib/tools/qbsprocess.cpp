@@ -51,13 +51,12 @@
 namespace qbs {
 namespace Internal {
 
-QbsProcess::QbsProcess(QObject *parent) : QObject(parent)
+QbsProcess::QbsProcess(QObject *parent)
+    : QObject(parent), m_socket(LauncherInterface::socket())
 {
-    connect(LauncherInterface::socket(), &LauncherSocket::ready,
-            this, &QbsProcess::handleSocketReady);
-    connect(LauncherInterface::socket(), &LauncherSocket::errorOccurred,
-            this, &QbsProcess::handleSocketError);
-    connect(LauncherInterface::socket(), &LauncherSocket::packetArrived,
+    connect(m_socket, &LauncherSocket::ready, this, &QbsProcess::handleSocketReady);
+    connect(m_socket, &LauncherSocket::errorOccurred, this, &QbsProcess::handleSocketError);
+    connect(m_socket, &LauncherSocket::packetArrived,
             this, &QbsProcess::handlePacket);
 }
 
@@ -71,13 +70,15 @@ void QbsProcess::start(const QString &command, const QStringList &arguments)
     m_command = command;
     m_arguments = arguments;
     m_state = QProcess::Starting;
-    if (LauncherInterface::socket()->isReady())
+    if (m_socket->isReady())
         doStart();
 }
 
 void QbsProcess::doStart()
 {
     m_state = QProcess::Running;
+    m_stdout.clear();
+    m_stderr.clear();
     StartProcessPacket p(token());
     p.command = m_command;
     p.arguments = m_arguments;
@@ -115,7 +116,7 @@ QByteArray QbsProcess::readAllStandardError()
 
 void QbsProcess::sendPacket(const LauncherPacket &packet)
 {
-    LauncherInterface::socket()->sendData(packet.serialize());
+    m_socket->sendData(packet.serialize());
 }
 
 QByteArray QbsProcess::readAndClear(QByteArray &data)
@@ -133,6 +134,9 @@ void QbsProcess::handlePacket(LauncherPacketType type, quintptr token, const QBy
     case LauncherPacketType::ProcessError:
         handleErrorPacket(payload);
         break;
+    case LauncherPacketType::ProcessOutput:
+        handleOutputPacket(payload);
+        break;
     case LauncherPacketType::ProcessFinished:
         handleFinishedPacket(payload);
         break;
@@ -169,14 +173,27 @@ void QbsProcess::handleErrorPacket(const QByteArray &packetData)
     emit error(m_error);
 }
 
+void QbsProcess::handleOutputPacket(const QByteArray &packetData)
+{
+    QBS_ASSERT(m_state == QProcess::Running, return);
+    const auto packet = LauncherPacket::extractPacket<ProcessOutputPacket>(token(), packetData);
+    if (packet.channel == QProcess::StandardOutput) {
+        m_stdout += packet.data;
+        emit readyReadStandardOutput();
+    } else {
+        m_stderr += packet.data;
+        emit readyReadStandardError();
+    }
+}
+
 void QbsProcess::handleFinishedPacket(const QByteArray &packetData)
 {
     QBS_ASSERT(m_state == QProcess::Running, return);
     m_state = QProcess::NotRunning;
     const auto packet = LauncherPacket::extractPacket<ProcessFinishedPacket>(token(), packetData);
     m_exitCode = packet.exitCode;
-    m_stdout = packet.stdOut;
-    m_stderr = packet.stdErr;
+    m_stdout += packet.stdOut;
+    m_stderr += packet.stdErr;
     m_errorString = packet.errorString;
     emit finished(m_exitCode);
 }
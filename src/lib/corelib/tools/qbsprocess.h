@@ -41,6 +41,7 @@
 #define QBS_QBSPROCESS_H
 
 #include "launcherpackets.h"
+#include "qbs_export.h"
 
 #include <QtCore/qbytearray.h>
 #include <QtCore/qobject.h>
@@ -49,8 +50,9 @@
 
 namespace qbs {
 namespace Internal {
+class LauncherSocket;
 
-class QbsProcess : public QObject
+class QBS_AUTOTEST_EXPORT QbsProcess : public QObject
 {
     Q_OBJECT
 public:
@@ -70,6 +72,8 @@ public:
 
 signals:
     void error(QProcess::ProcessError error);
+    void readyReadStandardOutput();
+    void readyReadStandardError();
     void finished(int exitCode);
 
 private:
@@ -81,11 +85,13 @@ private:
     void handlePacket(qbs::Internal::LauncherPacketType type, quintptr token,
                       const QByteArray &payload);
     void handleErrorPacket(const QByteArray &packetData);
+    void handleOutputPacket(const QByteArray &packetData);
     void handleFinishedPacket(const QByteArray &packetData);
     void handleSocketReady();
 
     quintptr token() const { return reinterpret_cast<quintptr>(this); }
 
+    LauncherSocket * const m_socket;
     QString m_command;
     QStringList m_arguments;
     QProcessEnvironment m_environment;
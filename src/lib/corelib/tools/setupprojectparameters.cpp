@@ -82,6 +82,7 @@ public:
     QStringList pluginPaths;
     QString libexecPath;
     QString settingsBaseDir;
+    QString traceFilePath;
     QVariantMap overriddenValues;
     QVariantMap buildConfiguration;
     mutable QVariantMap buildConfigurationTree;
@@ -473,6 +474,25 @@ void SetupProjectParameters::setLogElapsedTime(bool logElapsedTime)
     d->logElapsedTime = logElapsedTime;
 }
 
+/*!
+ * \brief Returns the file that a timeline of the resolving process is written to.
+ */
+QString SetupProjectParameters::traceFilePath() const
+{
+    return d->traceFilePath;
+}
+
+/*!
+ * Sets the file that a timeline of the resolving process is written to, in the Chrome trace
+ * event format. If the same file is given in the \c BuildOptions, the events of the build
+ * are appended to the same timeline.
+ * The default is an empty string, which means that no trace is recorded.
+ */
+void SetupProjectParameters::setTraceFilePath(const QString &traceFilePath)
+{
+    d->traceFilePath = traceFilePath;
+}
+
 
 /*!
  * \brief Returns true iff probes should be re-run.
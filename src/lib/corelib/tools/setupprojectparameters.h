@@ -115,6 +115,9 @@ public:
     bool logElapsedTime() const;
     void setLogElapsedTime(bool logElapsedTime);
 
+    QString traceFilePath() const;
+    void setTraceFilePath(const QString &traceFilePath);
+
     bool forceProbeExecution() const;
     void setForceProbeExecution(bool force);
 
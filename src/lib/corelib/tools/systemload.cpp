@@ -0,0 +1,116 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "systemload.h"
+
+#include <QtCore/qbytearray.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qlist.h>
+
+#if defined(Q_OS_UNIX) && !defined(Q_OS_LINUX)
+#include <stdlib.h>
+#endif
+
+namespace qbs {
+namespace Internal {
+
+#ifdef Q_OS_LINUX
+static QByteArray readProcFile(const char *filePath)
+{
+    // The sizes of files in /proc are reported as zero, so QFile::readAll() cannot be used.
+    QFile file(QLatin1String(filePath));
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Unbuffered))
+        return QByteArray();
+    QByteArray contents(4096, Qt::Uninitialized);
+    const qint64 bytesRead = file.read(contents.data(), contents.size());
+    if (bytesRead < 0)
+        return QByteArray();
+    contents.resize(int(bytesRead));
+    return contents;
+}
+#endif
+
+SystemLoad SystemLoad::current()
+{
+    SystemLoad load;
+#if defined(Q_OS_LINUX)
+    load.m_loadAverage = parseLoadAverage(readProcFile("/proc/loadavg"));
+    load.m_availableMemory = parseAvailableMemory(readProcFile("/proc/meminfo"));
+#elif defined(Q_OS_UNIX)
+    double loadAverage;
+    if (getloadavg(&loadAverage, 1) == 1)
+        load.m_loadAverage = loadAverage;
+#endif
+    return load;
+}
+
+double SystemLoad::parseLoadAverage(const QByteArray &procLoadAvg)
+{
+    // Format: "0.52 0.58 0.59 2/1234 5678"
+    const int end = procLoadAvg.indexOf(' ');
+    if (end <= 0)
+        return -1;
+    bool ok;
+    const double loadAverage = procLoadAvg.left(end).toDouble(&ok);
+    return ok ? loadAverage : -1;
+}
+
+qint64 SystemLoad::parseAvailableMemory(const QByteArray &procMemInfo)
+{
+    // Format: One "<key>:   <value> kB" entry per line. MemAvailable is missing
+    // in kernels older than 3.14, in which case we have no reliable estimate.
+    const QList<QByteArray> lines = procMemInfo.split('\n');
+    for (const QByteArray &line : lines) {
+        if (!line.startsWith("MemAvailable:"))
+            continue;
+        QByteArray value = line.mid(int(sizeof "MemAvailable:") - 1).trimmed();
+        qint64 factor = 1;
+        if (value.endsWith(" kB")) {
+            value.chop(3);
+            factor = 1024;
+        }
+        bool ok;
+        const qint64 availableMemory = value.trimmed().toLongLong(&ok);
+        return ok ? availableMemory * factor : -1;
+    }
+    return -1;
+}
+
+} // namespace Internal
+} // namespace qbs
@@ -0,0 +1,79 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QBS_SYSTEMLOAD_H
+#define QBS_SYSTEMLOAD_H
+
+#include <tools/qbs_export.h>
+
+#include <QtCore/qglobal.h>
+
+QT_BEGIN_NAMESPACE
+class QByteArray;
+QT_END_NAMESPACE
+
+namespace qbs {
+namespace Internal {
+
+// A snapshot of how busy the host is. Values that cannot be determined on the current
+// platform are negative.
+class QBS_AUTOTEST_EXPORT SystemLoad
+{
+public:
+    static SystemLoad current();
+
+    // The one-minute load average.
+    double loadAverage() const { return m_loadAverage; }
+
+    // The memory available for starting new processes without swapping, in bytes.
+    qint64 availableMemory() const { return m_availableMemory; }
+
+    // Parsers for the contents of /proc/loadavg and /proc/meminfo.
+    static double parseLoadAverage(const QByteArray &procLoadAvg);
+    static qint64 parseAvailableMemory(const QByteArray &procMemInfo);
+
+private:
+    double m_loadAverage = -1;
+    qint64 m_availableMemory = -1;
+};
+
+} // namespace Internal
+} // namespace qbs
+
+#endif // QBS_SYSTEMLOAD_H
@@ -21,6 +21,7 @@ HEADERS += \
     $$PWD/launcherpackets.h \
     $$PWD/launchersocket.h \
     $$PWD/msvcinfo.h \
+    $$PWD/parallelfor.h \
     $$PWD/persistence.h \
     $$PWD/scannerpluginmanager.h \
     $$PWD/scripttools.h \
@@ -41,6 +42,7 @@ HEADERS += \
     $$PWD/shellutils.h \
     $$PWD/stlutils.h \
     $$PWD/stringutils.h \
+    $$PWD/systemload.h \
     $$PWD/toolchains.h \
     $$PWD/hostosinfo.h \
     $$PWD/buildoptions.h \
@@ -89,6 +91,7 @@ SOURCES += \
     $$PWD/qbspluginmanager.cpp \
     $$PWD/qbsprocess.cpp \
     $$PWD/shellutils.cpp \
+    $$PWD/systemload.cpp \
     $$PWD/buildoptions.cpp \
     $$PWD/installoptions.cpp \
     $$PWD/cleanoptions.cpp \
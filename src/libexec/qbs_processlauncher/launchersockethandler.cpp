@@ -41,6 +41,10 @@
 
 #include "launcherlogging.h"
 
+#ifdef Q_OS_LINUX
+#include "linuxprocess.h"
+#endif
+
 #include <QtCore/qcoreapplication.h>
 #include <QtCore/qprocess.h>
 #include <QtCore/qtimer.h>
@@ -49,12 +53,18 @@
 namespace qbs {
 namespace Internal {
 
-class Process : public QProcess
+#ifdef Q_OS_LINUX
+using ProcessBase = LinuxProcess;
+#else
+using ProcessBase = QProcess;
+#endif
+
+class Process : public ProcessBase
 {
     Q_OBJECT
 public:
     Process(quintptr token, QObject *parent = nullptr) :
-        QProcess(parent), m_token(token), m_stopTimer(new QTimer(this))
+        ProcessBase(parent), m_token(token), m_stopTimer(new QTimer(this))
     {
         m_stopTimer->setSingleShot(true);
         connect(m_stopTimer, &QTimer::timeout, this, &Process::cancel);
@@ -188,6 +198,16 @@ void LauncherSocketHandler::handleProcessError()
     sendPacket(packet);
 }
 
+void LauncherSocketHandler::handleProcessOutput(Process *proc, QProcess::ProcessChannel channel)
+{
+    ProcessOutputPacket packet(proc->token());
+    packet.channel = channel;
+    packet.data = channel == QProcess::StandardOutput ? proc->readAllStandardOutput()
+                                                      : proc->readAllStandardError();
+    if (!packet.data.isEmpty())
+        sendPacket(packet);
+}
+
 void LauncherSocketHandler::handleProcessFinished()
 {
     Process * proc = senderProcess();
@@ -273,9 +293,15 @@ void LauncherSocketHandler::sendPacket(const LauncherPacket &packet)
 Process *LauncherSocketHandler::setupProcess(quintptr token)
 {
     const auto p = new Process(token, this);
-    connect(p, static_cast<void (QProcess::*)(QProcess::ProcessError)>(&QProcess::error),
+    connect(p, static_cast<void (ProcessBase::*)(QProcess::ProcessError)>(&ProcessBase::error),
             this, &LauncherSocketHandler::handleProcessError);
-    connect(p, static_cast<void (QProcess::*)(int)>(&QProcess::finished),
+    connect(p, &ProcessBase::readyReadStandardOutput, this, [this, p] {
+        handleProcessOutput(p, QProcess::StandardOutput);
+    });
+    connect(p, &ProcessBase::readyReadStandardError, this, [this, p] {
+        handleProcessOutput(p, QProcess::StandardError);
+    });
+    connect(p, static_cast<void (ProcessBase::*)(int)>(&ProcessBase::finished),
             this, &LauncherSocketHandler::handleProcessFinished);
     connect(p, &Process::failedToStop, this, &LauncherSocketHandler::handleStopFailure);
     return p;
@@ -45,6 +45,7 @@
 #include <QtCore/qbytearray.h>
 #include <QtCore/qhash.h>
 #include <QtCore/qobject.h>
+#include <QtCore/qprocess.h>
 
 QT_BEGIN_NAMESPACE
 class QLocalSocket;
@@ -68,6 +69,7 @@ private:
     void handleSocketError();
     void handleSocketClosed();
     void handleProcessError();
+    void handleProcessOutput(Process *proc, QProcess::ProcessChannel channel);
     void handleProcessFinished();
     void handleStopFailure();
 
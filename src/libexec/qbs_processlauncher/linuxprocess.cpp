@@ -0,0 +1,394 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "linuxprocess.h"
+
+#include <QtCore/qfile.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qsocketnotifier.h>
+#include <QtCore/qstandardpaths.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <vector>
+
+extern char **environ;
+
+namespace qbs {
+namespace Internal {
+
+static int sigchldPipe[2] = { -1, -1 };
+
+static void sigchldHandler(int)
+{
+    const int savedErrno = errno;
+    const char c = 0;
+    while (::write(sigchldPipe[1], &c, 1) == -1 && errno == EINTR)
+        ;
+    errno = savedErrno;
+}
+
+static void closeFd(int &fd)
+{
+    if (fd == -1)
+        return;
+    ::close(fd);
+    fd = -1;
+}
+
+// Collects the exit status of our child processes. A SIGCHLD handler notifies us
+// via a self-pipe, so reaping happens in the event loop rather than in signal context.
+class ChildReaper : public QObject
+{
+public:
+    static ChildReaper &instance()
+    {
+        // Deliberately leaked, as the socket notifier must not outlive the event dispatcher.
+        static ChildReaper * const reaper = new ChildReaper;
+        return *reaper;
+    }
+
+    void add(pid_t pid, LinuxProcess *process) { m_children.insert(pid, process); }
+
+    // The process object goes away before the child has finished.
+    // We still have to reap it eventually, but nobody is interested in the result anymore.
+    void detach(pid_t pid)
+    {
+        const auto it = m_children.find(pid);
+        if (it != m_children.end())
+            it.value() = nullptr;
+    }
+
+private:
+    ChildReaper()
+    {
+        if (::pipe2(sigchldPipe, O_CLOEXEC | O_NONBLOCK) == -1)
+            qFatal("Failed to create pipe: %s", qPrintable(qt_error_string(errno)));
+        struct sigaction action = {};
+        action.sa_handler = sigchldHandler;
+        action.sa_flags = SA_NOCLDSTOP | SA_RESTART;
+        sigemptyset(&action.sa_mask);
+        ::sigaction(SIGCHLD, &action, nullptr);
+        const auto notifier = new QSocketNotifier(sigchldPipe[0], QSocketNotifier::Read, this);
+        connect(notifier, &QSocketNotifier::activated, this, &ChildReaper::reap);
+    }
+
+    void reap()
+    {
+        char buf[64];
+        while (::read(sigchldPipe[0], buf, sizeof buf) > 0)
+            ;
+
+        // Finishing a process can lead to a new one getting started, so iterate over a copy.
+        const QList<pid_t> pids = m_children.keys();
+        for (const pid_t pid : pids) {
+            int status;
+            pid_t result;
+            do {
+                result = ::waitpid(pid, &status, WNOHANG);
+            } while (result == -1 && errno == EINTR);
+            if (result == 0)
+                continue;
+            const int waitError = errno;
+            LinuxProcess * const process = m_children.take(pid);
+            if (!process)
+                continue;
+            if (result == pid)
+                process->handleChildExit(status);
+            else
+                process->handleWaitError(waitError);
+        }
+    }
+
+    QHash<pid_t, LinuxProcess *> m_children;
+};
+
+LinuxProcess::LinuxProcess(QObject *parent) : QObject(parent)
+{
+}
+
+LinuxProcess::~LinuxProcess()
+{
+    if (m_state == QProcess::NotRunning)
+        return;
+    ::kill(m_pid, SIGKILL);
+    ChildReaper::instance().detach(m_pid);
+    closeChannel(m_stdout);
+    closeChannel(m_stderr);
+}
+
+void LinuxProcess::start(const QString &program, const QStringList &arguments)
+{
+    if (m_state != QProcess::NotRunning)
+        return;
+    ChildReaper::instance();
+    m_error = QProcess::UnknownError;
+    m_errorString.clear();
+    m_exitCode = 0;
+    m_exitStatus = QProcess::NormalExit;
+    m_stdout.data.clear();
+    m_stderr.data.clear();
+
+    // Everything the child needs has to be set up beforehand, as it shares our address space
+    // until it calls execve() and must therefore not allocate memory.
+    QString executable = program;
+    if (!executable.contains(QLatin1Char('/'))) {
+        const QString fullPath = QStandardPaths::findExecutable(executable);
+        if (!fullPath.isEmpty())
+            executable = fullPath;
+    }
+    const QByteArray encodedExecutable = QFile::encodeName(executable);
+    const QByteArray encodedWorkingDir = QFile::encodeName(m_workingDirectory);
+    std::vector<QByteArray> argStorage;
+    argStorage.reserve(arguments.size() + 1);
+    argStorage.push_back(encodedExecutable);
+    for (const QString &arg : arguments)
+        argStorage.push_back(arg.toLocal8Bit());
+    std::vector<char *> argv;
+    argv.reserve(argStorage.size() + 1);
+    for (QByteArray &arg : argStorage)
+        argv.push_back(arg.data());
+    argv.push_back(nullptr);
+    std::vector<QByteArray> envStorage;
+    std::vector<char *> envp;
+    char **childEnv = environ; // Like QProcess, inherit our environment if none was given.
+    if (!m_environment.isEmpty()) {
+        envStorage.reserve(m_environment.size());
+        for (const QString &entry : qAsConst(m_environment))
+            envStorage.push_back(entry.toLocal8Bit());
+        envp.reserve(envStorage.size() + 1);
+        for (QByteArray &entry : envStorage)
+            envp.push_back(entry.data());
+        envp.push_back(nullptr);
+        childEnv = envp.data();
+    }
+
+    int stdoutPipe[2] = { -1, -1 };
+    int stderrPipe[2] = { -1, -1 };
+    int errorPipe[2] = { -1, -1 };
+    int devNull = -1;
+    const auto closeAll = [&] {
+        for (int *fd : { &stdoutPipe[0], &stdoutPipe[1], &stderrPipe[0], &stderrPipe[1],
+                         &errorPipe[0], &errorPipe[1], &devNull }) {
+            closeFd(*fd);
+        }
+    };
+    if (::pipe2(stdoutPipe, O_CLOEXEC) == -1 || ::pipe2(stderrPipe, O_CLOEXEC) == -1
+            || ::pipe2(errorPipe, O_CLOEXEC) == -1
+            || (devNull = ::open("/dev/null", O_RDONLY | O_CLOEXEC)) == -1) {
+        const int errorCode = errno;
+        closeAll();
+        handleStartError(errorCode);
+        return;
+    }
+
+    const pid_t pid = ::vfork();
+    if (pid == 0) {
+        // Child. dup2() clears the close-on-exec flag on the target descriptor.
+        ::signal(SIGPIPE, SIG_DFL);
+        if (::dup2(devNull, STDIN_FILENO) != -1 && ::dup2(stdoutPipe[1], STDOUT_FILENO) != -1
+                && ::dup2(stderrPipe[1], STDERR_FILENO) != -1
+                && (encodedWorkingDir.isEmpty() || ::chdir(encodedWorkingDir.constData()) == 0)) {
+            ::execve(argv.front(), argv.data(), childEnv);
+        }
+        const int errorCode = errno;
+        while (::write(errorPipe[1], &errorCode, sizeof errorCode) == -1 && errno == EINTR)
+            ;
+        ::_exit(127);
+    }
+
+    if (pid == -1) {
+        const int errorCode = errno;
+        closeAll();
+        handleStartError(errorCode);
+        return;
+    }
+
+    // The child has called execve() or exited by now, as vfork() suspends us until then.
+    // If execve() succeeded, the error pipe got closed without anything having been written.
+    closeFd(errorPipe[1]);
+    int childErrorCode = 0;
+    ssize_t bytesRead;
+    do {
+        bytesRead = ::read(errorPipe[0], &childErrorCode, sizeof childErrorCode);
+    } while (bytesRead == -1 && errno == EINTR);
+    if (bytesRead == sizeof childErrorCode) {
+        while (::waitpid(pid, nullptr, 0) == -1 && errno == EINTR)
+            ;
+        closeAll();
+        handleStartError(childErrorCode);
+        return;
+    }
+    closeFd(errorPipe[0]);
+    closeFd(devNull);
+    closeFd(stdoutPipe[1]);
+    closeFd(stderrPipe[1]);
+
+    m_pid = pid;
+    m_state = QProcess::Running;
+    ChildReaper::instance().add(pid, this);
+    setupChannel(m_stdout, stdoutPipe[0], QProcess::StandardOutput);
+    setupChannel(m_stderr, stderrPipe[0], QProcess::StandardError);
+}
+
+void LinuxProcess::terminate()
+{
+    if (m_state == QProcess::Running)
+        ::kill(m_pid, SIGTERM);
+}
+
+void LinuxProcess::kill()
+{
+    if (m_state == QProcess::Running)
+        ::kill(m_pid, SIGKILL);
+}
+
+QByteArray LinuxProcess::readAllStandardOutput()
+{
+    QByteArray data;
+    m_stdout.data.swap(data);
+    return data;
+}
+
+QByteArray LinuxProcess::readAllStandardError()
+{
+    QByteArray data;
+    m_stderr.data.swap(data);
+    return data;
+}
+
+void LinuxProcess::setupChannel(Channel &channel, int fd, QProcess::ProcessChannel type)
+{
+    ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+    channel.fd = fd;
+    channel.notifier = new QSocketNotifier(fd, QSocketNotifier::Read, this);
+    connect(channel.notifier, &QSocketNotifier::activated, this, [this, &channel, type] {
+        readChannel(channel, type);
+    });
+}
+
+void LinuxProcess::readChannel(Channel &channel, QProcess::ProcessChannel type)
+{
+    if (channel.fd == -1)
+        return;
+    const int oldSize = channel.data.size();
+    while (true) {
+        char buf[65536];
+        const ssize_t bytesRead = ::read(channel.fd, buf, sizeof buf);
+        if (bytesRead > 0) {
+            channel.data.append(buf, int(bytesRead));
+            continue;
+        }
+        if (bytesRead == -1 && errno == EINTR)
+            continue;
+        if (bytesRead == 0 || errno != EAGAIN)
+            closeChannel(channel);
+        break;
+    }
+    if (channel.data.size() == oldSize)
+        return;
+    if (type == QProcess::StandardOutput)
+        emit readyReadStandardOutput();
+    else
+        emit readyReadStandardError();
+}
+
+void LinuxProcess::closeChannel(Channel &channel)
+{
+    delete channel.notifier;
+    channel.notifier = nullptr;
+    closeFd(channel.fd);
+}
+
+void LinuxProcess::handleStartError(int errorCode)
+{
+    m_error = QProcess::FailedToStart;
+    m_errorString = QString::fromLatin1("Process failed to start: %1")
+            .arg(qt_error_string(errorCode));
+    emit error(m_error);
+}
+
+void LinuxProcess::handleChildExit(int status)
+{
+    // The child cannot write anything anymore, so all its output is in the pipes already.
+    // Descendants might still hold the write ends open, but we do not wait for them.
+    collectRemainingOutput();
+    if (WIFSIGNALED(status)) {
+        m_exitStatus = QProcess::CrashExit;
+        m_exitCode = WTERMSIG(status);
+        m_error = QProcess::Crashed;
+        m_errorString = QString::fromLatin1("Process crashed");
+        emit error(m_error);
+    } else {
+        m_exitStatus = QProcess::NormalExit;
+        m_exitCode = WEXITSTATUS(status);
+    }
+    emit finished(m_exitCode);
+}
+
+// We cannot find out what happened to the child, e.g. because someone else reaped it.
+// Treat it like a crash, as the client would otherwise wait for it forever.
+void LinuxProcess::handleWaitError(int errorCode)
+{
+    collectRemainingOutput();
+    m_exitStatus = QProcess::CrashExit;
+    m_exitCode = -1;
+    m_error = QProcess::Crashed;
+    m_errorString = QString::fromLatin1("Failed to wait for process: %1")
+            .arg(qt_error_string(errorCode));
+    emit error(m_error);
+    emit finished(m_exitCode);
+}
+
+void LinuxProcess::collectRemainingOutput()
+{
+    readChannel(m_stdout, QProcess::StandardOutput);
+    readChannel(m_stderr, QProcess::StandardError);
+    closeChannel(m_stdout);
+    closeChannel(m_stderr);
+    m_state = QProcess::NotRunning;
+    m_pid = 0;
+}
+
+} // namespace Internal
+} // namespace qbs
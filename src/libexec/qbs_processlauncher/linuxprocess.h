@@ -0,0 +1,121 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QBS_LINUXPROCESS_H
+#define QBS_LINUXPROCESS_H
+
+#include <QtCore/qbytearray.h>
+#include <QtCore/qobject.h>
+#include <QtCore/qprocess.h>
+#include <QtCore/qstringlist.h>
+
+#include <sys/types.h>
+
+QT_BEGIN_NAMESPACE
+class QSocketNotifier;
+QT_END_NAMESPACE
+
+namespace qbs {
+namespace Internal {
+
+// A minimal replacement for QProcess that offers just the functionality the launcher needs.
+// Child processes are created via vfork() and execve() with argument and environment arrays
+// that are fully prepared in advance, which is considerably cheaper than what QProcess does.
+// The API mirrors the respective subset of QProcess, so the two are interchangeable.
+class LinuxProcess : public QObject
+{
+    Q_OBJECT
+public:
+    explicit LinuxProcess(QObject *parent = nullptr);
+    ~LinuxProcess();
+
+    void setEnvironment(const QStringList &environment) { m_environment = environment; }
+    void setWorkingDirectory(const QString &workingDir) { m_workingDirectory = workingDir; }
+    void start(const QString &program, const QStringList &arguments);
+    void terminate();
+    void kill();
+
+    QProcess::ProcessState state() const { return m_state; }
+    QProcess::ProcessError error() const { return m_error; }
+    QString errorString() const { return m_errorString; }
+    int exitCode() const { return m_exitCode; }
+    QProcess::ExitStatus exitStatus() const { return m_exitStatus; }
+    QByteArray readAllStandardOutput();
+    QByteArray readAllStandardError();
+
+signals:
+    void error(QProcess::ProcessError error);
+    void readyReadStandardOutput();
+    void readyReadStandardError();
+    void finished(int exitCode);
+
+private:
+    friend class ChildReaper;
+
+    struct Channel
+    {
+        int fd = -1;
+        QSocketNotifier *notifier = nullptr;
+        QByteArray data;
+    };
+
+    void setupChannel(Channel &channel, int fd, QProcess::ProcessChannel type);
+    void readChannel(Channel &channel, QProcess::ProcessChannel type);
+    void closeChannel(Channel &channel);
+    void handleStartError(int errorCode);
+    void handleChildExit(int status);
+    void handleWaitError(int errorCode);
+    void collectRemainingOutput();
+
+    QStringList m_environment;
+    QString m_workingDirectory;
+    Channel m_stdout;
+    Channel m_stderr;
+    QString m_errorString;
+    QProcess::ProcessError m_error = QProcess::UnknownError;
+    QProcess::ProcessState m_state = QProcess::NotRunning;
+    QProcess::ExitStatus m_exitStatus = QProcess::NormalExit;
+    int m_exitCode = 0;
+    pid_t m_pid = 0;
+};
+
+} // namespace Internal
+} // namespace qbs
+
+#endif // Include guard
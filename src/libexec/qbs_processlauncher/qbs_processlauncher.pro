@@ -19,3 +19,8 @@ SOURCES += \
     launchersockethandler.cpp \
     processlauncher-main.cpp \
     $$TOOLS_DIR/launcherpackets.cpp
+
+linux {
+    HEADERS += linuxprocess.h
+    SOURCES += linuxprocess.cpp
+}
@@ -56,13 +56,21 @@ using namespace CPlusPlus;
 #include <QtCore/qfile.h>
 #endif
 
+#include <QtCore/qalgorithms.h>
 #include <QtCore/qbytearray.h>
 #include <QtCore/qlist.h>
 #include <QtCore/qstring.h>
 
+#include <algorithm>
 #include <cstring>
+#include <iterator>
 #include <memory>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define QBS_CPPSCANNER_HAS_SSE2
+#include <emmintrin.h>
+#endif
+
 struct ScanResult
 {
     char *fileName;
@@ -201,6 +209,255 @@ static void scanCppFile(void *opaq, CPlusPlus::Lexer &yylex, bool scanForFileTag
     }
 }
 
+// The fast path below only ever looks at the bytes that can end a line or start a comment or
+// a literal, plus 'Q' if Qt macros are of interest. Everything in between is skipped in bulk.
+static const char *findSpecialCharacter(const char *p, const char *end, bool withQ)
+{
+#ifdef QBS_CPPSCANNER_HAS_SSE2
+    const __m128i newline = _mm_set1_epi8('\n');
+    const __m128i slash = _mm_set1_epi8('/');
+    const __m128i doubleQuote = _mm_set1_epi8('"');
+    const __m128i singleQuote = _mm_set1_epi8('\'');
+    const __m128i q = _mm_set1_epi8(withQ ? 'Q' : '\n');
+    for (; end - p >= 16; p += 16) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+        const __m128i matches = _mm_or_si128(
+                    _mm_or_si128(_mm_cmpeq_epi8(chunk, newline), _mm_cmpeq_epi8(chunk, slash)),
+                    _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, doubleQuote),
+                                              _mm_cmpeq_epi8(chunk, singleQuote)),
+                                 _mm_cmpeq_epi8(chunk, q)));
+        const int mask = _mm_movemask_epi8(matches);
+        if (mask)
+            return p + qCountTrailingZeroBits(static_cast<quint32>(mask));
+    }
+#endif
+    for (; p < end; ++p) {
+        switch (*p) {
+        case '\n':
+        case '/':
+        case '"':
+        case '\'':
+            return p;
+        case 'Q':
+            if (withQ)
+                return p;
+            break;
+        default:
+            break;
+        }
+    }
+    return end;
+}
+
+static bool isIdentifierChar(char c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9')
+            || c == '_' || (c & 0x80);
+}
+
+static bool equals(const char *begin, const char *end, const QLatin1Literal &literal)
+{
+    return end - begin == literal.size() && memcmp(begin, literal.data(), literal.size()) == 0;
+}
+
+static const char *skipHorizontalSpace(const char *p, const char *end)
+{
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\f' || *p == '\v'))
+        ++p;
+    return p;
+}
+
+static const char *skipIdentifier(const char *p, const char *end)
+{
+    while (p < end && isIdentifierChar(*p))
+        ++p;
+    return p;
+}
+
+static bool isSplicedNewline(const char *begin, const char *newline)
+{
+    if (newline > begin && newline[-1] == '\r')
+        --newline;
+    return newline > begin && newline[-1] == '\\';
+}
+
+// Returns the position of the newline that ends the comment.
+static const char *skipLineComment(const char *begin, const char *p, const char *end)
+{
+    forever {
+        const auto newline = static_cast<const char *>(memchr(p, '\n', end - p));
+        if (!newline)
+            return end;
+        if (!isSplicedNewline(begin, newline))
+            return newline;
+        p = newline + 1;
+    }
+}
+
+static const char *skipBlockComment(const char *p, const char *end)
+{
+    forever {
+        const auto star = static_cast<const char *>(memchr(p, '*', end - p));
+        if (!star || star + 1 == end)
+            return end;
+        if (star[1] == '/')
+            return star + 2;
+        p = star + 1;
+    }
+}
+
+// Like the lexer, an unterminated literal ends at the end of the line.
+static const char *skipLiteral(const char *p, const char *end, char quote)
+{
+    while (p < end) {
+        if (*p == '\\') {
+            p += 2;
+            continue;
+        }
+        if (*p == quote)
+            return p + 1;
+        if (*p == '\n')
+            return p;
+        ++p;
+    }
+    return end;
+}
+
+// Handles the part of a preprocessor directive that is relevant to us and returns the position
+// from which normal scanning continues.
+static const char *scanDirective(Opaq *opaque, const char *p, const char *end,
+                                 bool scanForDependencies)
+{
+    const QLatin1Literal includeLiteral("include");
+    const QLatin1Literal importLiteral("import");
+    const QLatin1Literal defineLiteral("define");
+
+    const char * const name = skipHorizontalSpace(p, end);
+    const char * const nameEnd = skipIdentifier(name, end);
+    if (equals(name, nameEnd, defineLiteral)) {
+        // Someone might be clever and redefine Q_OBJECT or Q_PLUGIN_METADATA.
+        return skipIdentifier(skipHorizontalSpace(nameEnd, end), end);
+    }
+    if (!scanForDependencies
+            || !(equals(name, nameEnd, includeLiteral) || equals(name, nameEnd, importLiteral))) {
+        return nameEnd;
+    }
+
+    const char * const open = skipHorizontalSpace(nameEnd, end);
+    if (open == end || (*open != '"' && *open != '<'))
+        return open;
+    const char close = *open == '"' ? '"' : '>';
+    const char *fileNameEnd = open + 1;
+    while (fileNameEnd < end && *fileNameEnd != close && *fileNameEnd != '\n')
+        ++fileNameEnd;
+    if (fileNameEnd == end || *fileNameEnd != close)
+        return open + 1;
+    ScanResult scanResult;
+    scanResult.fileName = const_cast<char *>(open + 1);
+    scanResult.size = static_cast<unsigned int>(fileNameEnd - open - 1);
+    scanResult.flags = close == '"' ? SC_LOCAL_INCLUDE_FLAG : SC_GLOBAL_INCLUDE_FLAG;
+    opaque->includedFiles.push_back(scanResult);
+    return fileNameEnd + 1;
+}
+
+// A scanner that finds the same things as scanCppFile() without tokenizing the whole file.
+// Returns false if the file contains constructs it does not handle, namely raw string literals;
+// the caller then has to fall back to the lexer.
+static bool scanCppFileFast(Opaq *opaque, const char *begin, const char *end,
+                            bool scanForFileTags, bool scanForDependencies)
+{
+    const QLatin1Literal qobjectLiteral("Q_OBJECT");
+    const QLatin1Literal qgadgetLiteral("Q_GADGET");
+    const QLatin1Literal qnamespaceLiteral("Q_NAMESPACE");
+    const QLatin1Literal pluginMetaDataLiteral("Q_PLUGIN_METADATA");
+
+    const char *p = begin;
+    if (end - p >= 3 && memcmp(p, "\xef\xbb\xbf", 3) == 0)
+        p += 3;
+    bool atLineStart = true;
+    forever {
+        if (atLineStart) {
+            p = skipHorizontalSpace(p, end);
+            if (p < end && *p == '#') {
+                p = scanDirective(opaque, p + 1, end, scanForDependencies);
+                atLineStart = false;
+                continue;
+            }
+
+            // A comment in front of a directive is fine.
+            if (p < end && *p != '/')
+                atLineStart = false;
+        }
+
+        p = findSpecialCharacter(p, end, scanForFileTags);
+        if (p == end)
+            return true;
+
+        switch (*p) {
+        case '\n':
+            if (!isSplicedNewline(begin, p))
+                atLineStart = true;
+            ++p;
+            break;
+        case '/':
+            if (p + 1 < end && p[1] == '/') {
+                p = skipLineComment(begin, p + 2, end);
+            } else if (p + 1 < end && p[1] == '*') {
+                p = skipBlockComment(p + 2, end);
+            } else {
+                atLineStart = false;
+                ++p;
+            }
+            break;
+        case '"': {
+            const char * const prefix = std::find_if_not(std::reverse_iterator<const char *>(p),
+                    std::reverse_iterator<const char *>(begin), isIdentifierChar).base();
+            if (p > prefix && p[-1] == 'R' && (p - prefix == 1
+                    || equals(prefix, p, QLatin1Literal("LR"))
+                    || equals(prefix, p, QLatin1Literal("uR"))
+                    || equals(prefix, p, QLatin1Literal("UR"))
+                    || equals(prefix, p, QLatin1Literal("u8R")))) {
+                return false;
+            }
+            p = skipLiteral(p + 1, end, '"');
+            break;
+        }
+        case '\'': {
+            // In "0x1'000", the quote is a digit separator.
+            const char * const prefix = std::find_if_not(std::reverse_iterator<const char *>(p),
+                    std::reverse_iterator<const char *>(begin), isIdentifierChar).base();
+            if (p > prefix && *prefix >= '0' && *prefix <= '9')
+                ++p;
+            else
+                p = skipLiteral(p + 1, end, '\'');
+            break;
+        }
+        case 'Q': {
+            const char * const identifierEnd = skipIdentifier(p, end);
+            if (p > begin && isIdentifierChar(p[-1])) {
+                p = identifierEnd;
+                break;
+            }
+            if (equals(p, identifierEnd, qobjectLiteral)
+                    || equals(p, identifierEnd, qgadgetLiteral)
+                    || equals(p, identifierEnd, qnamespaceLiteral)) {
+                opaque->hasQObjectMacro = true;
+            } else if (equals(p, identifierEnd, pluginMetaDataLiteral)) {
+                opaque->hasPluginMetaDataMacro = true;
+            }
+            if (!scanForDependencies && opaque->hasQObjectMacro
+                    && (opaque->hasPluginMetaDataMacro
+                        || opaque->fileType == Opaq::FT_CPP
+                        || opaque->fileType == Opaq::FT_OBJCPP)) {
+                return true;
+            }
+            p = identifierEnd;
+            break;
+        }
+        }
+    }
+}
+
 static void *openScanner(const unsigned short *filePath, const char *fileTags, int flags)
 {
     std::unique_ptr<Opaq> opaque(new Opaq);
@@ -248,8 +505,16 @@ static void *openScanner(const unsigned short *filePath, const char *fileTags, i
         return nullptr;
 
     opaque->fileContent = reinterpret_cast<char *>(vmap);
-    CPlusPlus::Lexer lex(opaque->fileContent, opaque->fileContent + mapl);
-    scanCppFile(opaque.get(), lex, flags & ScanForFileTagsFlag, flags & ScanForDependenciesFlag);
+    const bool scanForFileTags = flags & ScanForFileTagsFlag;
+    const bool scanForDependencies = flags & ScanForDependenciesFlag;
+    if (!scanCppFileFast(opaque.get(), opaque->fileContent, opaque->fileContent + mapl,
+                         scanForFileTags, scanForDependencies)) {
+        opaque->includedFiles.clear();
+        opaque->hasQObjectMacro = false;
+        opaque->hasPluginMetaDataMacro = false;
+        CPlusPlus::Lexer lex(opaque->fileContent, opaque->fileContent + mapl);
+        scanCppFile(opaque.get(), lex, scanForFileTags, scanForDependencies);
+    }
     return opaque.release();
 }
 
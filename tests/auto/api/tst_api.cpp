@@ -96,12 +96,17 @@ class ProcessResultReceiver : public QObject
 public:
     QString output;
     std::vector<qbs::ProcessResult> results;
+    std::vector<qbs::ProcessResult> partialResults;
 
     void handleProcessResult(const qbs::ProcessResult &result) {
         results.push_back(result);
         output += result.stdErr().join(QLatin1Char('\n'));
         output += result.stdOut().join(QLatin1Char('\n'));
     }
+
+    void handleProcessOutput(const qbs::ProcessResult &partialResult) {
+        partialResults.push_back(partialResult);
+    }
 };
 
 class TaskReceiver : public QObject
@@ -494,6 +499,44 @@ void TestApi::buildSingleFile()
              qPrintable(receiver.descriptions));
 }
 
+void TestApi::cancelWaitingBuild()
+{
+    // The second build has to wait for the job pool slot held by the first one.
+    // Canceling it must not wait until the slot becomes free.
+    qbs::SetupProjectParameters setupParams = defaultSetupParameters("cancel-waiting-build");
+    std::unique_ptr<qbs::SetupProjectJob> setupJob(qbs::Project().setupProject(setupParams,
+                                                                              m_logSink, 0));
+    waitForFinished(setupJob.get());
+    QVERIFY2(!setupJob->error().hasError(), qPrintable(setupJob->error().toString()));
+    qbs::Project project = setupJob->project();
+    qbs::SetupProjectParameters setupParams2 = setupParams;
+    setupParams2.setBuildRoot(setupParams.buildRoot() + "/2");
+    setupJob.reset(qbs::Project().setupProject(setupParams2, m_logSink, 0));
+    waitForFinished(setupJob.get());
+    QVERIFY2(!setupJob->error().hasError(), qPrintable(setupJob->error().toString()));
+    qbs::Project project2 = setupJob->project();
+
+    qbs::BuildOptions options;
+    QHash<QString, int> jobLimits;
+    jobLimits.insert("pool", 1);
+    options.setJobLimits(jobLimits);
+    std::unique_ptr<qbs::BuildJob> buildJob2;
+    const std::unique_ptr<qbs::BuildJob> buildJob(project.buildAllProducts(options));
+    connect(buildJob.get(), &qbs::BuildJob::reportCommandDescription, [&] {
+        if (buildJob2)
+            return;
+        buildJob2.reset(project2.buildAllProducts(options));
+        QTimer::singleShot(500, buildJob2.get(), &qbs::AbstractJob::cancel);
+    });
+    QTRY_VERIFY_WITH_TIMEOUT(buildJob2 != nullptr, testTimeoutInMsecs());
+    QVERIFY(waitForFinished(buildJob2.get(), 3000));
+    QVERIFY2(buildJob2->error().toString().toLower().contains("cancel"),
+             qPrintable(buildJob2->error().toString()));
+    QCOMPARE(buildJob->state(), qbs::AbstractJob::StateRunning);
+    waitForFinished(buildJob.get());
+    QVERIFY2(!buildJob->error().hasError(), qPrintable(buildJob->error().toString()));
+}
+
 void TestApi::canonicalToolchainList()
 {
     // All the known toolchain lists should be equal
@@ -965,6 +1008,36 @@ void TestApi::commandExtraction()
     QVERIFY(!command.arguments().empty());
 }
 
+void TestApi::commandOutputLimit()
+{
+    ProcessResultReceiver receiver;
+    const qbs::ErrorInfo errorInfo = doBuildProject("command-output-limit", nullptr, &receiver);
+    VERIFY_NO_ERROR(errorInfo);
+    const auto isNoisy = [](const qbs::ProcessResult &result) {
+        return result.executableFilePath().contains("noisy");
+    };
+
+    // All of the output is reported while the command is running.
+    QStringList forwardedLines;
+    for (const qbs::ProcessResult &partialResult : receiver.partialResults) {
+        if (isNoisy(partialResult))
+            forwardedLines << partialResult.stdOut();
+    }
+    QCOMPARE(forwardedLines.size(), 100002);
+    QCOMPARE(forwardedLines.first(), QString("first line"));
+    QCOMPARE(forwardedLines.last(), QString("last line"));
+
+    // The final result retains only part of it.
+    const auto resultIt = std::find_if(receiver.results.cbegin(), receiver.results.cend(),
+                                       isNoisy);
+    QVERIFY(resultIt != receiver.results.cend());
+    const QStringList retainedLines = resultIt->stdOut();
+    QVERIFY(retainedLines.size() < forwardedLines.size());
+    QCOMPARE(retainedLines.first(), QString("first line"));
+    QVERIFY2(retainedLines.last().contains("bytes of further output were discarded"),
+             qPrintable(retainedLines.last()));
+}
+
 void TestApi::changeDependentLib()
 {
     qbs::ErrorInfo errorInfo = doBuildProject("change-dependent-lib");
@@ -2179,17 +2252,32 @@ void TestApi::processResult()
     QCOMPARE(expectedExitCode, result.exitCode());
     QCOMPARE(expectedExitCode == 0, result.success());
     QCOMPARE(result.error(), QProcess::UnknownError);
+
+    // Output that is not redirected is also reported while the process is running.
+    QStringList forwardedStdOut;
+    QStringList forwardedStdErr;
+    for (const qbs::ProcessResult &partialResult : resultReceiver.partialResults) {
+        if (partialResult.executableFilePath() != result.executableFilePath())
+            continue;
+        QCOMPARE(partialResult.arguments(), result.arguments());
+        forwardedStdOut << partialResult.stdOut();
+        forwardedStdErr << partialResult.stdErr();
+    }
+
     struct CheckParams {
-        CheckParams(bool r, const QString &f, const QByteArray &c, const QStringList &co)
-            : redirect(r), fileName(f), expectedContent(c), consoleOutput(co) {}
+        CheckParams(bool r, const QString &f, const QByteArray &c, const QStringList &co,
+                    const QStringList &fo)
+            : redirect(r), fileName(f), expectedContent(c), consoleOutput(co),
+              forwardedOutput(fo) {}
         bool redirect;
         QString fileName;
         QByteArray expectedContent;
         const QStringList consoleOutput;
+        const QStringList forwardedOutput;
     };
     const std::vector<CheckParams> checkParams({
-        CheckParams(redirectStdout, "stdout.txt", "stdout", result.stdOut()),
-        CheckParams(redirectStderr, "stderr.txt", "stderr", result.stdErr())
+        CheckParams(redirectStdout, "stdout.txt", "stdout", result.stdOut(), forwardedStdOut),
+        CheckParams(redirectStderr, "stderr.txt", "stderr", result.stdErr(), forwardedStdErr)
     });
     for (const CheckParams &p : checkParams) {
         QFile f(relativeProductBuildDir("app-caller") + '/' + p.fileName);
@@ -2198,8 +2286,10 @@ void TestApi::processResult()
             QVERIFY2(f.open(QIODevice::ReadOnly), qPrintable(f.errorString()));
             QCOMPARE(f.readAll(), p.expectedContent);
             QCOMPARE(p.consoleOutput, QStringList());
+            QCOMPARE(p.forwardedOutput, QStringList());
         } else {
             QCOMPARE(p.consoleOutput.join("").toLocal8Bit(), p.expectedContent);
+            QCOMPARE(p.forwardedOutput, p.consoleOutput);
         }
     }
 }
@@ -2799,6 +2889,8 @@ qbs::ErrorInfo TestApi::doBuildProject(
     if (procResultReceiver) {
         connect(buildJob.get(), &qbs::BuildJob::reportProcessResult,
                 procResultReceiver, &ProcessResultReceiver::handleProcessResult);
+        connect(buildJob.get(), &qbs::BuildJob::reportProcessOutput,
+                procResultReceiver, &ProcessResultReceiver::handleProcessOutput);
     }
     waitForFinished(buildJob.get());
     return buildJob->error();
@@ -67,6 +67,7 @@ private slots:
     void buildProjectDryRun();
     void buildProjectDryRun_data();
     void buildSingleFile();
+    void cancelWaitingBuild();
     void canonicalToolchainList();
 #ifdef QBS_ENABLE_PROJECT_FILE_UPDATES
     void changeContent();
@@ -75,6 +76,7 @@ private slots:
     void checkOutputs();
     void checkOutputs_data();
     void commandExtraction();
+    void commandOutputLimit();
     void disabledInstallGroup();
     void disabledProduct();
     void disabledProject();
@@ -0,0 +1,7 @@
+// Not a class that needs moc. Just someone being clever.
+#define Q_OBJECT 156
+
+int main()
+{
+    return Q_OBJECT - 156;
+}
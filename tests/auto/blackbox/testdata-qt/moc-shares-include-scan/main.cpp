@@ -0,0 +1,7 @@
+#include "object.h"
+
+int main()
+{
+    Object object;
+    return 0;
+}
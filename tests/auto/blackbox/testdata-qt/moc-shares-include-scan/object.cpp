@@ -0,0 +1,5 @@
+#include "object.h"
+
+Object::Object(QObject *parent) : QObject(parent)
+{
+}
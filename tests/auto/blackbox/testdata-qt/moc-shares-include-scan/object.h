@@ -0,0 +1,13 @@
+#ifndef OBJECT_H
+#define OBJECT_H
+
+#include <QObject>
+
+class Object : public QObject
+{
+    Q_OBJECT
+public:
+    Object(QObject *parent = nullptr);
+};
+
+#endif // OBJECT_H
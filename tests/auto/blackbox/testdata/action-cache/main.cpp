@@ -0,0 +1,6 @@
+#include <iostream>
+
+int main()
+{
+    std::cout << "original output" << std::endl;
+}
@@ -0,0 +1,6 @@
+#ifndef CHAIN1_H
+#define CHAIN1_H
+
+#include "chain2.h"
+
+#endif
@@ -0,0 +1,6 @@
+#ifndef CHAIN2_H
+#define CHAIN2_H
+
+#include "chain3.h"
+
+#endif
@@ -0,0 +1,6 @@
+#ifndef CHAIN3_H
+#define CHAIN3_H
+
+const int chainValue = 3;
+
+#endif
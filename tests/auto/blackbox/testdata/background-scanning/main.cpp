@@ -0,0 +1,9 @@
+#include "shared.h"
+
+int second();
+int third();
+
+int main()
+{
+    return second() + third() - 2 * chainValue;
+}
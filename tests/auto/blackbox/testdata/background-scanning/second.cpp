@@ -0,0 +1,6 @@
+#include "shared.h"
+
+int second()
+{
+    return chainValue;
+}
@@ -0,0 +1,6 @@
+#include "shared.h"
+
+int third()
+{
+    return chainValue;
+}
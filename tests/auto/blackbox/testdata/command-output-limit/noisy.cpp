@@ -0,0 +1,9 @@
+#include <iostream>
+
+int main()
+{
+    std::cout << "first line" << std::endl;
+    for (int i = 0; i < 100000; ++i)
+        std::cout << "This line is repeated very often to produce lots of output.\n";
+    std::cout << "last line" << std::endl;
+}
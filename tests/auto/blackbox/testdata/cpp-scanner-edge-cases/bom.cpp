@@ -0,0 +1,6 @@
+﻿#include "after-bom.h"
+
+int bom()
+{
+    return 0;
+}
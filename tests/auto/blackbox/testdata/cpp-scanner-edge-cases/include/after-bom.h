@@ -0,0 +1 @@
+// after-bom.h
@@ -0,0 +1 @@
+// after-char-literal.h
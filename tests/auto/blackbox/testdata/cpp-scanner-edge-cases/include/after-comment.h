@@ -0,0 +1 @@
+// after-comment.h
@@ -0,0 +1 @@
+// after-digit-separator.h
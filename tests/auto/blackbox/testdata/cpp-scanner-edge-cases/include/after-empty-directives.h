@@ -0,0 +1 @@
+// after-empty-directives.h
@@ -0,0 +1 @@
+// after-raw-string.h
@@ -0,0 +1 @@
+// before-raw-string.h
@@ -0,0 +1 @@
+// in-block-comment.h
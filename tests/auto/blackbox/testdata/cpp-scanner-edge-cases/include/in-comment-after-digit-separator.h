@@ -0,0 +1 @@
+// in-comment-after-digit-separator.h
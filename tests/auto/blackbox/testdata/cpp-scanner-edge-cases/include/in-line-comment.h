@@ -0,0 +1 @@
+// in-line-comment.h
@@ -0,0 +1 @@
+// in-macro-body.h
@@ -0,0 +1 @@
+// in-spliced-comment.h
@@ -0,0 +1 @@
+// in-string.h
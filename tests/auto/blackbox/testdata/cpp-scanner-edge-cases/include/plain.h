@@ -0,0 +1 @@
+// plain.h
@@ -0,0 +1,29 @@
+#include "plain.h"
+/* A comment */ #include "after-comment.h"
+#
+# /* A comment */
+#include "after-empty-directives.h"
+#define SOME_MACRO \
+#include "in-macro-body.h"
+// #include "in-line-comment.h"
+// A spliced line comment \
+#include "in-spliced-comment.h"
+/*
+#include "in-block-comment.h"
+*/
+const char *str = "\
+#include \"in-string.h\"";
+const int separated = 1'000; /* A comment
+#include "in-comment-after-digit-separator.h"
+*/
+#include "after-digit-separator.h"
+const char quote = '"';
+#include "after-char-literal.h"
+
+int bom();
+const char *rawString();
+
+int main()
+{
+    return separated == 1000 && quote && str && rawString() ? bom() : 1;
+}
@@ -0,0 +1,8 @@
+#include "before-raw-string.h"
+
+const char *rawString()
+{
+    return R"(a "raw" string)";
+}
+
+#include "after-raw-string.h"
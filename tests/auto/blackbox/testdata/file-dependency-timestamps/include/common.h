@@ -0,0 +1,6 @@
+#ifndef COMMON_H
+#define COMMON_H
+
+#define COMMON_VALUE 1
+
+#endif
@@ -0,0 +1,8 @@
+#ifndef HEADER1_H
+#define HEADER1_H
+
+#include "common.h"
+
+#define HEADER1_VALUE COMMON_VALUE
+
+#endif
@@ -0,0 +1,8 @@
+#ifndef HEADER2_H
+#define HEADER2_H
+
+#include "common.h"
+
+#define HEADER2_VALUE COMMON_VALUE
+
+#endif
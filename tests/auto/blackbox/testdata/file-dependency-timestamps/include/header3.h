@@ -0,0 +1,8 @@
+#ifndef HEADER3_H
+#define HEADER3_H
+
+#include "common.h"
+
+#define HEADER3_VALUE COMMON_VALUE
+
+#endif
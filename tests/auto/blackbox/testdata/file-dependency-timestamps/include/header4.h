@@ -0,0 +1,8 @@
+#ifndef HEADER4_H
+#define HEADER4_H
+
+#include "common.h"
+
+#define HEADER4_VALUE COMMON_VALUE
+
+#endif
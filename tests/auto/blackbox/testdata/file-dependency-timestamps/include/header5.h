@@ -0,0 +1,8 @@
+#ifndef HEADER5_H
+#define HEADER5_H
+
+#include "common.h"
+
+#define HEADER5_VALUE COMMON_VALUE
+
+#endif
@@ -0,0 +1,8 @@
+#ifndef HEADER6_H
+#define HEADER6_H
+
+#include "common.h"
+
+#define HEADER6_VALUE COMMON_VALUE
+
+#endif
@@ -0,0 +1,8 @@
+#ifndef HEADER7_H
+#define HEADER7_H
+
+#include "common.h"
+
+#define HEADER7_VALUE COMMON_VALUE
+
+#endif
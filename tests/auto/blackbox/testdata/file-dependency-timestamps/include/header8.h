@@ -0,0 +1,8 @@
+#ifndef HEADER8_H
+#define HEADER8_H
+
+#include "common.h"
+
+#define HEADER8_VALUE COMMON_VALUE
+
+#endif
@@ -0,0 +1,16 @@
+#include "common.h"
+
+int function1();
+int function2();
+int function3();
+int function4();
+int function5();
+int function6();
+int function7();
+int function8();
+
+int main()
+{
+    return function1() + function2() + function3() + function4() + function5() + function6()
+            + function7() + function8() - 8 * COMMON_VALUE;
+}
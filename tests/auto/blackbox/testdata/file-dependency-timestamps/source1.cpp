@@ -0,0 +1,6 @@
+#include "header1.h"
+
+int function1()
+{
+    return HEADER1_VALUE;
+}
@@ -0,0 +1,6 @@
+#include "header2.h"
+
+int function2()
+{
+    return HEADER2_VALUE;
+}
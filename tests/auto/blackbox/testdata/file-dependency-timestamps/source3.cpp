@@ -0,0 +1,6 @@
+#include "header3.h"
+
+int function3()
+{
+    return HEADER3_VALUE;
+}
@@ -0,0 +1,6 @@
+#include "header4.h"
+
+int function4()
+{
+    return HEADER4_VALUE;
+}
@@ -0,0 +1,6 @@
+#include "header5.h"
+
+int function5()
+{
+    return HEADER5_VALUE;
+}
@@ -0,0 +1,6 @@
+#include "header6.h"
+
+int function6()
+{
+    return HEADER6_VALUE;
+}
@@ -0,0 +1,6 @@
+#include "header7.h"
+
+int function7()
+{
+    return HEADER7_VALUE;
+}
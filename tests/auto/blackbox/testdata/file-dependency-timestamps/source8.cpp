@@ -0,0 +1,6 @@
+#include "header8.h"
+
+int function8()
+{
+    return HEADER8_VALUE;
+}
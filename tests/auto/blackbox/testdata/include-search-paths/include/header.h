@@ -0,0 +1 @@
+#define HEADER_VALUE 0
@@ -0,0 +1,6 @@
+#include "header.h"
+
+int libValue()
+{
+    return HEADER_VALUE;
+}
@@ -0,0 +1,10 @@
+#include "header.h"
+#include "other.h"
+#include "late.h"
+
+int libValue();
+
+int main()
+{
+    return libValue() + OTHER_VALUE + LATE_VALUE;
+}
@@ -0,0 +1,21 @@
+var File = require("qbs.File");
+var FileInfo = require("qbs.FileInfo");
+var TextFile = require("qbs.TextFile");
+
+// Runs for a while and writes the number of commands that were registered in runningDir at
+// the same time into the output file.
+function runTracked(runningDir, markerName, outputFilePath)
+{
+    File.makePath(runningDir);
+    var markerFilePath = FileInfo.joinPaths(runningDir, markerName);
+    var marker = new TextFile(markerFilePath, TextFile.WriteOnly);
+    marker.close();
+    var concurrency = File.directoryEntries(runningDir, File.Files).length;
+    var start = Date.now();
+    while (Date.now() - start < 300)
+        ;
+    File.remove(markerFilePath);
+    var out = new TextFile(outputFilePath, TextFile.WriteOnly);
+    out.writeLine(concurrency);
+    out.close();
+}
@@ -0,0 +1,9 @@
+#ifndef A_H
+#define A_H
+
+#include "b.h"
+#include "generated.h"
+
+const int aValue = GENERATED_VALUE;
+
+#endif
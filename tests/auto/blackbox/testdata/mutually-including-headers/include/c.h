@@ -0,0 +1,6 @@
+#ifndef C_H
+#define C_H
+
+const int cValue = 3;
+
+#endif
@@ -0,0 +1,6 @@
+#ifndef D_H
+#define D_H
+
+const int dValue = 4;
+
+#endif
@@ -0,0 +1,6 @@
+#include "a.h"
+
+int main()
+{
+    return aValue - GENERATED_VALUE;
+}
@@ -0,0 +1,7 @@
+#include "b.h"
+#include "d.h"
+
+int other()
+{
+    return aValue + dValue;
+}
@@ -40,6 +40,7 @@
 #include <tools/version.h>
 
 #include <QtCore/qdebug.h>
+#include <QtCore/qelapsedtimer.h>
 #include <QtCore/qjsonarray.h>
 #include <QtCore/qjsondocument.h>
 #include <QtCore/qjsonobject.h>
@@ -49,6 +50,11 @@
 #include <QtCore/qtemporarydir.h>
 #include <QtCore/qtemporaryfile.h>
 
+#ifdef Q_OS_UNIX
+#include <signal.h>
+#endif
+
+#include <algorithm>
 #include <functional>
 #include <regex>
 #include <utility>
@@ -318,6 +324,49 @@ TestBlackbox::TestBlackbox() : TestBlackboxBase (SRCDIR "/testdata", "blackbox")
 {
 }
 
+void TestBlackbox::actionCache()
+{
+    QDir::setCurrent(testDataDir + "/action-cache");
+    rmDirR("cache");
+    QbsRunParameters params(QStringList({"--action-cache", "cache"}));
+    params.buildDirectory = "build1";
+    QCOMPARE(runQbs(params), 0);
+    QVERIFY2(m_qbsStdout.contains("compiling main.cpp"), m_qbsStdout.constData());
+    QVERIFY2(!m_qbsStdout.contains("(from action cache)"), m_qbsStdout.constData());
+    QVERIFY2(m_qbsStdout.contains("Action cache: 0 hit(s)"), m_qbsStdout.constData());
+
+    // A different build directory can re-use the results.
+    params.buildDirectory = "build2";
+    QCOMPARE(runQbs(params), 0);
+    QVERIFY2(m_qbsStdout.contains("compiling main.cpp (from action cache)"),
+             m_qbsStdout.constData());
+    QVERIFY2(m_qbsStdout.contains(", 0 miss(es)"), m_qbsStdout.constData());
+    QbsRunParameters runParams("run");
+    runParams.buildDirectory = "build2";
+    QCOMPARE(runQbs(runParams), 0);
+    QVERIFY2(m_qbsStdout.contains("original output"), m_qbsStdout.constData());
+
+    // Changed input.
+    WAIT_FOR_NEW_TIMESTAMP();
+    REPLACE_IN_FILE("main.cpp", "original output", "changed output");
+    params.buildDirectory = "build2";
+    QCOMPARE(runQbs(params), 0);
+    QVERIFY2(m_qbsStdout.contains("compiling main.cpp"), m_qbsStdout.constData());
+    QVERIFY2(!m_qbsStdout.contains("(from action cache)"), m_qbsStdout.constData());
+    QVERIFY2(m_qbsStdout.contains("Action cache: 0 hit(s)"), m_qbsStdout.constData());
+    QCOMPARE(runQbs(runParams), 0);
+    QVERIFY2(m_qbsStdout.contains("changed output"), m_qbsStdout.constData());
+
+    // Without the option, nothing is looked up.
+    WAIT_FOR_NEW_TIMESTAMP();
+    REPLACE_IN_FILE("main.cpp", "changed output", "original output");
+    QbsRunParameters noCacheParams;
+    noCacheParams.buildDirectory = "build1";
+    QCOMPARE(runQbs(noCacheParams), 0);
+    QVERIFY2(m_qbsStdout.contains("compiling main.cpp"), m_qbsStdout.constData());
+    QVERIFY2(!m_qbsStdout.contains("Action cache:"), m_qbsStdout.constData());
+}
+
 void TestBlackbox::addFileTagToGeneratedArtifact()
 {
     QDir::setCurrent(testDataDir + "/add-filetag-to-generated-artifact");
@@ -765,6 +814,30 @@ static void readDepsOutput(const QString &depsFilePath, QJsonDocument &jsonDocum
     }
 }
 
+void TestBlackbox::criticalPath()
+{
+    QDir::setCurrent(testDataDir + "/critical-path");
+    rmDirR(relativeBuildDir());
+
+    // Without timing data, the dependency is built first.
+    const QbsRunParameters params(QStringList{"-j", "1"});
+    QCOMPARE(runQbs(params), 0);
+    int slowIndex = m_qbsStdout.indexOf("slow command for slow.in");
+    QVERIFY2(slowIndex != -1, m_qbsStdout.constData());
+    QVERIFY2(m_qbsStdout.indexOf("fast command for fast") < slowIndex, m_qbsStdout.constData());
+
+    // With the durations recorded in the build graph, the expensive command starts first.
+    WAIT_FOR_NEW_TIMESTAMP();
+    for (const QString &fileName : {"fast1.in", "fast2.in", "fast3.in", "slow.in"})
+        touch(fileName);
+    QCOMPARE(runQbs(params), 0);
+    slowIndex = m_qbsStdout.indexOf("slow command for slow.in");
+    QVERIFY2(slowIndex != -1, m_qbsStdout.constData());
+    const int fastIndex = m_qbsStdout.indexOf("fast command for fast");
+    QVERIFY2(fastIndex != -1, m_qbsStdout.constData());
+    QVERIFY2(slowIndex < fastIndex, m_qbsStdout.constData());
+}
+
 void TestBlackbox::dependenciesProperty()
 {
     QDir::setCurrent(testDataDir + QLatin1String("/dependenciesProperty"));
@@ -887,6 +960,42 @@ void TestBlackbox::deprecatedProperty()
     QVERIFY2(m_qbsStderr.count("was removed") == 1, m_qbsStderr.constData());
 }
 
+void TestBlackbox::detectUnchangedOutputs()
+{
+    QDir::setCurrent(testDataDir + "/detect-unchanged-outputs");
+    rmDirR(relativeBuildDir());
+    const QbsRunParameters params(QStringList("--detect-unchanged-outputs"));
+    QCOMPARE(runQbs(params), 0);
+    QVERIFY2(m_qbsStdout.contains("generating generated.txt"), m_qbsStdout.constData());
+    QVERIFY2(m_qbsStdout.contains("consuming generated.txt"), m_qbsStdout.constData());
+
+    // The generator re-runs, but its output does not change.
+    WAIT_FOR_NEW_TIMESTAMP();
+    touch("input.txt");
+    QCOMPARE(runQbs(params), 0);
+    QVERIFY2(m_qbsStdout.contains("generating generated.txt"), m_qbsStdout.constData());
+    QVERIFY2(!m_qbsStdout.contains("consuming generated.txt"), m_qbsStdout.constData());
+
+    // Nothing to do, even though the generated file has a new timestamp on disk.
+    QCOMPARE(runQbs(params), 0);
+    QVERIFY2(!m_qbsStdout.contains("generating generated.txt"), m_qbsStdout.constData());
+    QVERIFY2(!m_qbsStdout.contains("consuming generated.txt"), m_qbsStdout.constData());
+
+    // The generator's output changes.
+    WAIT_FOR_NEW_TIMESTAMP();
+    REPLACE_IN_FILE("input.txt", "original", "modified");
+    QCOMPARE(runQbs(params), 0);
+    QVERIFY2(m_qbsStdout.contains("generating generated.txt"), m_qbsStdout.constData());
+    QVERIFY2(m_qbsStdout.contains("consuming generated.txt"), m_qbsStdout.constData());
+
+    // Without the option, everything downstream is rebuilt.
+    WAIT_FOR_NEW_TIMESTAMP();
+    touch("input.txt");
+    QCOMPARE(runQbs(), 0);
+    QVERIFY2(m_qbsStdout.contains("generating generated.txt"), m_qbsStdout.constData());
+    QVERIFY2(m_qbsStdout.contains("consuming generated.txt"), m_qbsStdout.constData());
+}
+
 void TestBlackbox::disappearedProfile()
 {
     QDir::setCurrent(testDataDir + "/disappeared-profile");
@@ -1346,6 +1455,74 @@ void TestBlackbox::versionScript()
     QVERIFY2(globalSymbols.contains("dummyGlobal"), allSymbols.constData());
 }
 
+void TestBlackbox::watchMode()
+{
+    if (HostOsInfo::isWindowsHost())
+        QSKIP("Interrupting qbs is only implemented for Unix in this test");
+    QDir::setCurrent(testDataDir + "/watch-mode");
+    rmDirR(relativeBuildDir());
+    QProcess qbs;
+    qbs.setProcessChannelMode(QProcess::MergedChannels);
+    qbs.start(qbsExecutableFilePath, QStringList({"build", "--watch", "--settings-dir",
+                                                  settings()->baseDirectory(), "-d", ".",
+                                                  "profile:" + profileName()}));
+    QVERIFY(qbs.waitForStarted());
+    QByteArray output;
+    const auto waitForIdle = [&qbs, &output] {
+        QElapsedTimer timer;
+        timer.start();
+        while (!output.contains("Watching for changes")
+               && qbs.state() == QProcess::Running && timer.elapsed() < testTimeoutInMsecs()) {
+            qbs.waitForReadyRead(1000);
+            output += qbs.readAll();
+        }
+        return output.contains("Watching for changes");
+    };
+
+    // Changes that cannot affect the build must not start a new cycle.
+    const auto staysIdle = [&qbs, &output] {
+        qbs.waitForReadyRead(2000);
+        output += qbs.readAll();
+        return output.isEmpty();
+    };
+
+    QVERIFY2(waitForIdle(), output.constData());
+    QCOMPARE(output.count("processing listed.txt"), 1);
+    QCOMPARE(output.count("processing a.txt"), 1);
+
+    // Files next to the sources that are not part of the project are ignored,
+    // whether they get modified or created.
+    output.clear();
+    WAIT_FOR_NEW_TIMESTAMP();
+    REPLACE_IN_FILE("listed/notes.log", "some", "more");
+    QVERIFY2(staysIdle(), output.constData());
+    touch("listed/scratch.dat");
+    QVERIFY2(staysIdle(), output.constData());
+
+    // A file appearing in a directory covered by a wildcard gets picked up.
+    touch("wildcards/b.txt");
+    QVERIFY2(waitForIdle(), output.constData());
+    QCOMPARE(output.count("processing b.txt"), 1);
+    QVERIFY2(!output.contains("processing a.txt"), output.constData());
+    QVERIFY2(!output.contains("processing listed.txt"), output.constData());
+
+    // Modifying a source file rebuilds just what depends on it.
+    output.clear();
+    WAIT_FOR_NEW_TIMESTAMP();
+    REPLACE_IN_FILE("listed/listed.txt", "original", "modified");
+    QVERIFY2(waitForIdle(), output.constData());
+    QCOMPARE(output.count("processing listed.txt"), 1);
+    QVERIFY2(!output.contains("processing a.txt"), output.constData());
+    QVERIFY2(!output.contains("processing b.txt"), output.constData());
+
+#ifdef Q_OS_UNIX
+    ::kill(qbs.processId(), SIGINT);
+#endif
+    QVERIFY(qbs.waitForFinished(testTimeoutInMsecs()));
+    QCOMPARE(qbs.exitStatus(), QProcess::NormalExit);
+    QCOMPARE(qbs.exitCode(), 0);
+}
+
 void TestBlackbox::wholeArchive()
 {
     QDir::setCurrent(testDataDir + "/whole-archive");
@@ -1555,6 +1732,40 @@ void TestBlackbox::conflictingArtifacts()
     QVERIFY2(m_qbsStderr.contains("Conflicting artifacts"), m_qbsStderr.constData());
 }
 
+void TestBlackbox::cppScannerEdgeCases()
+{
+    QDir::setCurrent(testDataDir + "/cpp-scanner-edge-cases");
+    QCOMPARE(runQbs(QbsRunParameters(QStringList("-vv"))), 0);
+
+    // All headers exist, so every include directive the scanner finds shows up as
+    // a file dependency.
+    const auto isDependency = [this](const char *header) {
+        return m_qbsStderr.contains(QByteArray("include/") + header + ".h\"");
+    };
+    const char * const expectedDependencies[] = {
+        "plain", "after-comment", "after-empty-directives", "after-digit-separator",
+        "after-char-literal", "after-bom", "before-raw-string", "after-raw-string"
+    };
+    for (const char * const header : expectedDependencies)
+        QVERIFY2(isDependency(header), header);
+    const char * const unexpectedDependencies[] = {
+        "in-macro-body", "in-line-comment", "in-spliced-comment", "in-block-comment",
+        "in-string", "in-comment-after-digit-separator"
+    };
+    for (const char * const header : unexpectedDependencies)
+        QVERIFY2(!isDependency(header), header);
+
+    WAIT_FOR_NEW_TIMESTAMP();
+    touch("include/after-bom.h");
+    QCOMPARE(runQbs(), 0);
+    QVERIFY2(m_qbsStdout.contains("compiling bom.cpp"), m_qbsStdout.constData());
+    QVERIFY2(!m_qbsStdout.contains("compiling main.cpp"), m_qbsStdout.constData());
+    WAIT_FOR_NEW_TIMESTAMP();
+    touch("include/in-spliced-comment.h");
+    QCOMPARE(runQbs(), 0);
+    QVERIFY2(!m_qbsStdout.contains("compiling"), m_qbsStdout.constData());
+}
+
 void TestBlackbox::cxxLanguageVersion()
 {
     QDir::setCurrent(testDataDir + "/cxx-language-version");
@@ -2303,6 +2514,128 @@ void TestBlackbox::ruleWithNonRequiredInputs()
     QVERIFY2(m_qbsStdout.contains("Generating"), m_qbsStdout.constData());
 }
 
+static QByteArray sessionRequest(const QJsonObject &request)
+{
+    return QJsonDocument(request).toJson(QJsonDocument::Compact) + '\n';
+}
+
+void TestBlackbox::session()
+{
+    QDir::setCurrent(testDataDir + "/session");
+    QProcess qbsSession;
+    qbsSession.start(qbsExecutableFilePath, QStringList({"session", "--settings-dir",
+                                                         settings()->baseDirectory()}));
+    QVERIFY(qbsSession.waitForStarted());
+
+    // Sends the request and returns the reply that concludes it, collecting the command
+    // descriptions on the way.
+    QByteArray pendingOutput;
+    QStringList descriptions;
+    const auto sendRequest = [&](const QByteArray &request) {
+        descriptions.clear();
+        qbsSession.write(request);
+        while (true) {
+            const int newline = pendingOutput.indexOf('\n');
+            if (newline == -1) {
+                if (!qbsSession.waitForReadyRead(testTimeoutInMsecs()))
+                    return QJsonObject();
+                pendingOutput += qbsSession.readAllStandardOutput();
+                continue;
+            }
+            const QJsonObject reply = QJsonDocument::fromJson(pendingOutput.left(newline))
+                    .object();
+            pendingOutput.remove(0, newline + 1);
+            const QString type = reply.value("type").toString();
+            if (type == "command-description")
+                descriptions << reply.value("message").toString();
+            else if (type != "hello" && type != "log-data" && type != "warning"
+                     && type != "process-result" && !type.startsWith("task-"))
+                return reply;
+        }
+    };
+    const auto expectReply = [](const QJsonObject &reply, const QString &type) {
+        if (reply.value("type").toString() != type || reply.contains("error")) {
+            qDebug() << "Unexpected reply:" << QJsonDocument(reply).toJson();
+            return false;
+        }
+        return true;
+    };
+
+    QJsonObject resolveRequest;
+    resolveRequest.insert("type", "resolve-project");
+    resolveRequest.insert("project-file-path", QDir::currentPath() + "/session.qbs");
+    resolveRequest.insert("build-root", QDir::currentPath());
+    resolveRequest.insert("top-level-profile", profileName());
+    QVERIFY(expectReply(sendRequest(sessionRequest(resolveRequest)), "project-resolved"));
+
+    // Only the requested product gets built.
+    QJsonObject buildRequest;
+    buildRequest.insert("type", "build-project");
+    buildRequest.insert("products", QJsonArray({"upper"}));
+    QVERIFY(expectReply(sendRequest(sessionRequest(buildRequest)), "project-built"));
+    QCOMPARE(descriptions, QStringList({"converting upper.txt"}));
+    const QString upperOutput = relativeProductBuildDir("upper") + "/upper.converted";
+    const QString lowerOutput = relativeProductBuildDir("lower") + "/lower.converted";
+    QVERIFY(regularFileExists(upperOutput));
+    QVERIFY(!regularFileExists(lowerOutput));
+    buildRequest.remove("products");
+    QVERIFY(expectReply(sendRequest(sessionRequest(buildRequest)), "project-built"));
+    QCOMPARE(descriptions, QStringList({"converting lower.txt"}));
+    QFile upperOutputFile(upperOutput);
+    QVERIFY(upperOutputFile.open(QIODevice::ReadOnly));
+    QCOMPARE(upperOutputFile.readAll().trimmed(), QByteArray("SOME TEXT"));
+    upperOutputFile.close();
+
+    // The build data is kept in memory, so the build graph file is not needed anymore,
+    // and only the files reported as changed get looked at.
+    QVERIFY(QFile::remove(relativeBuildGraphFilePath()));
+    WAIT_FOR_NEW_TIMESTAMP();
+    touch("upper.txt");
+    touch("lower.txt");
+    buildRequest.insert("changed-files", QJsonArray({QDir::currentPath() + "/upper.txt"}));
+    QVERIFY(expectReply(sendRequest(sessionRequest(buildRequest)), "project-built"));
+    QCOMPARE(descriptions, QStringList({"converting upper.txt"}));
+    buildRequest.remove("changed-files");
+
+    // Re-resolving the current project takes over its build data.
+    resolveRequest = QJsonObject();
+    resolveRequest.insert("type", "resolve-project");
+    QVERIFY(expectReply(sendRequest(sessionRequest(resolveRequest)), "project-resolved"));
+    QVERIFY(expectReply(sendRequest(sessionRequest(buildRequest)), "project-built"));
+    QCOMPARE(descriptions, QStringList({"converting lower.txt"}));
+    QVERIFY(expectReply(sendRequest(sessionRequest(buildRequest)), "project-built"));
+    QVERIFY2(descriptions.empty(), qPrintable(descriptions.join(", ")));
+
+    QJsonObject projectDataRequest;
+    projectDataRequest.insert("type", "get-project-data");
+    const QJsonObject projectDataReply = sendRequest(sessionRequest(projectDataRequest));
+    QVERIFY(expectReply(projectDataReply, "project-data"));
+    QStringList productNames;
+    const QJsonArray products = projectDataReply.value("project-data").toObject()
+            .value("products").toArray();
+    for (const QJsonValue &product : products)
+        productNames << product.toObject().value("name").toString();
+    productNames.sort();
+    QCOMPARE(productNames, QStringList({"lower", "upper"}));
+
+    QJsonObject cleanRequest;
+    cleanRequest.insert("type", "clean-project");
+    cleanRequest.insert("products", QJsonArray({"lower"}));
+    QVERIFY(expectReply(sendRequest(sessionRequest(cleanRequest)), "project-cleaned"));
+    QVERIFY(regularFileExists(upperOutput));
+    QVERIFY(!regularFileExists(lowerOutput));
+
+    // A malformed request does not end the session.
+    const QJsonObject errorReply = sendRequest("this is not json\n");
+    QCOMPARE(errorReply.value("type").toString(), QString("protocol-error"));
+    QVERIFY(expectReply(sendRequest(sessionRequest(buildRequest)), "project-built"));
+    QCOMPARE(descriptions, QStringList({"converting lower.txt"}));
+
+    qbsSession.closeWriteChannel();
+    QVERIFY(qbsSession.waitForFinished(testTimeoutInMsecs()));
+    QCOMPARE(qbsSession.exitCode(), 0);
+}
+
 void TestBlackbox::setupBuildEnvironment()
 {
     QDir::setCurrent(testDataDir + "/setup-build-environment");
@@ -3313,6 +3646,47 @@ void TestBlackbox::externalLibs()
     QCOMPARE(runQbs(), 0);
 }
 
+void TestBlackbox::fileDependencyTimestamps()
+{
+    QDir::setCurrent(testDataDir + "/file-dependency-timestamps");
+    const QbsRunParameters params(QStringList{"-j", "4", "--log-time"});
+    QCOMPARE(runQbs(params), 0);
+    QCOMPARE(m_qbsStdout.count("compiling"), 9);
+
+    QCOMPARE(runQbs(params), 0);
+    QVERIFY2(!m_qbsStdout.contains("compiling"), m_qbsStdout.constData());
+    QVERIFY2(m_qbsStdout.contains("Retrieving source file timestamps took"),
+             m_qbsStdout.constData());
+
+    // The timestamps of all file dependencies are retrieved up front, concurrently.
+    // Only the ones that changed must cause recompilation.
+    WAIT_FOR_NEW_TIMESTAMP();
+    touch("include/header5.h");
+    QCOMPARE(runQbs(params), 0);
+    QVERIFY2(m_qbsStdout.contains("compiling source5.cpp"), m_qbsStdout.constData());
+    QCOMPARE(m_qbsStdout.count("compiling"), 1);
+
+    WAIT_FOR_NEW_TIMESTAMP();
+    touch("include/common.h");
+    QCOMPARE(runQbs(params), 0);
+    QCOMPARE(m_qbsStdout.count("compiling"), 9);
+
+    // A file dependency that has vanished is noticed as well.
+    WAIT_FOR_NEW_TIMESTAMP();
+    REPLACE_IN_FILE("source3.cpp", "#include \"header3.h\"", "#include \"header2.h\"");
+    REPLACE_IN_FILE("source3.cpp", "HEADER3_VALUE", "HEADER2_VALUE");
+    QVERIFY(QFile::remove("include/header3.h"));
+    QCOMPARE(runQbs(params), 0);
+    QVERIFY2(m_qbsStdout.contains("compiling source3.cpp"), m_qbsStdout.constData());
+    QCOMPARE(m_qbsStdout.count("compiling"), 1);
+    WAIT_FOR_NEW_TIMESTAMP();
+    touch("include/header2.h");
+    QCOMPARE(runQbs(params), 0);
+    QVERIFY2(m_qbsStdout.contains("compiling source2.cpp"), m_qbsStdout.constData());
+    QVERIFY2(m_qbsStdout.contains("compiling source3.cpp"), m_qbsStdout.constData());
+    QCOMPARE(m_qbsStdout.count("compiling"), 2);
+}
+
 void TestBlackbox::fileDependencies()
 {
     QDir::setCurrent(testDataDir + "/fileDependencies");
@@ -3518,6 +3892,70 @@ void TestBlackbox::invalidInstallDir()
     QVERIFY2(m_qbsStderr.contains("outside of install root"), m_qbsStderr.constData());
 }
 
+void TestBlackbox::jobPools()
+{
+    QDir::setCurrent(testDataDir + "/job-pools");
+    rmDirR("running");
+    rmDirR(relativeBuildDir("a"));
+    rmDirR(relativeBuildDir("b"));
+
+    // The limit applies to all configurations together and only to the commands of its pool.
+    const QbsRunParameters params(QStringList({"-j", "4", "--job-limits", "linker:1",
+                                               "config:a", "config:b"}));
+    QCOMPARE(runQbs(params), 0);
+    QCOMPARE(m_qbsStdout.count("compiling"), 6);
+    QCOMPARE(m_qbsStdout.count("linking"), 6);
+    const auto maxConcurrency = [](const QString &extension, const QString &baseName) {
+        int concurrency = 0;
+        for (const QString &configName : {QStringLiteral("a"), QStringLiteral("b")}) {
+            for (int i = 1; i <= 3; ++i) {
+                QFile output(relativeProductBuildDir("pools", configName) + '/' + baseName
+                             + QString::number(i) + '.' + extension);
+                if (!output.open(QIODevice::ReadOnly))
+                    return -1;
+                concurrency = std::max(concurrency, output.readAll().trimmed().toInt());
+            }
+        }
+        return concurrency;
+    };
+    QCOMPARE(maxConcurrency("linked", "image"), 1);
+    QVERIFY(maxConcurrency("compiled", "unit") > 1);
+}
+
+void TestBlackbox::jobServer()
+{
+    if (HostOsInfo::isWindowsHost())
+        QSKIP("jobserver support is Unix-only");
+    QDir::setCurrent(testDataDir + "/jobserver");
+    QbsRunParameters params(QStringList({"-j", "3", "--jobserver"}));
+    params.environment.remove("MAKEFLAGS");
+    QCOMPARE(runQbs(params), 0);
+    QVERIFY2(m_qbsStdout.contains("make flags: -j3 --jobserver-auth=fifo:"),
+             m_qbsStdout.constData());
+}
+
+void TestBlackbox::jobSlotPool()
+{
+    QDir::setCurrent(testDataDir + "/job-slot-pool");
+    rmDirR("running");
+
+    // The job count applies to all configurations together, and all of it gets used.
+    const QbsRunParameters params(QStringList({"-j", "2", "config:debug", "config:release"}));
+    QCOMPARE(runQbs(params), 0);
+    QCOMPARE(m_qbsStdout.count("compressing"), 8);
+    int maxConcurrency = 0;
+    for (const QString &configName : {QStringLiteral("debug"), QStringLiteral("release")}) {
+        for (int i = 1; i <= 4; ++i) {
+            QFile output(relativeProductBuildDir("archive", configName)
+                         + QStringLiteral("/part%1.compressed").arg(i));
+            QVERIFY2(output.open(QIODevice::ReadOnly), qPrintable(output.fileName()));
+            maxConcurrency = std::max(maxConcurrency, output.readAll().trimmed().toInt());
+        }
+    }
+    QCOMPARE(maxConcurrency, 2);
+    QVERIFY(QDir("running").entryList(QDir::Files).empty());
+}
+
 void TestBlackbox::cli()
 {
     int status;
@@ -3581,6 +4019,19 @@ void TestBlackbox::commandFile()
     QCOMPARE(runQbs(params), 0);
 }
 
+void TestBlackbox::commandOutputLimit()
+{
+    QDir::setCurrent(testDataDir + "/command-output-limit");
+    QCOMPARE(runQbs(), 0);
+    QVERIFY2(m_qbsStdout.contains("running noisy tool"), m_qbsStdout.constData());
+
+    // The output is printed while the command is running, so it is complete, even though
+    // only part of it is retained for the final result. It is not printed a second time.
+    QCOMPARE(m_qbsStdout.count("first line"), 1);
+    QCOMPARE(m_qbsStdout.count("last line"), 1);
+    QVERIFY(!m_qbsStdout.contains("bytes of further output were discarded"));
+}
+
 void TestBlackbox::compilerDefinesByLanguage()
 {
     QDir::setCurrent(testDataDir + "/compilerDefinesByLanguage");
@@ -3588,6 +4039,27 @@ void TestBlackbox::compilerDefinesByLanguage()
     QCOMPARE(runQbs(params), 0);
 }
 
+void TestBlackbox::compressedBuildGraph()
+{
+    QDir::setCurrent(testDataDir + "/compressed-build-graph");
+    qbs::Settings settings(QDir::currentPath() + "/settings-dir");
+    qbs::Profile profile("p", &settings);
+    profile.setValue("preferences.compressBuildGraph", true);
+    settings.sync();
+    QbsRunParameters params(QStringList("--log-time"));
+    params.settingsDir = settings.baseDirectory();
+    params.profile = profile.name();
+    QCOMPARE(runQbs(params), 0);
+    QVERIFY2(m_qbsStdout.contains("creating out.txt"), m_qbsStdout.constData());
+    QVERIFY2(m_qbsStdout.contains("compressed to"), m_qbsStdout.constData());
+
+    // The compressed build graph must be readable again.
+    params.arguments.clear();
+    params.profile.clear();
+    QCOMPARE(runQbs(params), 0);
+    QVERIFY2(!m_qbsStdout.contains("creating out.txt"), m_qbsStdout.constData());
+}
+
 void TestBlackbox::jsExtensionsFile()
 {
     QDir::setCurrent(testDataDir + "/jsextensions-file");
@@ -3994,6 +4466,49 @@ void TestBlackbox::multipleChanges()
     QVERIFY(m_qbsStdout.contains("prop: true"));
 }
 
+void TestBlackbox::mutuallyIncludingHeaders()
+{
+    // a.h and b.h include each other, so they share their transitive dependencies,
+    // which also contain a generated header.
+    QDir::setCurrent(testDataDir + "/mutually-including-headers");
+    QCOMPARE(runQbs(), 0);
+    QVERIFY2(m_qbsStdout.contains("generating generated.h"), m_qbsStdout.constData());
+    QVERIFY2(m_qbsStdout.contains("compiling main.cpp"), m_qbsStdout.constData());
+    QVERIFY2(m_qbsStdout.contains("compiling other.cpp"), m_qbsStdout.constData());
+
+    // c.h is only reachable via the cycle.
+    WAIT_FOR_NEW_TIMESTAMP();
+    touch("include/c.h");
+    QCOMPARE(runQbs(), 0);
+    QVERIFY2(m_qbsStdout.contains("compiling main.cpp"), m_qbsStdout.constData());
+    QVERIFY2(m_qbsStdout.contains("compiling other.cpp"), m_qbsStdout.constData());
+
+    WAIT_FOR_NEW_TIMESTAMP();
+    REPLACE_IN_FILE("generated.h.in", "1", "2");
+    QCOMPARE(runQbs(), 0);
+    QVERIFY2(m_qbsStdout.contains("generating generated.h"), m_qbsStdout.constData());
+    QVERIFY2(m_qbsStdout.contains("compiling main.cpp"), m_qbsStdout.constData());
+    QVERIFY2(m_qbsStdout.contains("compiling other.cpp"), m_qbsStdout.constData());
+
+    // d.h is outside the cycle and only included by other.cpp.
+    WAIT_FOR_NEW_TIMESTAMP();
+    touch("include/d.h");
+    QCOMPARE(runQbs(), 0);
+    QVERIFY2(!m_qbsStdout.contains("compiling main.cpp"), m_qbsStdout.constData());
+    QVERIFY2(m_qbsStdout.contains("compiling other.cpp"), m_qbsStdout.constData());
+
+    // Once the cycle no longer includes c.h, it is not a dependency anymore.
+    WAIT_FOR_NEW_TIMESTAMP();
+    REPLACE_IN_FILE("include/b.h", "#include \"c.h\"", "");
+    QCOMPARE(runQbs(), 0);
+    QVERIFY2(m_qbsStdout.contains("compiling main.cpp"), m_qbsStdout.constData());
+    QVERIFY2(m_qbsStdout.contains("compiling other.cpp"), m_qbsStdout.constData());
+    WAIT_FOR_NEW_TIMESTAMP();
+    touch("include/c.h");
+    QCOMPARE(runQbs(), 0);
+    QVERIFY2(!m_qbsStdout.contains("compiling"), m_qbsStdout.constData());
+}
+
 void TestBlackbox::nestedGroups()
 {
     QDir::setCurrent(testDataDir + "/nested-groups");
@@ -5152,6 +5667,30 @@ void TestBlackbox::includeLookup()
     QVERIFY2(m_qbsStdout.contains("definition.."), m_qbsStdout.constData());
 }
 
+void TestBlackbox::includeSearchPaths()
+{
+    QDir::setCurrent(testDataDir + "/include-search-paths");
+    QCOMPARE(runQbs(QbsRunParameters(QStringList("-vv"))), 0);
+
+    // The header generated into the first include path was written after that directory
+    // had already been looked at for lib.cpp.
+    QVERIFY2(m_qbsStderr.contains("/include/header.h\""), m_qbsStderr.constData());
+    QVERIFY2(m_qbsStderr.contains("/other-include/other.h\""), m_qbsStderr.constData());
+    QVERIFY2(m_qbsStderr.contains("/generated-include/late.h\""), m_qbsStderr.constData());
+    QVERIFY2(!m_qbsStderr.contains("unresolved dependency"), m_qbsStderr.constData());
+
+    WAIT_FOR_NEW_TIMESTAMP();
+    touch("include/header.h");
+    QCOMPARE(runQbs(), 0);
+    QVERIFY2(m_qbsStdout.contains("compiling lib.cpp"), m_qbsStdout.constData());
+    QVERIFY2(m_qbsStdout.contains("compiling main.cpp"), m_qbsStdout.constData());
+    WAIT_FOR_NEW_TIMESTAMP();
+    touch("other-include/other.h");
+    QCOMPARE(runQbs(), 0);
+    QVERIFY2(!m_qbsStdout.contains("compiling lib.cpp"), m_qbsStdout.constData());
+    QVERIFY2(m_qbsStdout.contains("compiling main.cpp"), m_qbsStdout.constData());
+}
+
 static bool haveInnoSetup(const Profile &profile)
 {
     if (profile.value("innosetup.toolchainInstallPath").isValid())
@@ -5490,6 +6029,27 @@ void TestBlackbox::movedFileDependency()
     QVERIFY2(!m_qbsStdout.contains("compiling main.cpp"), m_qbsStdout.constData());
 }
 
+void TestBlackbox::backgroundScanning()
+{
+    // The headers are scanned on worker threads. The compiler transformers wait for each level
+    // of the include chain and then get scheduled again. Every header is still scanned only once,
+    // even though all sources include it.
+    QDir::setCurrent(testDataDir + "/background-scanning");
+    const QbsRunParameters params(QStringList("-vv"));
+    QCOMPARE(runQbs(params), 0);
+    QVERIFY2(m_qbsStderr.contains("background scan"), m_qbsStderr.constData());
+    for (const char * const header : {"shared.h", "chain1.h", "chain2.h", "chain3.h"})
+        QCOMPARE(m_qbsStderr.count(QByteArray("scanning \"") + header + '"'), 1);
+    QCOMPARE(m_qbsStdout.count("compiling"), 3);
+
+    WAIT_FOR_NEW_TIMESTAMP();
+    touch("include/chain3.h");
+    QCOMPARE(runQbs(params), 0);
+    QCOMPARE(m_qbsStderr.count("scanning \"chain2.h\""), 0);
+    QCOMPARE(m_qbsStderr.count("scanning \"chain3.h\""), 1);
+    QCOMPARE(m_qbsStdout.count("compiling"), 3);
+}
+
 void TestBlackbox::badInterpreter()
 {
     if (!HostOsInfo::isAnyUnixHost())
@@ -5559,6 +6119,69 @@ void TestBlackbox::qbsVersion()
     QVERIFY(runQbs(params) != 0);
 }
 
+void TestBlackbox::traceFile()
+{
+    QDir::setCurrent(testDataDir + "/trace-file");
+    rmDirR(relativeBuildDir("a"));
+    rmDirR(relativeBuildDir("b"));
+    QCOMPARE(runQbs(QbsRunParameters(QStringList({"--trace-file", "trace.json",
+                                                  "config:a", "config:b"}))), 0);
+    QFile traceFile("trace.json");
+    QVERIFY2(traceFile.open(QIODevice::ReadOnly), qPrintable(traceFile.errorString()));
+    QJsonParseError parseError;
+    const QJsonDocument trace = QJsonDocument::fromJson(traceFile.readAll(), &parseError);
+    QVERIFY2(parseError.error == QJsonParseError::NoError,
+             qPrintable(parseError.errorString()));
+    QSet<QString> categories;
+    QSet<QString> processNames;
+    QSet<QString> threadNames;
+    QSet<int> commandProcessIds;
+    QMap<QPair<int, int>, QList<QPair<double, double>>> commandsPerThread;
+    const QJsonArray events = trace.object().value("traceEvents").toArray();
+    for (const QJsonValue &v : events) {
+        const QJsonObject event = v.toObject();
+        if (event.value("ph").toString() == "M") {
+            const QString name = event.value("args").toObject().value("name").toString();
+            if (event.value("name").toString() == "process_name")
+                processNames << name;
+            else
+                threadNames << name;
+            continue;
+        }
+        QCOMPARE(event.value("ph").toString(), QString("X"));
+        QVERIFY(event.value("dur").toDouble() >= 0);
+        const QString category = event.value("cat").toString();
+        const int pid = event.value("pid").toInt();
+        const int tid = event.value("tid").toInt();
+        categories << category;
+        if (category == "command") {
+            QCOMPARE(event.value("name").toString(), QString("creating output"));
+            QVERIFY(pid > 1);
+            QVERIFY(tid > 0);
+            commandProcessIds << pid;
+            commandsPerThread[qMakePair(pid, tid)] << qMakePair(event.value("ts").toDouble(),
+                    event.value("ts").toDouble() + event.value("dur").toDouble());
+        } else {
+            QCOMPARE(pid > 1, category == "rule" || category == "scan");
+            QVERIFY(tid >= 100000);
+        }
+    }
+    QVERIFY2(categories.contains("resolve"), qPrintable(categories.toList().join(',')));
+    QVERIFY2(categories.contains("probe"), qPrintable(categories.toList().join(',')));
+    QVERIFY2(categories.contains("rule"), qPrintable(categories.toList().join(',')));
+    QVERIFY2(categories.contains("command"), qPrintable(categories.toList().join(',')));
+    QCOMPARE(commandProcessIds.size(), 2);
+    for (QList<QPair<double, double>> intervals : qAsConst(commandsPerThread)) {
+        std::sort(intervals.begin(), intervals.end());
+        for (int i = 1; i < intervals.size(); ++i)
+            QVERIFY(intervals.at(i - 1).second <= intervals.at(i).first);
+    }
+    QVERIFY(processNames.contains("qbs"));
+    QVERIFY(processNames.contains("build a"));
+    QVERIFY(processNames.contains("build b"));
+    QVERIFY(threadNames.contains("J1"));
+}
+
 void TestBlackbox::transitiveOptionalDependencies()
 {
     QDir::setCurrent(testDataDir + "/transitive-optional-dependencies");
@@ -39,6 +39,7 @@ public:
     TestBlackbox();
 
 private slots:
+    void actionCache();
     void addFileTagToGeneratedArtifact();
     void alwaysRun();
     void alwaysRun_data();
@@ -48,6 +49,7 @@ private slots:
     void artifactScanning();
     void assembly();
     void auxiliaryInputsFromDependencies();
+    void backgroundScanning();
     void badInterpreter();
     void buildDataOfDisabledProduct();
     void buildDirectories();
@@ -66,18 +68,23 @@ private slots:
     void cli();
     void combinedSources();
     void commandFile();
+    void commandOutputLimit();
     void compilerDefinesByLanguage();
+    void compressedBuildGraph();
     void concurrentExecutor();
     void conditionalExport();
     void conditionalFileTagger();
     void configure();
     void conflictingArtifacts();
+    void cppScannerEdgeCases();
     void cxxLanguageVersion();
     void cxxLanguageVersion_data();
     void cpuFeatures();
+    void criticalPath();
     void dependenciesProperty();
     void dependencyProfileMismatch();
     void deprecatedProperty();
+    void detectUnchangedOutputs();
     void disappearedProfile();
     void discardUnusedData();
     void discardUnusedData_data();
@@ -104,6 +111,7 @@ private slots:
     void exportToOutsideSearchPath();
     void externalLibs();
     void fileDependencies();
+    void fileDependencyTimestamps();
     void generatedArtifactAsInputToDynamicRule();
     void groupsInModules();
     void ico();
@@ -113,6 +121,7 @@ private slots:
     void importingProduct();
     void importsConflict();
     void includeLookup();
+    void includeSearchPaths();
     void innoSetup();
     void innoSetupDependencies();
     void inputsFromDependencies();
@@ -132,6 +141,9 @@ private slots:
     void invalidInstallDir();
     void invalidLibraryNames();
     void invalidLibraryNames_data();
+    void jobPools();
+    void jobServer();
+    void jobSlotPool();
     void jsExtensionsFile();
     void jsExtensionsFileInfo();
     void jsExtensionsProcess();
@@ -157,6 +169,7 @@ private slots:
     void missingOverridePrefix();
     void movedFileDependency();
     void multipleChanges();
+    void mutuallyIncludingHeaders();
     void nestedGroups();
     void nestedProperties();
     void newOutputArtifact();
@@ -206,6 +219,7 @@ private slots:
     void ruleCycle();
     void ruleWithNoInputs();
     void ruleWithNonRequiredInputs();
+    void session();
     void setupBuildEnvironment();
     void setupRunEnvironment();
     void smartRelinking();
@@ -237,6 +251,7 @@ private slots:
     void trackRemoveFile();
     void trackRemoveFileTag();
     void trackRemoveProduct();
+    void traceFile();
     void transitiveOptionalDependencies();
     void typescript();
     void usingsAsSoleInputsNonMultiplexed();
@@ -247,6 +262,7 @@ private slots:
     void versionCheck();
     void versionCheck_data();
     void versionScript();
+    void watchMode();
     void wholeArchive();
     void wholeArchive_data();
     void wildCardsAndRules();
@@ -130,6 +130,13 @@ void TestBlackboxQt::dbusInterfaces()
     QCOMPARE(runQbs(), 0);
 }
 
+void TestBlackboxQt::definedQObjectMacro()
+{
+    QDir::setCurrent(testDataDir + "/defined-qobject-macro");
+    QCOMPARE(runQbs(), 0);
+    QVERIFY2(!m_qbsStdout.contains("moc main.cpp"), m_qbsStdout.constData());
+}
+
 void TestBlackboxQt::lrelease()
 {
     QDir::setCurrent(testDataDir + QLatin1String("/lrelease"));
@@ -197,6 +204,18 @@ void TestBlackboxQt::mocSameFileName()
     QCOMPARE(m_qbsStdout.count("compiling moc_someclass.cpp"), 2);
 }
 
+void TestBlackboxQt::mocSharesIncludeScan()
+{
+    QDir::setCurrent(testDataDir + "/moc-shares-include-scan");
+    QbsRunParameters params;
+    params.environment.insert("QT_LOGGING_RULES", "qbs.depscan.debug=true");
+    QCOMPARE(runQbs(params), 0);
+    const QByteArray output = m_qbsStdout + m_qbsStderr;
+    QCOMPARE(output.count("scanning \"object.h\""), 1);
+    QCOMPARE(output.count("scanning \"object.cpp\""), 1);
+    QCOMPARE(output.count("scanning \"main.cpp\""), 1);
+}
+
 void TestBlackboxQt::pkgconfig()
 {
     QDir::setCurrent(testDataDir + "/pkgconfig");
@@ -48,10 +48,12 @@ private slots:
     void createProject();
     void dbusAdaptors();
     void dbusInterfaces();
+    void definedQObjectMacro();
     void lrelease();
     void mixedBuildVariants();
     void mocFlags();
     void mocSameFileName();
+    void mocSharesIncludeScan();
     void pkgconfig();
     void pluginMetaData();
     void qmlDebugging();
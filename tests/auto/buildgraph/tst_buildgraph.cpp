@@ -41,6 +41,7 @@
 #include <buildgraph/artifact.h>
 #include <buildgraph/buildgraph.h>
 #include <buildgraph/cycledetector.h>
+#include <buildgraph/jobserver.h>
 #include <buildgraph/productbuilddata.h>
 #include <buildgraph/projectbuilddata.h>
 #include <language/language.h>
@@ -51,6 +52,13 @@
 
 #include <QtTest/qtest.h>
 
+#include <algorithm>
+
+#ifdef Q_OS_UNIX
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 using namespace qbs;
 using namespace qbs::Internal;
 
@@ -143,6 +151,65 @@ void TestBuildGraph::testCycle()
     QVERIFY(!cycleDetected(productWithNoCycle()));
 }
 
+// Plays the role of GNU make by handing out tokens via an inherited pipe.
+void TestBuildGraph::testJobServerClient()
+{
+#ifdef Q_OS_UNIX
+    int fds[2];
+    QVERIFY(::pipe(fds) == 0);
+    QVERIFY(::fcntl(fds[0], F_SETFL, O_NONBLOCK) == 0);
+    QCOMPARE(::write(fds[1], "ab", 2), ssize_t(2));
+    const QByteArray oldMakeFlags = qgetenv("MAKEFLAGS");
+    qputenv("MAKEFLAGS", "-j3 --jobserver-auth=" + QByteArray::number(fds[0]) + ','
+             + QByteArray::number(fds[1]));
+    std::unique_ptr<JobServerClient> client = JobServerClient::fromEnvironment();
+    qputenv("MAKEFLAGS", oldMakeFlags);
+    QVERIFY(client);
+    QVERIFY(client->tryAcquireToken());
+    QVERIFY(client->tryAcquireToken());
+    QVERIFY(!client->tryAcquireToken());
+    QCOMPARE(client->tokenCount(), 2);
+    client->releaseToken();
+    QCOMPARE(client->tokenCount(), 1);
+    QVERIFY(client->tryAcquireToken());
+    QVERIFY(!client->tryAcquireToken());
+
+    // Tokens still held are returned on destruction.
+    client.reset();
+    char tokens[3];
+    QCOMPARE(::read(fds[0], tokens, sizeof tokens), ssize_t(2));
+    std::sort(tokens, tokens + 2);
+    QCOMPARE(QByteArray(tokens, 2), QByteArray("ab"));
+    ::close(fds[0]);
+    ::close(fds[1]);
+#else
+    QSKIP("jobserver support is Unix-only");
+#endif
+}
+
+void TestBuildGraph::testJobServerFifo()
+{
+#ifdef Q_OS_UNIX
+    const std::unique_ptr<JobServer> server = JobServer::create(3);
+    QVERIFY(server);
+    QVERIFY(server->makeFlags().startsWith(QLatin1String("-j3 --jobserver-auth=fifo:")));
+    const std::unique_ptr<JobServerClient> client1 = JobServerClient::fromFifo(server->fifoPath());
+    const std::unique_ptr<JobServerClient> client2 = JobServerClient::fromFifo(server->fifoPath());
+    QVERIFY(client1);
+    QVERIFY(client2);
+    QVERIFY(client1->tryAcquireToken());
+    QVERIFY(client2->tryAcquireToken());
+    QVERIFY(!client1->tryAcquireToken());
+    QVERIFY(!client2->tryAcquireToken());
+    client1->releaseToken();
+    QVERIFY(client2->tryAcquireToken());
+    QCOMPARE(client1->tokenCount(), 0);
+    QCOMPARE(client2->tokenCount(), 2);
+#else
+    QSKIP("jobserver support is Unix-only");
+#endif
+}
+
 int main(int argc, char *argv[])
 {
     QCoreApplication app(argc, argv);
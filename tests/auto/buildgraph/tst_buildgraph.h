@@ -56,6 +56,8 @@ private slots:
     void initTestCase();
     void cleanupTestCase();
     void testCycle();
+    void testJobServerClient();
+    void testJobServerFifo();
 
 private:
     qbs::Internal::ResolvedProductConstPtr productWithDirectCycle();
@@ -43,28 +43,44 @@
 
 #include "../shared.h"
 
+#include <logging/ilogsink.h>
 #include <tools/buildoptions.h>
 #include <tools/error.h>
 #include <tools/fileinfo.h>
 #include <tools/filesaver.h>
 #include <tools/hostosinfo.h>
+#include <tools/launcherinterface.h>
+#include <tools/persistence.h>
 #include <tools/processutils.h>
 #include <tools/profile.h>
+#include <tools/qbsprocess.h>
 #include <tools/set.h>
 #include <tools/settings.h>
 #include <tools/setupprojectparameters.h>
 #include <tools/stringutils.h>
+#include <tools/systemload.h>
 #include <tools/version.h>
 
 #include <QtCore/qdir.h>
+#include <QtCore/qelapsedtimer.h>
+#include <QtCore/qeventloop.h>
 #include <QtCore/qfile.h>
 #include <QtCore/qfileinfo.h>
 #include <QtCore/qsettings.h>
+#include <QtCore/qstandardpaths.h>
 #include <QtCore/qtemporarydir.h>
 #include <QtCore/qtemporaryfile.h>
+#include <QtCore/qthread.h>
+#include <QtCore/qtimer.h>
 
 #include <QtTest/qtest.h>
 
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <memory>
+#include <vector>
+
 using namespace qbs;
 using namespace qbs::Internal;
 
@@ -418,11 +434,311 @@ void TestTools::testBuildConfigMerging()
     QCOMPARE(finalCppMap.value(QLatin1String("treatWarningsAsErrors")).toBool(), true);
 }
 
+void TestTools::testPersistentPoolBackgroundWrite()
+{
+    class WarningCollector : public ILogSink
+    {
+    public:
+        QList<ErrorInfo> warnings;
+
+    private:
+        void doPrintWarning(const ErrorInfo &warning) override { warnings.push_back(warning); }
+        void doPrintMessage(LoggerLevel, const QString &, const QString &) override { }
+    };
+
+    WarningCollector logSink;
+    Logger logger(&logSink);
+    const QString dirPath = testDataDir + "/background-write";
+    const QString filePath = dirPath + "/test.bg";
+    PersistentPool::HeadData headData;
+    headData.projectConfig.insert("key", "value");
+
+    // Loading the file waits for the write to finish.
+    {
+        PersistentPool pool(logger);
+        pool.setHeadData(headData);
+        pool.setupWriteStream(filePath, PersistentPool::WriteInBackground);
+        pool.store(QString("payload"));
+        pool.finalizeWriteStream();
+    }
+    {
+        PersistentPool pool(logger);
+        pool.load(filePath);
+        QCOMPARE(pool.headData().projectConfig, headData.projectConfig);
+        QString payload;
+        pool.load(payload);
+        QCOMPARE(payload, QString("payload"));
+    }
+    QVERIFY(logSink.warnings.empty());
+
+    // A failed write is reported by the next access to the file.
+    {
+        PersistentPool pool(logger);
+        pool.setHeadData(headData);
+        pool.setupWriteStream(filePath, PersistentPool::WriteInBackground);
+        QVERIFY(QDir(dirPath).removeRecursively()); // The writer thread opens the file.
+        pool.store(QString("lost payload"));
+        pool.finalizeWriteStream();
+    }
+    {
+        PersistentPool pool(logger);
+        pool.setupWriteStream(filePath);
+    }
+    QCOMPARE(logSink.warnings.size(), 1);
+    QVERIFY2(logSink.warnings.front().toString().contains("Failure storing build graph"),
+             qPrintable(logSink.warnings.front().toString()));
+    QVERIFY(!PersistentPool::waitForBackgroundWrite(filePath).hasError());
+    QVERIFY(!QFileInfo::exists(filePath));
+}
+
+void TestTools::testPersistentPoolCompression()
+{
+    Logger logger;
+    const QString filePath = testDataDir + "/compression/test.bg";
+    PersistentPool::HeadData headData;
+    headData.projectConfig.insert("key", "value");
+
+    // Several compression chunks, with a string crossing their boundaries.
+    QStringList payload;
+    for (int i = 0; i < 100000; ++i)
+        payload << QString("/home/user/project/src/file%1.cpp").arg(i);
+    {
+        PersistentPool pool(logger);
+        pool.setHeadData(headData);
+        pool.setupWriteStream(filePath, PersistentPool::Compress);
+        pool.store(payload);
+        pool.finalizeWriteStream();
+        QVERIFY(pool.uncompressedSize() > 2 * (1 << 20));
+        QVERIFY(pool.storedSize() < pool.uncompressedSize() / 2);
+        QCOMPARE(pool.storedSize(), QFileInfo(filePath).size());
+    }
+    {
+        PersistentPool pool(logger);
+        pool.load(filePath);
+        QCOMPARE(pool.headData().projectConfig, headData.projectConfig);
+        QStringList loadedPayload;
+        pool.load(loadedPayload);
+        QCOMPARE(loadedPayload, payload);
+    }
+}
+
+// Compares loading a build graph-like file from a memory mapping with plain file reads.
+// Run with e.g. "-callgrind" or "-iterations 10" to get meaningful numbers.
+void TestTools::testPersistentPoolLoadBenchmark()
+{
+    QFETCH(bool, useMapping);
+    const PersistentPool::LoadOptions loadOptions = useMapping
+            ? PersistentPool::NoLoadOptions : PersistentPool::NoMemoryMapping;
+
+    class DiscardingLogSink : public ILogSink
+    {
+        void doPrintMessage(LoggerLevel, const QString &, const QString &) override { }
+    } logSink;
+    Logger logger(&logSink);
+    const QString filePath = testDataDir + "/load-benchmark/test.bg";
+
+    // Mimics the structure of real build graphs: Lots of file paths, many of them
+    // repeated, and small property maps.
+    std::vector<QVariantMap> nodes;
+    for (int i = 0; i < 50000; ++i) {
+        QVariantMap node;
+        node.insert("filePath", QString("/home/user/project/src/module%1/file%2.cpp")
+                    .arg(i % 100).arg(i));
+        node.insert("includePaths", QStringList({"/usr/include", "/home/user/project/include",
+                                                 QString("/home/user/project/src/module%1")
+                                                 .arg(i % 100)}));
+        node.insert("timestamp", qint64(i) * 1000);
+        node.insert("generated", i % 3 == 0);
+        nodes.push_back(node);
+    }
+    {
+        PersistentPool pool(logger);
+        pool.setupWriteStream(filePath);
+        pool.store(nodes);
+        pool.finalizeWriteStream();
+    }
+
+    std::vector<QVariantMap> loadedNodes;
+    QBENCHMARK {
+        PersistentPool pool(logger);
+        pool.load(filePath, loadOptions);
+        pool.load(loadedNodes);
+    }
+    QCOMPARE(loadedNodes, nodes);
+}
+
+void TestTools::testPersistentPoolLoadBenchmark_data()
+{
+    QTest::addColumn<bool>("useMapping");
+    QTest::newRow("memory mapping") << true;
+    QTest::newRow("file reads") << false;
+}
+
 void TestTools::testProcessNameByPid()
 {
     QCOMPARE(qAppName(), processNameByPid(QCoreApplication::applicationPid()));
 }
 
+struct SingleProcessResult
+{
+    bool finished = false;
+    int exitCode = 0;
+    QProcess::ProcessError error = QProcess::UnknownError;
+    QString errorString;
+    QByteArray stdOut;
+};
+
+// Runs one process via QbsProcess and waits until it has finished or failed to start.
+static SingleProcessResult runSingleProcess(const QString &program, const QStringList &arguments)
+{
+    SingleProcessResult result;
+    QEventLoop loop;
+    LauncherInterface::startLauncher();
+    {
+        QbsProcess process;
+        QObject::connect(&process, static_cast<void (QbsProcess::*)(QProcess::ProcessError)>(
+                             &QbsProcess::error), &loop, [&process, &loop] {
+            if (process.error() == QProcess::FailedToStart)
+                loop.quit();
+        });
+        QObject::connect(&process, &QbsProcess::finished, &loop, [&result, &loop] {
+            result.finished = true;
+            loop.quit();
+        });
+        QTimer::singleShot(30000, &loop, &QEventLoop::quit);
+        process.start(program, arguments);
+        loop.exec();
+        result.exitCode = process.exitCode();
+        result.error = process.error();
+        result.errorString = process.errorString();
+        result.stdOut = process.readAllStandardOutput();
+    }
+    LauncherInterface::stopLauncher();
+    return result;
+}
+
+// The process launcher has its own vfork()/execve() based implementation on Linux.
+void TestTools::testProcessLauncherCrashingChild()
+{
+    if (!HostOsInfo::isLinuxHost())
+        QSKIP("This test is specific to the Linux process implementation");
+    const SingleProcessResult result = runSingleProcess(
+                QLatin1String("sh"), QStringList{"-c", "echo before crash; kill -SEGV $$"});
+    QVERIFY(result.finished);
+    QCOMPARE(result.exitCode, int(SIGSEGV));
+    QCOMPARE(result.errorString, QString("Process crashed"));
+    QCOMPARE(result.stdOut, QByteArray("before crash\n"));
+}
+
+void TestTools::testProcessLauncherExecFailure()
+{
+    if (!HostOsInfo::isLinuxHost())
+        QSKIP("This test is specific to the Linux process implementation");
+
+    // execve() fails in the child, which must be reported with the reason.
+    SingleProcessResult result = runSingleProcess(
+                QLatin1String("/nonexistent-dir/nonexistent-program"), QStringList());
+    QVERIFY(!result.finished);
+    QCOMPARE(result.error, QProcess::FailedToStart);
+    QVERIFY2(result.errorString.contains(qt_error_string(ENOENT)),
+             qPrintable(result.errorString));
+
+    QTemporaryFile nonExecutableFile;
+    QVERIFY(nonExecutableFile.open());
+    result = runSingleProcess(nonExecutableFile.fileName(), QStringList());
+    QVERIFY(!result.finished);
+    QCOMPARE(result.error, QProcess::FailedToStart);
+    QVERIFY2(result.errorString.contains(qt_error_string(EACCES)),
+             qPrintable(result.errorString));
+}
+
+struct TrivialProcessesResult
+{
+    int finishedCount = 0;
+    qint64 elapsedTime = 0;
+    QString errorString;
+};
+
+// Runs spawnCount instances of a do-nothing program via QbsProcess, jobCount at a time.
+static TrivialProcessesResult runTrivialProcesses(const QString &program, int launcherCount,
+                                                  int jobCount, int spawnCount)
+{
+    TrivialProcessesResult result;
+    int startedCount = 0;
+    QEventLoop loop;
+    LauncherInterface::startLauncher(launcherCount);
+    std::vector<std::unique_ptr<QbsProcess>> processes;
+    for (int i = 0; i < jobCount; ++i) {
+        processes.push_back(std::make_unique<QbsProcess>());
+        QbsProcess * const process = processes.back().get();
+        QObject::connect(process, static_cast<void (QbsProcess::*)(QProcess::ProcessError)>(
+                             &QbsProcess::error), &loop, [process, &result, &loop] {
+            result.errorString = process->errorString();
+            loop.quit();
+        });
+        QObject::connect(process, &QbsProcess::finished, &loop, [&, process](int exitCode) {
+            if (exitCode != 0) {
+                result.errorString = QLatin1String("Unexpected exit code");
+                loop.quit();
+            } else if (++result.finishedCount == spawnCount) {
+                loop.quit();
+            } else if (startedCount < spawnCount) {
+                ++startedCount;
+                process->start(program, QStringList());
+            }
+        });
+    }
+    QTimer::singleShot(120000, &loop, &QEventLoop::quit);
+
+    QElapsedTimer timer;
+    timer.start();
+    for (const auto &process : processes) {
+        if (startedCount == spawnCount)
+            break;
+        ++startedCount;
+        process->start(program, QStringList());
+    }
+    loop.exec();
+    result.elapsedTime = std::max<qint64>(1, timer.elapsed());
+    processes.clear();
+    LauncherInterface::stopLauncher();
+    return result;
+}
+
+static QString trivialProgram()
+{
+    if (HostOsInfo::isWindowsHost())
+        return QString();
+    return QStandardPaths::findExecutable(QLatin1String("true"));
+}
+
+void TestTools::testProcessLauncherPool()
+{
+    const QString program = trivialProgram();
+    if (program.isEmpty())
+        QSKIP("No suitable trivial program on this platform");
+    const int spawnCount = 2000;
+    const int jobCount = 200;
+    const TrivialProcessesResult result = runTrivialProcesses(program, 4, jobCount, spawnCount);
+    QVERIFY2(result.errorString.isEmpty(), qPrintable(result.errorString));
+    QCOMPARE(result.finishedCount, spawnCount);
+}
+
+// Not so much a test as a benchmark for the process launcher: Reports how many trivial
+// processes per second we can run via QbsProcess with as many concurrent jobs as there are cores.
+void TestTools::testProcessSpawnRate()
+{
+    const QString program = trivialProgram();
+    if (program.isEmpty())
+        QSKIP("No suitable trivial program on this platform");
+    const int spawnCount = 2000;
+    const int jobCount = std::max(1, QThread::idealThreadCount());
+    const TrivialProcessesResult result = runTrivialProcesses(program, 1, jobCount, spawnCount);
+    QVERIFY2(result.errorString.isEmpty(), qPrintable(result.errorString));
+    QCOMPARE(result.finishedCount, spawnCount);
+    qDebug("%d processes with %d concurrent jobs took %lld ms (%lld spawns per second)",
+           spawnCount, jobCount, result.elapsedTime, spawnCount * 1000LL / result.elapsedTime);
+}
 
 int toNumber(const QString &str)
 {
@@ -432,6 +748,26 @@ int toNumber(const QString &str)
     return res;
 }
 
+void TestTools::testSystemLoad()
+{
+    QCOMPARE(SystemLoad::parseLoadAverage("1.25 0.80 0.50 3/812 12345\n"), 1.25);
+    QCOMPARE(SystemLoad::parseLoadAverage(""), -1.0);
+    QCOMPARE(SystemLoad::parseLoadAverage("garbage 0.80"), -1.0);
+
+    const QByteArray memInfo = "MemTotal:       16318480 kB\n"
+                               "MemFree:          503112 kB\n"
+                               "MemAvailable:    8157240 kB\n"
+                               "Buffers:          381204 kB\n";
+    QCOMPARE(SystemLoad::parseAvailableMemory(memInfo), Q_INT64_C(8157240) * 1024);
+    QCOMPARE(SystemLoad::parseAvailableMemory("MemTotal:       16318480 kB\n"), Q_INT64_C(-1));
+
+    const SystemLoad load = SystemLoad::current();
+    if (HostOsInfo::isLinuxHost()) {
+        QVERIFY(load.loadAverage() >= 0);
+        QVERIFY(load.availableMemory() > 0);
+    }
+}
+
 void TestTools::set_operator_eq()
 {
     {
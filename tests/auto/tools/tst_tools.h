@@ -65,10 +65,19 @@ private slots:
     void fileCaseCheck();
     void testBuildConfigMerging();
     void testFileInfo();
+    void testPersistentPoolBackgroundWrite();
+    void testPersistentPoolCompression();
+    void testPersistentPoolLoadBenchmark();
+    void testPersistentPoolLoadBenchmark_data();
+    void testProcessLauncherCrashingChild();
+    void testProcessLauncherExecFailure();
+    void testProcessLauncherPool();
     void testProcessNameByPid();
+    void testProcessSpawnRate();
     void testProfiles();
     void testSettingsMigration();
     void testSettingsMigration_data();
+    void testSystemLoad();
 
     void set_operator_eq();
     void set_swap();